@@ -0,0 +1,367 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vlan_hal.h"
+#include "vlan_hal_bench.h"
+
+/*
+ * Per-call latency of the public HAL API, for qualifying a vendor library
+ * as much as the skeleton. Groups, interfaces and VLAN IDs come from the
+ * br_Name, if_Name and vlanID lists of the profile snapshot given with -p,
+ * otherwise from the defaults of profiles/include/vlan_profile.yaml; group
+ * i uses VLAN ID i. Each call is timed on its own after a warm-up round,
+ * and any untimed setup it needs (adding the group a delGroup removes, for
+ * example) runs outside the timed region.
+ *
+ * With -s the whole run repeats for each N given, over the first N groups
+ * of a profile from tools/vlan_profile_generate, and ends with the p50 of
+ * every call against N.
+ */
+
+#define BENCH_API_MAX_INPUTS 4096
+#define BENCH_API_NAME_SIZE 64
+#define BENCH_API_WARMUP 100u
+
+static const char *gDefaultGroups[] = { "brlan0", "brlan1", "brlan112", "brlan113" };
+static const char *gDefaultInterfaces[] = { "wl1.1", "wl0.2", "wl0.7", "wl2.7" };
+static const char *gDefaultVlanIDs[] = { "1", "10", "2052", "4094" };
+
+/* Writable copies, the _is_this_* checks take char * */
+static char (*gGroups)[BENCH_API_NAME_SIZE];
+static char (*gInterfaces)[BENCH_API_NAME_SIZE];
+static char (*gVlanIDs)[BENCH_API_NAME_SIZE];
+static unsigned int gGroupCount;
+static unsigned int gInterfaceCount;
+
+typedef int (*bench_api_fn)(unsigned int i);
+
+typedef struct
+{
+  const char *variant;
+  bench_api_fn setup;           /*!< Untimed, before the call, may be NULL */
+  bench_api_fn call;            /*!< Timed, RETURN_OK expected */
+  bench_api_fn teardown;        /*!< Untimed, after the call, may be NULL */
+  int mutating;                 /*!< Runs 1/100 of the iterations, like the other HAL benchmarks */
+} bench_api_case_t;
+
+/* Copies profile list @key, or @defaults when there is no profile, into @out */
+static unsigned int bench_api_load(const char *key, const char **defaults, unsigned int defaultCount,
+                                   char (*out)[BENCH_API_NAME_SIZE])
+{
+  const char *values[BENCH_API_MAX_INPUTS];
+  int count = vlan_hal_bench_profile_list(key, values, BENCH_API_MAX_INPUTS);
+  unsigned int i;
+
+  if (count < 0)
+  {
+    memcpy(values, defaults, defaultCount * sizeof(values[0]));
+    count = (int)defaultCount;
+  }
+  if (count > BENCH_API_MAX_INPUTS)
+  {
+    count = BENCH_API_MAX_INPUTS;
+  }
+  for (i = 0; i < (unsigned int)count; i++)
+  {
+    snprintf(out[i], BENCH_API_NAME_SIZE, "%s", values[i]);
+  }
+  return (unsigned int)count;
+}
+
+static char *group(unsigned int i)
+{
+  return gGroups[i % gGroupCount];
+}
+
+static char *vlanID(unsigned int i)
+{
+  return gVlanIDs[i % gGroupCount];
+}
+
+/* Interface i sits in group i, the VLAN keeps ports unique when interfaces are fewer than groups */
+static char *interface(unsigned int i)
+{
+  return gInterfaces[(i % gGroupCount) % gInterfaceCount];
+}
+
+static int add_group(unsigned int i)
+{
+  return vlan_hal_addGroup(group(i), vlanID(i));
+}
+
+static int del_group(unsigned int i)
+{
+  return vlan_hal_delGroup(group(i));
+}
+
+static int add_interface(unsigned int i)
+{
+  return vlan_hal_addInterface(group(i), interface(i), vlanID(i));
+}
+
+static int del_interface(unsigned int i)
+{
+  return vlan_hal_delInterface(group(i), interface(i), vlanID(i));
+}
+
+static int delete_all_interfaces(unsigned int i)
+{
+  return vlan_hal_delete_all_Interfaces(group(i));
+}
+
+static int get_vlan_id(unsigned int i)
+{
+  char value[BENCH_API_NAME_SIZE];
+
+  return get_vlanId_for_GroupName(group(i), value);
+}
+
+static int group_available(unsigned int i)
+{
+  return _is_this_group_available_in_linux_bridge(group(i));
+}
+
+static int interface_available(unsigned int i)
+{
+  return _is_this_interface_available_in_linux_bridge(interface(i), vlanID(i));
+}
+
+static int interface_available_in_group(unsigned int i)
+{
+  return _is_this_interface_available_in_given_linux_bridge(interface(i), group(i), vlanID(i));
+}
+
+/* Takes group i and its interface out of the population */
+static int remove_group(unsigned int i)
+{
+  return ((delete_all_interfaces(i) == RETURN_OK) && (del_group(i) == RETURN_OK)) ? RETURN_OK : RETURN_ERR;
+}
+
+/* Puts group i and its interface back */
+static int restore_group(unsigned int i)
+{
+  return ((add_group(i) == RETURN_OK) && (add_interface(i) == RETURN_OK)) ? RETURN_OK : RETURN_ERR;
+}
+
+/*
+ * Every case starts and ends with the whole population in place, each
+ * group with its interface, so a call is always timed against all of it.
+ */
+static const bench_api_case_t gCases[] =
+{
+  { "vlan_hal_addGroup", remove_group, add_group, add_interface, 1 },
+  { "vlan_hal_delGroup", delete_all_interfaces, del_group, restore_group, 1 },
+  { "vlan_hal_addInterface", del_interface, add_interface, NULL, 1 },
+  { "vlan_hal_delInterface", NULL, del_interface, add_interface, 1 },
+  { "vlan_hal_delete_all_Interfaces", NULL, delete_all_interfaces, add_interface, 1 },
+  { "get_vlanId_for_GroupName", NULL, get_vlan_id, NULL, 0 },
+  { "_is_this_group_available_in_linux_bridge", NULL, group_available, NULL, 0 },
+  { "_is_this_interface_available_in_linux_bridge", NULL, interface_available, NULL, 0 },
+  { "_is_this_interface_available_in_given_linux_bridge", NULL, interface_available_in_group, NULL, 0 },
+};
+
+#define BENCH_API_CASES (sizeof(gCases) / sizeof(gCases[0]))
+
+/* Times every case, storing each p50 in @p50 */
+static int bench_api_measure(uint64_t *samples, unsigned int iterations, uint64_t *p50)
+{
+  unsigned int errors;
+  unsigned int rounds;
+  unsigned int c;
+  unsigned int i;
+  uint64_t start;
+  int ret;
+
+  for (c = 0; c < BENCH_API_CASES; c++)
+  {
+    rounds = gCases[c].mutating ? iterations / 100 : iterations;
+    if (rounds == 0)
+    {
+      rounds = 1;
+    }
+    for (i = 0; i < BENCH_API_WARMUP; i++)
+    {
+      if (gCases[c].setup != NULL)
+      {
+        gCases[c].setup(i);
+      }
+      gCases[c].call(i);
+      if (gCases[c].teardown != NULL)
+      {
+        gCases[c].teardown(i);
+      }
+    }
+    errors = 0;
+    for (i = 0; i < rounds; i++)
+    {
+      if (gCases[c].setup != NULL)
+      {
+        gCases[c].setup(i);
+      }
+      start = vlan_hal_bench_now_ns();
+      ret = gCases[c].call(i);
+      samples[i] = vlan_hal_bench_now_ns() - start;
+      if (ret != RETURN_OK)
+      {
+        errors++;
+      }
+      if (gCases[c].teardown != NULL)
+      {
+        gCases[c].teardown(i);
+      }
+    }
+    p50[c] = vlan_hal_bench_report_latency("api", gCases[c].variant, samples, rounds, errors);
+    if (errors > 0)
+    {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/* Applies @fn to every group, stopping at the first failure */
+static int bench_api_each_group(bench_api_fn fn)
+{
+  unsigned int i;
+
+  for (i = 0; i < gGroupCount; i++)
+  {
+    if (fn(i) != RETURN_OK)
+    {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/* Populates the first @groups groups, times every case against them and removes them again */
+static int bench_api_run_scale(unsigned int groups, uint64_t *samples, unsigned int iterations, uint64_t *p50)
+{
+  int ret = -1;
+
+  gGroupCount = groups;
+  if ((bench_api_each_group(add_group) == 0) && (bench_api_each_group(add_interface) == 0) &&
+      (bench_api_measure(samples, iterations, p50) == 0))
+  {
+    ret = 0;
+  }
+  /* Leave the system as found, whichever step failed */
+  bench_api_each_group(delete_all_interfaces);
+  bench_api_each_group(del_group);
+  return ret;
+}
+
+/*
+ * Prints how the p50 of each call moved from the smallest to the largest
+ * scale. A per-call cost growing at least like the square root of N makes
+ * N calls clearly superlinear, which is flagged.
+ */
+static void bench_api_print_curve(const unsigned int *scales, unsigned int count, const uint64_t *p50)
+{
+  double growth;
+  double scaleGrowth = (double)scales[count - 1] / scales[0];
+  unsigned int c;
+  unsigned int s;
+
+  for (c = 0; c < BENCH_API_CASES; c++)
+  {
+    printf("%-16s %-50s p50", "api curve", gCases[c].variant);
+    for (s = 0; s < count; s++)
+    {
+      printf(" %u:%llu", scales[s], (unsigned long long)p50[(s * BENCH_API_CASES) + c]);
+    }
+    growth = (p50[c] > 0) ? (double)p50[((count - 1) * BENCH_API_CASES) + c] / p50[c] : 0.0;
+    printf("  x%.1f for N x%.1f%s\n", growth, scaleGrowth,
+           ((growth >= 2.0) && (growth * growth >= scaleGrowth)) ? "  GROWS WITH N" : "");
+  }
+}
+
+static int bench_api_run(unsigned int iterations)
+{
+  const unsigned int *scales;
+  unsigned int available;
+  unsigned int scaleCount;
+  unsigned int vlanCount;
+  unsigned int s;
+  uint64_t *samples;
+  uint64_t *p50;
+  int ret = -1;
+
+  scaleCount = vlan_hal_bench_scales(&scales);
+  gGroups = malloc(3 * BENCH_API_MAX_INPUTS * BENCH_API_NAME_SIZE);
+  samples = malloc(((iterations > 0) ? iterations : 1) * sizeof(uint64_t));
+  p50 = calloc(((scaleCount > 0) ? scaleCount : 1) * BENCH_API_CASES, sizeof(uint64_t));
+  if ((gGroups == NULL) || (samples == NULL) || (p50 == NULL))
+  {
+    goto cleanup;
+  }
+  gInterfaces = gGroups + BENCH_API_MAX_INPUTS;
+  gVlanIDs = gInterfaces + BENCH_API_MAX_INPUTS;
+  available = bench_api_load("vlan/config/br_Name", gDefaultGroups, 4, gGroups);
+  gInterfaceCount = bench_api_load("vlan/config/if_Name", gDefaultInterfaces, 4, gInterfaces);
+  vlanCount = bench_api_load("vlan/config/vlanID", gDefaultVlanIDs, 4, gVlanIDs);
+  if (vlanCount < available)
+  {
+    available = vlanCount;
+  }
+  if ((available == 0) || (gInterfaceCount == 0))
+  {
+    goto cleanup;
+  }
+
+  if (scaleCount == 0)
+  {
+    ret = bench_api_run_scale(available, samples, iterations, p50);
+    goto cleanup;
+  }
+  for (s = 0; s < scaleCount; s++)
+  {
+    if (scales[s] > available)
+    {
+      printf("%-16s N=%u needs a profile with that many groups and VLAN IDs, %u available\n", "api", scales[s], available);
+      goto cleanup;
+    }
+  }
+  for (s = 0; s < scaleCount; s++)
+  {
+    vlan_hal_bench_set_scale(scales[s]);
+    if (bench_api_run_scale(scales[s], samples, iterations, &p50[s * BENCH_API_CASES]) != 0)
+    {
+      goto cleanup;
+    }
+  }
+  bench_api_print_curve(scales, scaleCount, p50);
+  ret = 0;
+
+cleanup:
+  vlan_hal_bench_set_scale(0);
+  free(p50);
+  free(samples);
+  free(gGroups);
+  gGroups = NULL;
+  return ret;
+}
+
+const vlan_hal_bench_t vlan_hal_bench_api =
+{
+  "api",
+  "p50/p90/p99/max latency of each public HAL call, inputs from -p, sweep with -s",
+  bench_api_run
+};
@@ -0,0 +1,158 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "vlan_hal_backend.h"
+#include "vlan_hal_bench.h"
+
+/*
+ * Group add/delete pairs against a stub backend that takes a fixed time per
+ * bridge operation: synchronous calls versus submitting every request to
+ * the serial offload queue at once and waiting for the completions. The
+ * queue runs them one at a time, so the async figure shows the cost of
+ * offloading, not a speed-up.
+ */
+
+/* Each request costs the stub's latency, so run one per this many iterations */
+#define BENCH_ASYNC_SCALE 100
+#define BENCH_ASYNC_GROUPS 256
+#define BENCH_ASYNC_BACKEND_NS 20000u
+
+typedef struct
+{
+  uint64_t submitNs;
+  uint64_t latencyNs;
+} bench_async_request_t;
+
+/* Stands in for a kernel round trip, spinning so the delay is exact */
+static int bench_async_bridge(const char *brName)
+{
+  uint64_t until = vlan_hal_bench_now_ns() + BENCH_ASYNC_BACKEND_NS;
+
+  (void)brName;
+  while (vlan_hal_bench_now_ns() < until)
+  {
+  }
+  return 0;
+}
+
+static void bench_async_done(void *ctx, int result)
+{
+  bench_async_request_t *request = ctx;
+
+  (void)result;
+  request->latencyNs = vlan_hal_bench_now_ns() - request->submitNs;
+}
+
+static int bench_async_compare(const void *a, const void *b)
+{
+  uint64_t left = ((const bench_async_request_t *)a)->latencyNs;
+  uint64_t right = ((const bench_async_request_t *)b)->latencyNs;
+
+  return (left > right) - (left < right);
+}
+
+static int bench_async_run(unsigned int iterations)
+{
+  vlan_hal_backend_t backend = vlan_hal_backend_none;
+  bench_async_request_t *requests;
+  char names[BENCH_ASYNC_GROUPS][IFNAMSIZ];
+  char vlanIDs[BENCH_ASYNC_GROUPS][5];
+  unsigned int pairs = (iterations + BENCH_ASYNC_SCALE - 1) / BENCH_ASYNC_SCALE;
+  uint64_t submitted;
+  uint64_t start;
+  uint64_t total = 0;
+  unsigned int i;
+  int ret = -1;
+
+  requests = calloc(2 * (size_t)pairs, sizeof(bench_async_request_t));
+  if (requests == NULL)
+  {
+    return -1;
+  }
+  for (i = 0; i < BENCH_ASYNC_GROUPS; i++)
+  {
+    snprintf(names[i], IFNAMSIZ, "brasync%u", i);
+    snprintf(vlanIDs[i], sizeof(vlanIDs[i]), "%u", 1000 + i);
+  }
+  backend.name = "bench";
+  backend.add_bridge = bench_async_bridge;
+  backend.del_bridge = bench_async_bridge;
+  vlan_hal_backend_set(&backend);
+  if (vlan_hal_async_start() != RETURN_OK)
+  {
+    goto cleanup;
+  }
+
+  start = vlan_hal_bench_now_ns();
+  for (i = 0; i < pairs; i++)
+  {
+    if ((vlan_hal_addGroup(names[i % BENCH_ASYNC_GROUPS], vlanIDs[i % BENCH_ASYNC_GROUPS]) != RETURN_OK) ||
+        (vlan_hal_delGroup(names[i % BENCH_ASYNC_GROUPS]) != RETURN_OK))
+    {
+      goto cleanup;
+    }
+  }
+  vlan_hal_bench_report("async", "sync", 2 * pairs, vlan_hal_bench_now_ns() - start);
+
+  /* Every request is in flight before the first one is waited for */
+  start = vlan_hal_bench_now_ns();
+  for (i = 0; i < pairs; i++)
+  {
+    requests[2 * i].submitNs = vlan_hal_bench_now_ns();
+    requests[2 * i + 1].submitNs = requests[2 * i].submitNs;
+    if ((vlan_hal_addGroup_async(names[i % BENCH_ASYNC_GROUPS], vlanIDs[i % BENCH_ASYNC_GROUPS],
+                                 bench_async_done, &requests[2 * i]) != RETURN_OK) ||
+        (vlan_hal_delGroup_async(names[i % BENCH_ASYNC_GROUPS], bench_async_done, &requests[2 * i + 1]) != RETURN_OK))
+    {
+      vlan_hal_async_drain();
+      goto cleanup;
+    }
+  }
+  submitted = vlan_hal_bench_now_ns();
+  vlan_hal_async_drain();
+  vlan_hal_bench_report("async", "submit", 2 * pairs, submitted - start);
+  vlan_hal_bench_report("async", "throughput", 2 * pairs, vlan_hal_bench_now_ns() - start);
+
+  for (i = 0; i < 2 * pairs; i++)
+  {
+    total += requests[i].latencyNs;
+  }
+  qsort(requests, 2 * (size_t)pairs, sizeof(bench_async_request_t), bench_async_compare);
+  vlan_hal_bench_report("async", "latency mean", 2 * pairs, total);
+  printf("%-16s %-32s p50 %llu ns, p99 %llu ns, max %llu ns\n", "async", "latency",
+         (unsigned long long)requests[pairs].latencyNs,
+         (unsigned long long)requests[(2 * (size_t)pairs * 99) / 100].latencyNs,
+         (unsigned long long)requests[2 * pairs - 1].latencyNs);
+  ret = 0;
+
+cleanup:
+  vlan_hal_async_stop();
+  vlan_hal_backend_set(NULL);
+  free(requests);
+  return ret;
+}
+
+const vlan_hal_bench_t vlan_hal_bench_async =
+{
+  "async",
+  "synchronous calls versus the serial async offload queue, with a 20 us stub backend",
+  bench_async_run
+};
@@ -0,0 +1,421 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "vlan_hal.h"
+#include "vlan_hal_bench.h"
+
+/*
+ * Interface churn from several threads at once, the way the Wi-Fi and WAN
+ * managers drive the HAL. Writers own disjoint sets of interfaces and
+ * attach each to a random group or detach it again, keeping a model of
+ * where every interface should be. Readers query group VLAN IDs, which
+ * never change during the run and so must always be right, and interface
+ * membership, which they cannot predict. Once the time is up the HAL's
+ * view of every interface in every group is checked against the model.
+ *
+ * Groups and VLAN IDs come from the profile given with -p, otherwise from
+ * the reference profile defaults. Interfaces come from its if_Name list,
+ * dealt round-robin to the writers, or are named wl<writer>.<n>.
+ */
+
+#define BENCH_CHURN_NAME_SIZE 64
+#define BENCH_CHURN_MAX_INPUTS 4096
+#define BENCH_CHURN_DEFAULT_PORTS 8
+#define BENCH_CHURN_SAMPLES 65536      /* Per thread and operation, the most recent ones are kept */
+
+static const char *gDefaultGroups[] = { "brlan0", "brlan1", "brlan112", "brlan113" };
+static const char *gDefaultVlanIDs[] = { "1", "10", "2052", "4094" };
+
+typedef struct
+{
+  char ifName[BENCH_CHURN_NAME_SIZE];
+  int group;                    /*!< Model: group it is attached to, -1 when detached */
+} churn_port_t;
+
+typedef struct
+{
+  uint64_t *ns;
+  unsigned int count;           /*!< Operations done, may exceed the ring */
+} churn_samples_t;
+
+typedef struct
+{
+  pthread_t thread;
+  uint64_t seed;
+  churn_port_t *ports;
+  unsigned int portCount;
+  churn_samples_t added;        /*!< Writers: addInterface, readers: every query */
+  churn_samples_t removed;      /*!< Writers: delInterface */
+  unsigned int errors;
+} churn_thread_t;
+
+static char (*gGroups)[BENCH_CHURN_NAME_SIZE];
+static char (*gVlanIDs)[BENCH_CHURN_NAME_SIZE];
+static unsigned int gGroupCount;
+static churn_thread_t *gWriters;
+static unsigned int gWriterCount;
+static int gStop;
+
+/* xorshift64, one state per thread */
+static uint64_t churn_random(uint64_t *state)
+{
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+static void churn_record(churn_samples_t *samples, uint64_t ns)
+{
+  samples->ns[samples->count % BENCH_CHURN_SAMPLES] = ns;
+  samples->count++;
+}
+
+static void *churn_writer(void *arg)
+{
+  churn_thread_t *self = arg;
+  churn_port_t *port;
+  uint64_t start;
+  unsigned int g;
+  int ret;
+
+  while ((self->portCount > 0) && !__atomic_load_n(&gStop, __ATOMIC_RELAXED))
+  {
+    port = &self->ports[churn_random(&self->seed) % self->portCount];
+    if (port->group < 0)
+    {
+      g = (unsigned int)(churn_random(&self->seed) % gGroupCount);
+      start = vlan_hal_bench_now_ns();
+      ret = vlan_hal_addInterface(gGroups[g], port->ifName, gVlanIDs[g]);
+      churn_record(&self->added, vlan_hal_bench_now_ns() - start);
+      if (ret == RETURN_OK)
+      {
+        port->group = (int)g;
+      }
+    }
+    else
+    {
+      g = (unsigned int)port->group;
+      start = vlan_hal_bench_now_ns();
+      ret = vlan_hal_delInterface(gGroups[g], port->ifName, gVlanIDs[g]);
+      churn_record(&self->removed, vlan_hal_bench_now_ns() - start);
+      if (ret == RETURN_OK)
+      {
+        port->group = -1;
+      }
+    }
+    if (ret != RETURN_OK)
+    {
+      self->errors++;
+    }
+  }
+  return NULL;
+}
+
+static void *churn_reader(void *arg)
+{
+  churn_thread_t *self = arg;
+  const churn_thread_t *writer;
+  char vlanID[BENCH_CHURN_NAME_SIZE];
+  uint64_t start;
+  uint64_t pick;
+  unsigned int g;
+  int ret;
+
+  while (!__atomic_load_n(&gStop, __ATOMIC_RELAXED))
+  {
+    pick = churn_random(&self->seed);
+    g = (unsigned int)(pick % gGroupCount);
+    start = vlan_hal_bench_now_ns();
+    switch ((pick >> 32) % 3)
+    {
+    case 0:
+      ret = get_vlanId_for_GroupName(gGroups[g], vlanID);
+      ret = ((ret == RETURN_OK) && (strcmp(vlanID, gVlanIDs[g]) == 0)) ? RETURN_OK : RETURN_ERR;
+      break;
+    case 1:
+      ret = _is_this_group_available_in_linux_bridge(gGroups[g]);
+      break;
+    default:
+      /* Membership races with the writers, any answer will do */
+      ret = RETURN_OK;
+      writer = (gWriterCount > 0) ? &gWriters[(pick >> 40) % gWriterCount] : NULL;
+      if ((writer != NULL) && (writer->portCount > 0))
+      {
+        _is_this_interface_available_in_linux_bridge((char *)writer->ports[(pick >> 48) % writer->portCount].ifName, gVlanIDs[g]);
+      }
+      break;
+    }
+    churn_record(&self->added, vlan_hal_bench_now_ns() - start);
+    if (ret != RETURN_OK)
+    {
+      self->errors++;
+    }
+  }
+  return NULL;
+}
+
+/* Copies the kept samples of @count threads, their removed rings if @removed, into @out */
+static unsigned int churn_collect(const churn_thread_t *threads, unsigned int count, int removed, uint64_t *out)
+{
+  const churn_samples_t *samples;
+  unsigned int total = 0;
+  unsigned int kept;
+  unsigned int t;
+
+  for (t = 0; t < count; t++)
+  {
+    samples = removed ? &threads[t].removed : &threads[t].added;
+    kept = (samples->count < BENCH_CHURN_SAMPLES) ? samples->count : BENCH_CHURN_SAMPLES;
+    memcpy(&out[total], samples->ns, kept * sizeof(uint64_t));
+    total += kept;
+  }
+  return total;
+}
+
+/* Prints throughput and latency of the writers, then the readers */
+static void churn_report(const churn_thread_t *threads, unsigned int readers, uint64_t elapsed, uint64_t *merged)
+{
+  unsigned int ops = 0;
+  unsigned int t;
+
+  for (t = 0; t < gWriterCount; t++)
+  {
+    ops += threads[t].added.count + threads[t].removed.count;
+  }
+  vlan_hal_bench_report("churn", "writer throughput", ops, elapsed);
+  vlan_hal_bench_report_latency("churn", "vlan_hal_addInterface", merged, churn_collect(threads, gWriterCount, 0, merged), 0);
+  vlan_hal_bench_report_latency("churn", "vlan_hal_delInterface", merged, churn_collect(threads, gWriterCount, 1, merged), 0);
+
+  ops = 0;
+  for (t = gWriterCount; t < gWriterCount + readers; t++)
+  {
+    ops += threads[t].added.count;
+  }
+  vlan_hal_bench_report("churn", "reader throughput", ops, elapsed);
+  vlan_hal_bench_report_latency("churn", "reader query", merged, churn_collect(&threads[gWriterCount], readers, 0, merged), 0);
+}
+
+/* Compares the HAL's membership of every writer interface in every group with the model */
+static unsigned int churn_check(void)
+{
+  unsigned int mismatches = 0;
+  unsigned int w;
+  unsigned int p;
+  unsigned int g;
+  churn_port_t *port;
+  int present;
+
+  for (w = 0; w < gWriterCount; w++)
+  {
+    for (p = 0; p < gWriters[w].portCount; p++)
+    {
+      port = &gWriters[w].ports[p];
+      for (g = 0; g < gGroupCount; g++)
+      {
+        present = (_is_this_interface_available_in_given_linux_bridge(port->ifName, gGroups[g], gVlanIDs[g]) == RETURN_OK);
+        if (present != (port->group == (int)g))
+        {
+          mismatches++;
+        }
+      }
+    }
+  }
+  return mismatches;
+}
+
+static int churn_load(const char *key, const char **defaults, unsigned int defaultCount, char (*out)[BENCH_CHURN_NAME_SIZE])
+{
+  const char *values[BENCH_CHURN_MAX_INPUTS];
+  int count = vlan_hal_bench_profile_list(key, values, BENCH_CHURN_MAX_INPUTS);
+  int i;
+
+  if ((count < 0) && (defaults != NULL))
+  {
+    memcpy(values, defaults, defaultCount * sizeof(values[0]));
+    count = (int)defaultCount;
+  }
+  if (count > BENCH_CHURN_MAX_INPUTS)
+  {
+    count = BENCH_CHURN_MAX_INPUTS;
+  }
+  for (i = 0; i < count; i++)
+  {
+    snprintf(out[i], BENCH_CHURN_NAME_SIZE, "%s", values[i]);
+  }
+  return count;
+}
+
+/* Deals the profile's interfaces to the writers, or names BENCH_CHURN_DEFAULT_PORTS per writer */
+static int churn_assign_ports(char (*interfaces)[BENCH_CHURN_NAME_SIZE], int interfaceCount)
+{
+  unsigned int perWriter;
+  unsigned int w;
+  unsigned int p;
+  int i;
+
+  for (w = 0; w < gWriterCount; w++)
+  {
+    perWriter = (interfaceCount > 0) ? ((unsigned int)interfaceCount + gWriterCount - 1 - w) / gWriterCount : BENCH_CHURN_DEFAULT_PORTS;
+    gWriters[w].ports = calloc((perWriter > 0) ? perWriter : 1, sizeof(churn_port_t));
+    if (gWriters[w].ports == NULL)
+    {
+      return -1;
+    }
+    for (p = 0; p < perWriter; p++)
+    {
+      gWriters[w].ports[p].group = -1;
+      if (interfaceCount > 0)
+      {
+        i = (int)((p * gWriterCount) + w);
+        snprintf(gWriters[w].ports[p].ifName, BENCH_CHURN_NAME_SIZE, "%s", interfaces[i]);
+      }
+      else
+      {
+        snprintf(gWriters[w].ports[p].ifName, BENCH_CHURN_NAME_SIZE, "wl%u.%u", w, p + 1);
+      }
+    }
+    gWriters[w].portCount = perWriter;
+  }
+  return 0;
+}
+
+static int bench_churn_run(unsigned int iterations)
+{
+  struct timespec pause;
+  churn_thread_t *threads;
+  char (*interfaces)[BENCH_CHURN_NAME_SIZE] = NULL;
+  unsigned int readers;
+  unsigned int count;
+  unsigned int started = 0;
+  unsigned int errors = 0;
+  unsigned int mismatches;
+  unsigned int t;
+  uint64_t *samples = NULL;
+  uint64_t elapsed;
+  uint64_t start;
+  int interfaceCount;
+  int ret = -1;
+
+  (void)iterations;
+  vlan_hal_bench_threads(&gWriterCount, &readers);
+  count = gWriterCount + readers;
+  threads = calloc(count, sizeof(churn_thread_t));
+  gGroups = malloc(3 * BENCH_CHURN_MAX_INPUTS * BENCH_CHURN_NAME_SIZE);
+  if ((threads == NULL) || (gGroups == NULL))
+  {
+    goto cleanup;
+  }
+  gVlanIDs = gGroups + BENCH_CHURN_MAX_INPUTS;
+  interfaces = gVlanIDs + BENCH_CHURN_MAX_INPUTS;
+  gWriters = threads;
+  gGroupCount = (unsigned int)churn_load("vlan/config/br_Name", gDefaultGroups, 4, gGroups);
+  t = (unsigned int)churn_load("vlan/config/vlanID", gDefaultVlanIDs, 4, gVlanIDs);
+  if (t < gGroupCount)
+  {
+    gGroupCount = t;
+  }
+  interfaceCount = churn_load("vlan/config/if_Name", NULL, 0, interfaces);
+  if ((gGroupCount == 0) || ((gWriterCount > 0) && (churn_assign_ports(interfaces, interfaceCount) != 0)))
+  {
+    goto cleanup;
+  }
+  /* Two rings per thread, then room to merge all threads' rings of one kind */
+  samples = malloc((size_t)count * 3 * BENCH_CHURN_SAMPLES * sizeof(uint64_t));
+  if (samples == NULL)
+  {
+    goto cleanup;
+  }
+  for (t = 0; t < count; t++)
+  {
+    threads[t].seed = 0x9e3779b97f4a7c15ull * (t + 1);
+    threads[t].added.ns = &samples[(size_t)t * 2 * BENCH_CHURN_SAMPLES];
+    threads[t].removed.ns = threads[t].added.ns + BENCH_CHURN_SAMPLES;
+  }
+  for (t = 0; t < gGroupCount; t++)
+  {
+    if (vlan_hal_addGroup(gGroups[t], gVlanIDs[t]) != RETURN_OK)
+    {
+      printf("%-16s cannot add group %s with VLAN %s\n", "churn", gGroups[t], gVlanIDs[t]);
+      goto teardown;
+    }
+  }
+
+  __atomic_store_n(&gStop, 0, __ATOMIC_RELAXED);
+  start = vlan_hal_bench_now_ns();
+  for (started = 0; started < count; started++)
+  {
+    if (pthread_create(&threads[started].thread, NULL, (started < gWriterCount) ? churn_writer : churn_reader,
+                       &threads[started]) != 0)
+    {
+      break;
+    }
+  }
+  pause.tv_sec = vlan_hal_bench_duration_ms() / 1000;
+  pause.tv_nsec = (long)(vlan_hal_bench_duration_ms() % 1000) * 1000000;
+  if (started == count)
+  {
+    nanosleep(&pause, NULL);
+  }
+  __atomic_store_n(&gStop, 1, __ATOMIC_RELAXED);
+  for (t = 0; t < started; t++)
+  {
+    pthread_join(threads[t].thread, NULL);
+    errors += threads[t].errors;
+  }
+  elapsed = vlan_hal_bench_now_ns() - start;
+  if (started != count)
+  {
+    goto teardown;
+  }
+
+  churn_report(threads, readers, elapsed, &samples[(size_t)count * 2 * BENCH_CHURN_SAMPLES]);
+  mismatches = churn_check();
+  printf("%-16s %u writers, %u readers, %u groups, %u failed calls, %u membership mismatches\n", "churn",
+         gWriterCount, readers, gGroupCount, errors, mismatches);
+  ret = ((errors == 0) && (mismatches == 0)) ? 0 : -1;
+
+teardown:
+  for (t = 0; t < gGroupCount; t++)
+  {
+    vlan_hal_delete_all_Interfaces(gGroups[t]);
+    vlan_hal_delGroup(gGroups[t]);
+  }
+cleanup:
+  for (t = 0; (threads != NULL) && (t < gWriterCount); t++)
+  {
+    free(threads[t].ports);
+  }
+  free(samples);
+  free(threads);
+  free(gGroups);
+  gGroups = NULL;
+  gWriters = NULL;
+  return ret;
+}
+
+const vlan_hal_bench_t vlan_hal_bench_churn =
+{
+  "churn",
+  "add/del interface churn from -t writer,reader threads for -d ms, then a membership check",
+  bench_churn_run
+};
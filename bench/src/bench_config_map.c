@@ -0,0 +1,102 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <unistd.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "vlan_hal_config_map.h"
+#include "vlan_hal_bench.h"
+
+/* Group name -> VLAN lookups: HAL call versus the published memory-mapped file */
+
+#define BENCH_CONFIG_MAP_GROUPS 256
+
+static int bench_config_map_run(unsigned int iterations)
+{
+  char names[BENCH_CONFIG_MAP_GROUPS][IFNAMSIZ];
+  char vlanID[5];
+  char path[64];
+  vlan_config_map_t map;
+  volatile unsigned int sink = 0;
+  uint16_t value;
+  uint64_t start;
+  unsigned int i;
+  int ret = -1;
+
+  snprintf(path, sizeof(path), "/tmp/vlan_hal_bench_map_%d", (int)getpid());
+  for (i = 0; i < BENCH_CONFIG_MAP_GROUPS; i++)
+  {
+    snprintf(names[i], IFNAMSIZ, "brbench%u", i);
+  }
+  for (i = 0; i < BENCH_CONFIG_MAP_GROUPS; i++)
+  {
+    snprintf(vlanID, sizeof(vlanID), "%u", 1000 + i);
+    if (insert_VLAN_ConfigEntry(names[i], vlanID) != RETURN_OK)
+    {
+      goto cleanup;
+    }
+  }
+  if (vlan_hal_config_publish(path) != RETURN_OK)
+  {
+    goto cleanup;
+  }
+  if (vlan_config_map_open(&map, path) != 0)
+  {
+    vlan_hal_config_unpublish();
+    goto cleanup;
+  }
+
+  start = vlan_hal_bench_now_ns();
+  for (i = 0; i < iterations; i++)
+  {
+    if (get_vlanId_for_GroupName(names[i % BENCH_CONFIG_MAP_GROUPS], vlanID) == RETURN_OK)
+    {
+      sink += (unsigned int)vlanID[0];
+    }
+  }
+  vlan_hal_bench_report("config_map", "get_vlanId_for_GroupName", iterations, vlan_hal_bench_now_ns() - start);
+
+  start = vlan_hal_bench_now_ns();
+  for (i = 0; i < iterations; i++)
+  {
+    if (vlan_config_map_lookup(&map, names[i % BENCH_CONFIG_MAP_GROUPS], &value) == 0)
+    {
+      sink += value;
+    }
+  }
+  vlan_hal_bench_report("config_map", "vlan_config_map_lookup", iterations, vlan_hal_bench_now_ns() - start);
+
+  vlan_config_map_close(&map);
+  vlan_hal_config_unpublish();
+  ret = 0;
+
+cleanup:
+  for (i = 0; i < BENCH_CONFIG_MAP_GROUPS; i++)
+  {
+    delete_VLAN_ConfigEntry(names[i]);
+  }
+  unlink(path);
+  return ret;
+}
+
+const vlan_hal_bench_t vlan_hal_bench_config_map =
+{
+  "config_map",
+  "group to VLAN lookup via the HAL versus the memory-mapped file",
+  bench_config_map_run
+};
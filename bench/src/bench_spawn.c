@@ -0,0 +1,135 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "vlan_hal_bench.h"
+
+/*
+ * "brctl show | grep -w brlan0" as test_l1_vlan_hal_positive1_get_shell_outputbuffer
+ * runs it: popen() through /bin/sh and grep, versus vlan_hal_run() of brctl
+ * alone with the word match done in the callback. Hosts without brctl time
+ * the same shape of pipeline over /proc/net/dev instead.
+ */
+
+/* Each command costs a process spawn, so run one per this many iterations */
+#define BENCH_SPAWN_SCALE 1000
+
+typedef struct
+{
+  const char *shell;
+  const char *argv[3];
+  const char *word;
+} bench_spawn_case_t;
+
+static const bench_spawn_case_t gCases[] =
+{
+  { "brctl show | grep -w brlan0", { "brctl", "show", NULL }, "brlan0" },
+  { "cat /proc/net/dev | grep -w lo", { "cat", "/proc/net/dev", NULL }, "lo" },
+};
+
+typedef struct
+{
+  const char *word;
+  char *out;
+  size_t size;
+} bench_spawn_match_t;
+
+static int is_word_char(char c)
+{
+  return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) || (c == '_');
+}
+
+/* grep -w: @word occurs in @line delimited by non-word characters */
+static int bench_spawn_grep_w(void *ctx, char *line, size_t length)
+{
+  bench_spawn_match_t *match = ctx;
+  size_t wordLength = strlen(match->word);
+  char *at = line;
+
+  while ((at = strstr(at, match->word)) != NULL)
+  {
+    if (((at == line) || !is_word_char(at[-1])) && !is_word_char(at[wordLength]))
+    {
+      if (match->out[0] == '\0')
+      {
+        snprintf(match->out, match->size, "%.*s", (int)length, line);
+      }
+      return 0;
+    }
+    at++;
+  }
+  return 0;
+}
+
+static int bench_spawn_run(unsigned int iterations)
+{
+  const bench_spawn_case_t *bench = NULL;
+  bench_spawn_match_t match;
+  char popenOut[512];
+  char spawnOut[512];
+  unsigned int runs = (iterations + BENCH_SPAWN_SCALE - 1) / BENCH_SPAWN_SCALE;
+  uint64_t start;
+  unsigned int i;
+
+  for (i = 0; i < sizeof(gCases) / sizeof(gCases[0]); i++)
+  {
+    if (vlan_hal_run(gCases[i].argv, NULL, NULL) == 0)
+    {
+      bench = &gCases[i];
+      break;
+    }
+  }
+  if (bench == NULL)
+  {
+    return -1;
+  }
+  printf("%-16s %s\n", "spawn", bench->shell);
+
+  start = vlan_hal_bench_now_ns();
+  for (i = 0; i < runs; i++)
+  {
+    _get_shell_outputbuffer((char *)bench->shell, popenOut, sizeof(popenOut));
+  }
+  vlan_hal_bench_report("spawn", "popen", runs, vlan_hal_bench_now_ns() - start);
+
+  match.word = bench->word;
+  match.out = spawnOut;
+  match.size = sizeof(spawnOut);
+  start = vlan_hal_bench_now_ns();
+  for (i = 0; i < runs; i++)
+  {
+    spawnOut[0] = '\0';
+    if (vlan_hal_run(bench->argv, bench_spawn_grep_w, &match) != 0)
+    {
+      return -1;
+    }
+  }
+  vlan_hal_bench_report("spawn", "vlan_hal_run", runs, vlan_hal_bench_now_ns() - start);
+
+  /* Both must find the same line, or the comparison is meaningless */
+  return (strcmp(popenOut, spawnOut) == 0) ? 0 : -1;
+}
+
+const vlan_hal_bench_t vlan_hal_bench_spawn =
+{
+  "spawn",
+  "shell pipeline via popen versus posix_spawn with in-process filtering",
+  bench_spawn_run
+};
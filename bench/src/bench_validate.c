@@ -0,0 +1,96 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include "vlan_hal.h"
+#include "vlan_hal_validate.h"
+#include "vlan_hal_bench.h"
+
+/*
+ * Input validation next to the calls it guards: the VLAN ID and name
+ * checks over the valid and malformed inputs of the L1 profile, versus a
+ * lookup and an add/delete through the HAL.
+ */
+
+static const char *gVlanIDs[] =
+{
+  "1", "10", "2052", "4094", "", "0", "4095", "73412", "01", "1a2"
+};
+
+static const char *gNames[] =
+{
+  "brlan0", "brlan1", "brlan112", "brlan113", "brlanXYZ", "brlan@10", "1234", "bRLaN0", "wl0.2", ""
+};
+
+#define BENCH_VALIDATE_INPUTS (sizeof(gVlanIDs) / sizeof(gVlanIDs[0]))
+
+static int bench_validate_run(unsigned int iterations)
+{
+  volatile unsigned int sink = 0;
+  char vlanID[5];
+  uint16_t value;
+  uint64_t start;
+  unsigned int i;
+
+  start = vlan_hal_bench_now_ns();
+  for (i = 0; i < iterations; i++)
+  {
+    if (vlan_validate_vlan_id(gVlanIDs[i % BENCH_VALIDATE_INPUTS], &value) == 0)
+    {
+      sink += value;
+    }
+  }
+  vlan_hal_bench_report("validate", "vlan_validate_vlan_id", iterations, vlan_hal_bench_now_ns() - start);
+
+  start = vlan_hal_bench_now_ns();
+  for (i = 0; i < iterations; i++)
+  {
+    sink += (unsigned int)vlan_validate_name(gNames[i % BENCH_VALIDATE_INPUTS]);
+  }
+  vlan_hal_bench_report("validate", "vlan_validate_name", iterations, vlan_hal_bench_now_ns() - start);
+
+  if (insert_VLAN_ConfigEntry("brlan0", "10") != RETURN_OK)
+  {
+    return -1;
+  }
+  start = vlan_hal_bench_now_ns();
+  for (i = 0; i < iterations; i++)
+  {
+    sink += (unsigned int)get_vlanId_for_GroupName("brlan0", vlanID);
+  }
+  vlan_hal_bench_report("validate", "get_vlanId_for_GroupName", iterations, vlan_hal_bench_now_ns() - start);
+  delete_VLAN_ConfigEntry("brlan0");
+
+  /* Publishes a snapshot per call, so fewer rounds */
+  start = vlan_hal_bench_now_ns();
+  for (i = 0; i < iterations / 100; i++)
+  {
+    sink += (unsigned int)vlan_hal_addGroup("brlan0", "10");
+    sink += (unsigned int)vlan_hal_delGroup("brlan0");
+  }
+  vlan_hal_bench_report("validate", "addGroup+delGroup", iterations / 100, vlan_hal_bench_now_ns() - start);
+
+  (void)sink;
+  return 0;
+}
+
+const vlan_hal_bench_t vlan_hal_bench_validate =
+{
+  "validate",
+  "VLAN ID and name validation cost next to the HAL calls they guard",
+  bench_validate_run
+};
@@ -0,0 +1,356 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "vlan_profile_snapshot.h"
+#include "vlan_hal_bench.h"
+
+#define VLAN_HAL_BENCH_DEFAULT_ITERATIONS 1000000u
+#define VLAN_HAL_BENCH_MAX_SCALES 32
+#define VLAN_HAL_BENCH_DEFAULT_WRITERS 4u
+#define VLAN_HAL_BENCH_DEFAULT_READERS 4u
+#define VLAN_HAL_BENCH_DEFAULT_DURATION_MS 1000u
+#define VLAN_HAL_BENCH_MAX_THREADS 256u
+
+static const vlan_hal_bench_t *gBenches[] =
+{
+#ifdef VLAN_HAL_SKELETON
+  &vlan_hal_bench_config_map,
+  &vlan_hal_bench_spawn,
+  &vlan_hal_bench_async,
+  &vlan_hal_bench_validate,
+#endif
+  &vlan_hal_bench_api,
+  &vlan_hal_bench_churn,
+  NULL
+};
+
+/* Inputs from -p, results to -j, scales from -s */
+static vlan_profile_snapshot_t gProfile;
+static FILE *gJson;
+static unsigned int gJsonRecords;
+static unsigned int gScales[VLAN_HAL_BENCH_MAX_SCALES];
+static unsigned int gScaleCount;
+static unsigned int gScale;
+
+/* Thread counts and run time of the stress benchmarks, from -t and -d */
+static unsigned int gWriters = VLAN_HAL_BENCH_DEFAULT_WRITERS;
+static unsigned int gReaders = VLAN_HAL_BENCH_DEFAULT_READERS;
+static unsigned int gDurationMs = VLAN_HAL_BENCH_DEFAULT_DURATION_MS;
+
+uint64_t vlan_hal_bench_now_ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec;
+}
+
+/* Starts the JSON object of one result, the caller adds its fields and closes it */
+static void vlan_hal_bench_json_begin(const char *bench, const char *variant, unsigned int iterations, double meanNs)
+{
+  fprintf(gJson, "%s\n    {\"bench\": \"%s\", \"variant\": \"%s\", \"ops\": %u, \"mean_ns\": %.1f",
+          (gJsonRecords++ == 0) ? "" : ",", bench, variant, iterations, meanNs);
+  if (gScale != 0)
+  {
+    fprintf(gJson, ", \"scale\": %u", gScale);
+  }
+}
+
+void vlan_hal_bench_report(const char *bench, const char *variant, unsigned int iterations, uint64_t elapsedNs)
+{
+  double meanNs = (iterations > 0) ? (double)elapsedNs / iterations : 0.0;
+
+  printf("%-16s %-32s %10u ops %12.1f ns/op\n", bench, variant, iterations, meanNs);
+  if (gJson != NULL)
+  {
+    vlan_hal_bench_json_begin(bench, variant, iterations, meanNs);
+    fprintf(gJson, "}");
+  }
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted samples */
+static uint64_t percentile(const uint64_t *sorted, unsigned int count, unsigned int percent)
+{
+  uint64_t rank = (((uint64_t)count * percent) + 99) / 100;
+
+  return sorted[(rank > 0) ? rank - 1 : 0];
+}
+
+uint64_t vlan_hal_bench_report_latency(const char *bench, const char *variant, uint64_t *samplesNs, unsigned int count, unsigned int errors)
+{
+  char label[96];
+  uint64_t total = 0;
+  double meanNs;
+  unsigned int i;
+
+  if (count == 0)
+  {
+    return 0;
+  }
+  qsort(samplesNs, count, sizeof(samplesNs[0]), compare_u64);
+  for (i = 0; i < count; i++)
+  {
+    total += samplesNs[i];
+  }
+  meanNs = (double)total / count;
+  if (gScale != 0)
+  {
+    snprintf(label, sizeof(label), "%s N=%u", variant, gScale);
+    variant = label;
+  }
+  printf("%-16s %-58s %8u ops  p50 %9llu  p90 %9llu  p99 %9llu  max %9llu ns", bench, variant, count,
+         (unsigned long long)percentile(samplesNs, count, 50), (unsigned long long)percentile(samplesNs, count, 90),
+         (unsigned long long)percentile(samplesNs, count, 99), (unsigned long long)samplesNs[count - 1]);
+  if (errors > 0)
+  {
+    printf("  %u errors", errors);
+  }
+  printf("\n");
+  if (gJson != NULL)
+  {
+    vlan_hal_bench_json_begin(bench, variant, count, meanNs);
+    fprintf(gJson, ", \"p50_ns\": %llu, \"p90_ns\": %llu, \"p99_ns\": %llu, \"max_ns\": %llu, \"errors\": %u}",
+            (unsigned long long)percentile(samplesNs, count, 50), (unsigned long long)percentile(samplesNs, count, 90),
+            (unsigned long long)percentile(samplesNs, count, 99), (unsigned long long)samplesNs[count - 1], errors);
+  }
+  return percentile(samplesNs, count, 50);
+}
+
+int vlan_hal_bench_profile_list(const char *key, const char **values, int max)
+{
+  return vlan_profile_snapshot_list(&gProfile, key, values, max);
+}
+
+unsigned int vlan_hal_bench_scales(const unsigned int **scales)
+{
+  *scales = gScales;
+  return gScaleCount;
+}
+
+void vlan_hal_bench_set_scale(unsigned int scale)
+{
+  gScale = scale;
+}
+
+void vlan_hal_bench_threads(unsigned int *writers, unsigned int *readers)
+{
+  *writers = gWriters;
+  *readers = gReaders;
+}
+
+unsigned int vlan_hal_bench_duration_ms(void)
+{
+  return gDurationMs;
+}
+
+/* Parses "<writers>,<readers>", either may be 0 but not both */
+static int parse_threads(const char *text)
+{
+  unsigned long writers;
+  unsigned long readers;
+  char *end;
+
+  writers = strtoul(text, &end, 10);
+  if ((end == text) || (*end != ','))
+  {
+    return -1;
+  }
+  text = end + 1;
+  readers = strtoul(text, &end, 10);
+  if ((end == text) || (*end != '\0') || (writers + readers == 0) ||
+      (writers > VLAN_HAL_BENCH_MAX_THREADS) || (readers > VLAN_HAL_BENCH_MAX_THREADS))
+  {
+    return -1;
+  }
+  gWriters = (unsigned int)writers;
+  gReaders = (unsigned int)readers;
+  return 0;
+}
+
+/* Parses "16,64,256" into gScales */
+static int parse_scales(const char *text)
+{
+  unsigned long value;
+  char *end;
+
+  gScaleCount = 0;
+  for (;;)
+  {
+    value = strtoul(text, &end, 10);
+    if ((end == text) || (value == 0) || (value > UINT32_MAX) || (gScaleCount == VLAN_HAL_BENCH_MAX_SCALES))
+    {
+      return -1;
+    }
+    gScales[gScaleCount++] = (unsigned int)value;
+    if (*end == '\0')
+    {
+      return 0;
+    }
+    if (*end != ',')
+    {
+      return -1;
+    }
+    text = end + 1;
+  }
+}
+
+static void usage(const char *program)
+{
+  int i;
+
+  printf("Usage: %s [-n iterations] [-p snapshot] [-s N,N,...] [-t writers,readers] [-d ms] [-j file] [-l] [benchmark...]\n", program);
+  printf("  -n  operations per variant (default %u)\n", VLAN_HAL_BENCH_DEFAULT_ITERATIONS);
+  printf("  -p  take inputs from a profile snapshot built by \"make profile\"\n");
+  printf("  -s  sweep the benchmarks that support it over these numbers of groups\n");
+  printf("  -t  writer and reader threads of the stress benchmarks (default %u,%u)\n",
+         VLAN_HAL_BENCH_DEFAULT_WRITERS, VLAN_HAL_BENCH_DEFAULT_READERS);
+  printf("  -d  run time of the stress benchmarks in milliseconds (default %u)\n", VLAN_HAL_BENCH_DEFAULT_DURATION_MS);
+  printf("  -j  also write the results as JSON to file, \"-\" for stdout\n");
+  printf("  -l  list benchmarks\n");
+  for (i = 0; gBenches[i] != NULL; i++)
+  {
+    printf("  %-16s %s\n", gBenches[i]->name, gBenches[i]->description);
+  }
+}
+
+static int is_selected(const vlan_hal_bench_t *bench, int argc, char **argv, int first)
+{
+  int i;
+
+  if (first >= argc)
+  {
+    return 1;
+  }
+  for (i = first; i < argc; i++)
+  {
+    if (strcmp(argv[i], bench->name) == 0)
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  unsigned int iterations = VLAN_HAL_BENCH_DEFAULT_ITERATIONS;
+  const char *json = NULL;
+  int failed = 0;
+  int first = 1;
+  int ret;
+  int i;
+
+  while ((first < argc) && (argv[first][0] == '-'))
+  {
+    if ((strcmp(argv[first], "-n") == 0) && (first + 1 < argc))
+    {
+      iterations = (unsigned int)strtoul(argv[first + 1], NULL, 10);
+      first += 2;
+    }
+    else if ((strcmp(argv[first], "-p") == 0) && (first + 1 < argc))
+    {
+      ret = vlan_profile_snapshot_open(&gProfile, argv[first + 1]);
+      if (ret != 0)
+      {
+        fprintf(stderr, "%s: %s\n", argv[first + 1], strerror(-ret));
+        return 1;
+      }
+      first += 2;
+    }
+    else if ((strcmp(argv[first], "-s") == 0) && (first + 1 < argc) && (parse_scales(argv[first + 1]) == 0))
+    {
+      first += 2;
+    }
+    else if ((strcmp(argv[first], "-t") == 0) && (first + 1 < argc) && (parse_threads(argv[first + 1]) == 0))
+    {
+      first += 2;
+    }
+    else if ((strcmp(argv[first], "-d") == 0) && (first + 1 < argc))
+    {
+      gDurationMs = (unsigned int)strtoul(argv[first + 1], NULL, 10);
+      first += 2;
+    }
+    else if ((strcmp(argv[first], "-j") == 0) && (first + 1 < argc))
+    {
+      json = argv[first + 1];
+      first += 2;
+    }
+    else
+    {
+      usage(argv[0]);
+      return (strcmp(argv[first], "-l") == 0) ? 0 : 1;
+    }
+  }
+
+  if (json != NULL)
+  {
+    if (strcmp(json, "-") == 0)
+    {
+      /* The JSON keeps stdout, everything the benchmarks print goes to stderr */
+      fflush(stdout);
+      gJson = fdopen(dup(STDOUT_FILENO), "w");
+      dup2(STDERR_FILENO, STDOUT_FILENO);
+    }
+    else
+    {
+      gJson = fopen(json, "w");
+    }
+    if (gJson == NULL)
+    {
+      perror(json);
+      return 1;
+    }
+    fprintf(gJson, "{\n  \"iterations\": %u,\n  \"results\": [", iterations);
+  }
+
+  for (i = 0; gBenches[i] != NULL; i++)
+  {
+    if (!is_selected(gBenches[i], argc, argv, first))
+    {
+      continue;
+    }
+    if (gBenches[i]->run(iterations) != 0)
+    {
+      printf("%-16s FAILED\n", gBenches[i]->name);
+      failed = 1;
+    }
+  }
+
+  if (gJson != NULL)
+  {
+    fprintf(gJson, "\n  ],\n  \"failed\": %s\n}\n", failed ? "true" : "false");
+    if (fclose(gJson) != 0)
+    {
+      failed = 1;
+    }
+  }
+  vlan_profile_snapshot_close(&gProfile);
+  return failed;
+}
@@ -0,0 +1,98 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_bench.h
+ *
+ * Micro-benchmarks for the VLAN HAL, built as vlan_hal_bench by "make bench".
+ *
+ * Each benchmark times one or more variants of an operation and reports
+ * them with vlan_hal_bench_report(), so alternatives can be compared side
+ * by side from a single run. vlan_hal_bench_api needs only the public HAL
+ * API, so "make bench TARGET=arm" qualifies a vendor libhal_vlan_hal.
+ */
+#ifndef __VLAN_HAL_BENCH_H__
+#define __VLAN_HAL_BENCH_H__
+
+#include <stdint.h>
+
+typedef struct
+{
+  const char *name;
+  const char *description;
+  int (*run)(unsigned int iterations);  /*!< Returns 0 on success */
+} vlan_hal_bench_t;
+
+/**
+ * @brief Monotonic clock in nanoseconds.
+ */
+uint64_t vlan_hal_bench_now_ns(void);
+
+/**
+ * @brief Print the mean cost per operation of one variant.
+ */
+void vlan_hal_bench_report(const char *bench, const char *variant, unsigned int iterations, uint64_t elapsedNs);
+
+/**
+ * @brief Print the p50/p90/p99/max latency of one variant from per-call samples.
+ *
+ * Sorts @p samplesNs in place. @p errors counts calls that did not return RETURN_OK.
+ *
+ * @return The p50, 0 if there are no samples.
+ */
+uint64_t vlan_hal_bench_report_latency(const char *bench, const char *variant, uint64_t *samplesNs, unsigned int count, unsigned int errors);
+
+/**
+ * @brief Look up a string list of the profile snapshot given with -p.
+ *
+ * Same contract as vlan_profile_snapshot_list(), -1 also when no snapshot was given.
+ */
+int vlan_hal_bench_profile_list(const char *key, const char **values, int max);
+
+/**
+ * @brief Numbers of groups given with -s for a scaling sweep.
+ *
+ * @return How many there are, 0 when no sweep was requested.
+ */
+unsigned int vlan_hal_bench_scales(const unsigned int **scales);
+
+/**
+ * @brief Tag the following reports with scale @p scale, 0 removes the tag.
+ */
+void vlan_hal_bench_set_scale(unsigned int scale);
+
+/**
+ * @brief Writer and reader thread counts for the stress benchmarks, from -t.
+ */
+void vlan_hal_bench_threads(unsigned int *writers, unsigned int *readers);
+
+/**
+ * @brief Run time of the stress benchmarks in milliseconds, from -d.
+ */
+unsigned int vlan_hal_bench_duration_ms(void);
+
+#ifdef VLAN_HAL_SKELETON
+extern const vlan_hal_bench_t vlan_hal_bench_config_map;
+extern const vlan_hal_bench_t vlan_hal_bench_spawn;
+extern const vlan_hal_bench_t vlan_hal_bench_async;
+extern const vlan_hal_bench_t vlan_hal_bench_validate;
+#endif
+extern const vlan_hal_bench_t vlan_hal_bench_api;
+extern const vlan_hal_bench_t vlan_hal_bench_churn;
+
+#endif /* __VLAN_HAL_BENCH_H__ */
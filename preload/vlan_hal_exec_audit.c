@@ -0,0 +1,721 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <sched.h>
+#include <spawn.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "vlan_hal.h"
+#include "vlan_hal_exec_audit.h"
+
+typedef enum
+{
+    AUDIT_FORK = 0,
+    AUDIT_VFORK,
+    AUDIT_CLONE,
+    AUDIT_EXEC,
+    AUDIT_POPEN,
+    AUDIT_SYSTEM,
+    AUDIT_SPAWN,
+    AUDIT_KINDS
+} audit_kind_t;
+
+static const char *const gKindNames[AUDIT_KINDS] = { "fork", "vfork", "clone", "exec", "popen", "system", "spawn" };
+
+#define AUDIT_API_LIST(X) \
+    X(vlan_hal_addGroup) X(vlan_hal_delGroup) X(vlan_hal_addInterface) X(vlan_hal_delInterface) \
+    X(vlan_hal_printGroup) X(vlan_hal_printAllGroup) X(vlan_hal_delete_all_Interfaces) \
+    X(_is_this_group_available_in_linux_bridge) X(_is_this_interface_available_in_linux_bridge) \
+    X(_is_this_interface_available_in_given_linux_bridge) X(_get_shell_outputbuffer) \
+    X(_get_shell_outputbuffer_res) X(insert_VLAN_ConfigEntry) X(delete_VLAN_ConfigEntry) \
+    X(get_vlanId_for_GroupName) X(print_all_vlanId_Configuration)
+
+#define AUDIT_API_SLOT(name) AUDIT_API_##name,
+#define AUDIT_API_NAME(name) #name,
+
+/* One slot per HAL API, then one for process starts outside the HAL */
+typedef enum
+{
+    AUDIT_API_LIST(AUDIT_API_SLOT)
+    AUDIT_SLOT_OUTSIDE,
+    AUDIT_SLOTS
+} audit_slot_t;
+
+static const char *const gSlotNames[AUDIT_SLOTS] = { AUDIT_API_LIST(AUDIT_API_NAME) VLAN_HAL_EXEC_AUDIT_OUTSIDE };
+
+typedef struct
+{
+    uint64_t calls;
+    uint64_t count[AUDIT_KINDS];
+    uint64_t ns[AUDIT_KINDS];
+    uint64_t maxPerCall;
+} audit_counters_t;
+
+typedef struct
+{
+    int outer;                  /*!< Not inside another HAL call */
+    uint64_t starts;            /*!< Starts counted against the slot when the call began */
+} audit_call_t;
+
+/* AUDIT_SLOTS entries, shared so that children forked by the HAL count their exec */
+static audit_counters_t *gCounters;
+static pid_t gOwner;
+static int gDenied[AUDIT_SLOTS];
+static __thread int tSlot = AUDIT_SLOT_OUTSIDE;
+static __thread int tDepth;
+
+static void *audit_real(const char *name)
+{
+    return dlsym(RTLD_NEXT, name);
+}
+
+static uint64_t audit_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec;
+}
+
+static void audit_count(audit_kind_t kind, uint64_t startNs, int counted)
+{
+    audit_counters_t *counters = gCounters;
+
+    if (counters == NULL)
+    {
+        return;
+    }
+    counters += tSlot;
+    if (counted)
+    {
+        __atomic_fetch_add(&counters->count[kind], 1, __ATOMIC_RELAXED);
+    }
+    if (startNs != 0)
+    {
+        __atomic_fetch_add(&counters->ns[kind], audit_now_ns() - startNs, __ATOMIC_RELAXED);
+    }
+}
+
+/* Processes started against @slot, an exec replaces a process rather than starting one */
+static uint64_t audit_starts(const audit_counters_t *counters)
+{
+    uint64_t starts = 0;
+    int kind;
+
+    for (kind = 0; kind < AUDIT_KINDS; kind++)
+    {
+        if (kind != AUDIT_EXEC)
+        {
+            starts += __atomic_load_n(&counters->count[kind], __ATOMIC_RELAXED);
+        }
+    }
+    return starts;
+}
+
+/* Calls the HAL makes to its own API stay with the outermost one */
+static void audit_enter(audit_call_t *call, audit_slot_t slot)
+{
+    call->outer = (tDepth++ == 0);
+    call->starts = 0;
+    if (!call->outer)
+    {
+        return;
+    }
+    tSlot = slot;
+    if (gCounters != NULL)
+    {
+        __atomic_fetch_add(&gCounters[slot].calls, 1, __ATOMIC_RELAXED);
+        call->starts = audit_starts(&gCounters[slot]);
+    }
+}
+
+static void audit_leave(const audit_call_t *call)
+{
+    audit_counters_t *counters = (gCounters != NULL) ? &gCounters[tSlot] : NULL;
+    uint64_t started;
+    uint64_t max;
+
+    tDepth--;
+    if (!call->outer)
+    {
+        return;
+    }
+    if (counters != NULL)
+    {
+        /* Other threads in the same API can add to this, so it is an upper bound */
+        started = audit_starts(counters) - call->starts;
+        max = __atomic_load_n(&counters->maxPerCall, __ATOMIC_RELAXED);
+        while ((started > max) &&
+               !__atomic_compare_exchange_n(&counters->maxPerCall, &max, started, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+        }
+    }
+    tSlot = AUDIT_SLOT_OUTSIDE;
+}
+
+static void audit_parse_deny(void)
+{
+    const char *deny = getenv(VLAN_HAL_EXEC_AUDIT_DENY_ENV);
+    const char *name;
+    size_t length;
+    int slot;
+
+    memset(gDenied, 0, sizeof(gDenied));
+    if (deny == NULL)
+    {
+        return;
+    }
+    for (name = deny; *name != '\0'; name += length + (name[length] == ','))
+    {
+        length = strcspn(name, ",");
+        for (slot = 0; slot < AUDIT_SLOT_OUTSIDE; slot++)
+        {
+            if (((length == 1) && (*name == '*')) ||
+                ((strlen(gSlotNames[slot]) == length) && (strncmp(gSlotNames[slot], name, length) == 0)))
+            {
+                gDenied[slot] = 1;
+            }
+        }
+    }
+}
+
+void vlan_hal_exec_audit_begin(void)
+{
+    void *shared;
+
+    /* A fork of an audited process, such as a parallel test worker, keeps its own counts */
+    if ((gCounters == NULL) || (gOwner != getpid()))
+    {
+        shared = mmap(NULL, AUDIT_SLOTS * sizeof(audit_counters_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (shared == MAP_FAILED)
+        {
+            return;
+        }
+        if (gCounters != NULL)
+        {
+            munmap(gCounters, AUDIT_SLOTS * sizeof(audit_counters_t));
+        }
+        gCounters = shared;
+        gOwner = getpid();
+        audit_parse_deny();
+    }
+    memset(gCounters, 0, AUDIT_SLOTS * sizeof(audit_counters_t));
+}
+
+/* Appends @member whole, or nothing if it does not fit */
+static int audit_append(char *report, size_t size, size_t *used, const char *member)
+{
+    size_t length = strlen(member);
+
+    if (*used + length >= size)
+    {
+        return -1;
+    }
+    memcpy(report + *used, member, length + 1);
+    *used += length;
+    return 0;
+}
+
+unsigned int vlan_hal_exec_audit_end(char *report, size_t size)
+{
+    audit_counters_t counters;
+    unsigned int violations = 0;
+    char member[512];
+    size_t length;
+    size_t used = 0;
+    uint64_t total;
+    int slot;
+    int kind;
+
+    if ((report != NULL) && (size > 0))
+    {
+        report[0] = '\0';
+    }
+    if ((gCounters == NULL) || (gOwner != getpid()))
+    {
+        return 0;
+    }
+    for (slot = 0; slot < AUDIT_SLOTS; slot++)
+    {
+        memcpy(&counters, &gCounters[slot], sizeof(counters));
+        total = 0;
+        for (kind = 0; kind < AUDIT_KINDS; kind++)
+        {
+            total += counters.count[kind];
+        }
+        if ((counters.calls == 0) && (total == 0))
+        {
+            continue;
+        }
+        if (gDenied[slot])
+        {
+            violations += (unsigned int)total;
+        }
+        if ((report == NULL) || (size == 0))
+        {
+            continue;
+        }
+
+        length = (size_t)snprintf(member, sizeof(member), "%s\"%s\": {", (used > 0) ? ", " : "", gSlotNames[slot]);
+        if (slot != AUDIT_SLOT_OUTSIDE)
+        {
+            length += (size_t)snprintf(member + length, sizeof(member) - length, "\"calls\": %llu, ",
+                                       (unsigned long long)counters.calls);
+        }
+        for (kind = 0; kind < AUDIT_KINDS; kind++)
+        {
+            if (counters.count[kind] == 0)
+            {
+                continue;
+            }
+            length += (size_t)snprintf(member + length, sizeof(member) - length, "\"%s\": %llu, ", gKindNames[kind],
+                                       (unsigned long long)counters.count[kind]);
+            if (kind != AUDIT_EXEC)
+            {
+                length += (size_t)snprintf(member + length, sizeof(member) - length, "\"%s_us\": %llu, ", gKindNames[kind],
+                                           (unsigned long long)(counters.ns[kind] / 1000));
+            }
+        }
+        if (slot != AUDIT_SLOT_OUTSIDE)
+        {
+            length += (size_t)snprintf(member + length, sizeof(member) - length, "\"max_per_call\": %llu, ",
+                                       (unsigned long long)counters.maxPerCall);
+        }
+        /* Replace the separator after the last value */
+        snprintf(member + length - 2, sizeof(member) - length + 2, "}");
+        if (audit_append(report, size, &used, member) != 0)
+        {
+            /* Keep counting violations, drop the members that do not fit */
+            size = 0;
+        }
+    }
+    return violations;
+}
+
+/* HAL API */
+
+#define AUDIT_HAL_CALL(name, params, args) \
+    int name params \
+    { \
+        static int (*real) params; \
+        audit_call_t call; \
+        int ret; \
+        \
+        if (real == NULL) \
+        { \
+            real = (int (*) params)audit_real(#name); \
+        } \
+        if (real == NULL) \
+        { \
+            return RETURN_ERR; \
+        } \
+        audit_enter(&call, AUDIT_API_##name); \
+        ret = real args; \
+        audit_leave(&call); \
+        return ret; \
+    }
+
+#define AUDIT_HAL_CALL_VOID(name, params, args) \
+    void name params \
+    { \
+        static void (*real) params; \
+        audit_call_t call; \
+        \
+        if (real == NULL) \
+        { \
+            real = (void (*) params)audit_real(#name); \
+        } \
+        if (real == NULL) \
+        { \
+            return; \
+        } \
+        audit_enter(&call, AUDIT_API_##name); \
+        real args; \
+        audit_leave(&call); \
+    }
+
+AUDIT_HAL_CALL(vlan_hal_addGroup, (const char *groupName, const char *default_vlanID), (groupName, default_vlanID))
+AUDIT_HAL_CALL(vlan_hal_delGroup, (const char *groupName), (groupName))
+AUDIT_HAL_CALL(vlan_hal_addInterface, (const char *groupName, const char *ifName, const char *vlanID), (groupName, ifName, vlanID))
+AUDIT_HAL_CALL(vlan_hal_delInterface, (const char *groupName, const char *ifName, const char *vlanID), (groupName, ifName, vlanID))
+AUDIT_HAL_CALL(vlan_hal_printGroup, (const char *groupName), (groupName))
+AUDIT_HAL_CALL(vlan_hal_printAllGroup, (void), ())
+AUDIT_HAL_CALL(vlan_hal_delete_all_Interfaces, (const char *groupName), (groupName))
+AUDIT_HAL_CALL(_is_this_group_available_in_linux_bridge, (char *br_name), (br_name))
+AUDIT_HAL_CALL(_is_this_interface_available_in_linux_bridge, (char *if_name, char *vlanID), (if_name, vlanID))
+AUDIT_HAL_CALL(_is_this_interface_available_in_given_linux_bridge, (char *if_name, char *br_name, char *vlanID), (if_name, br_name, vlanID))
+AUDIT_HAL_CALL_VOID(_get_shell_outputbuffer, (char *cmd, char *out, int len), (cmd, out, len))
+AUDIT_HAL_CALL_VOID(_get_shell_outputbuffer_res, (FILE *fp, char *out, int len), (fp, out, len))
+AUDIT_HAL_CALL(insert_VLAN_ConfigEntry, (char *groupName, char *vlanID), (groupName, vlanID))
+AUDIT_HAL_CALL(delete_VLAN_ConfigEntry, (char *groupName), (groupName))
+AUDIT_HAL_CALL(get_vlanId_for_GroupName, (const char *groupName, char *vlanID), (groupName, vlanID))
+AUDIT_HAL_CALL(print_all_vlanId_Configuration, (void), ())
+
+/* Process creation */
+
+pid_t fork(void)
+{
+    static pid_t (*real)(void);
+    uint64_t start = audit_now_ns();
+    pid_t pid;
+
+    if (real == NULL)
+    {
+        real = (pid_t (*)(void))audit_real("fork");
+    }
+    if (real == NULL)
+    {
+        errno = ENOSYS;
+        return -1;
+    }
+    pid = real();
+    if (pid > 0)
+    {
+        audit_count(AUDIT_FORK, start, 1);
+    }
+    return pid;
+}
+
+/*
+ * A vfork child borrows the stack of this wrapper, which is gone once the
+ * wrapper returns to it, so it is a fork here. Callers may not rely on
+ * anything vfork shares beyond what fork gives them.
+ */
+pid_t vfork(void)
+{
+    static pid_t (*real)(void);
+    uint64_t start = audit_now_ns();
+    pid_t pid;
+
+    if (real == NULL)
+    {
+        real = (pid_t (*)(void))audit_real("fork");
+    }
+    if (real == NULL)
+    {
+        errno = ENOSYS;
+        return -1;
+    }
+    pid = real();
+    if (pid > 0)
+    {
+        audit_count(AUDIT_VFORK, start, 1);
+    }
+    return pid;
+}
+
+int clone(int (*fn)(void *), void *stack, int flags, void *arg, ...)
+{
+    static int (*real)(int (*)(void *), void *, int, void *, ...);
+    uint64_t start = audit_now_ns();
+    void *parentTid;
+    void *tls;
+    void *childTid;
+    va_list args;
+    int ret;
+
+    /* Optional arguments, passed on whether or not the caller gave them */
+    va_start(args, arg);
+    parentTid = va_arg(args, void *);
+    tls = va_arg(args, void *);
+    childTid = va_arg(args, void *);
+    va_end(args);
+
+    if (real == NULL)
+    {
+        real = (int (*)(int (*)(void *), void *, int, void *, ...))audit_real("clone");
+    }
+    if (real == NULL)
+    {
+        errno = ENOSYS;
+        return -1;
+    }
+    ret = real(fn, stack, flags, arg, parentTid, tls, childTid);
+    if ((ret > 0) && !(flags & CLONE_THREAD))
+    {
+        audit_count(AUDIT_CLONE, start, 1);
+    }
+    return ret;
+}
+
+typedef int (*audit_execve_t)(const char *, char *const[], char *const[]);
+typedef int (*audit_execv_t)(const char *, char *const[]);
+
+/* An exec only returns on failure, so it is counted before it is made */
+int execve(const char *path, char *const argv[], char *const envp[])
+{
+    static audit_execve_t real;
+
+    if (real == NULL)
+    {
+        real = (audit_execve_t)audit_real("execve");
+    }
+    if (real == NULL)
+    {
+        errno = ENOSYS;
+        return -1;
+    }
+    audit_count(AUDIT_EXEC, 0, 1);
+    return real(path, argv, envp);
+}
+
+int execvpe(const char *file, char *const argv[], char *const envp[])
+{
+    static audit_execve_t real;
+
+    if (real == NULL)
+    {
+        real = (audit_execve_t)audit_real("execvpe");
+    }
+    if (real == NULL)
+    {
+        errno = ENOSYS;
+        return -1;
+    }
+    audit_count(AUDIT_EXEC, 0, 1);
+    return real(file, argv, envp);
+}
+
+static int audit_execv(const char *symbol, const char *path, char *const argv[])
+{
+    audit_execv_t real = (audit_execv_t)audit_real(symbol);
+
+    if (real == NULL)
+    {
+        errno = ENOSYS;
+        return -1;
+    }
+    audit_count(AUDIT_EXEC, 0, 1);
+    return real(path, argv);
+}
+
+int execv(const char *path, char *const argv[])
+{
+    return audit_execv("execv", path, argv);
+}
+
+int execvp(const char *file, char *const argv[])
+{
+    return audit_execv("execvp", file, argv);
+}
+
+/* Number of arguments after @first up to and including the terminating NULL */
+static size_t audit_count_args(const char *first, va_list args)
+{
+    size_t count = 1;
+
+    if (first != NULL)
+    {
+        while (va_arg(args, char *) != NULL)
+        {
+            count++;
+        }
+        count++;
+    }
+    return count;
+}
+
+static void audit_collect_args(char **argv, size_t count, const char *first, va_list args)
+{
+    size_t i;
+
+    argv[0] = (char *)first;
+    for (i = 1; i < count; i++)
+    {
+        argv[i] = va_arg(args, char *);
+    }
+}
+
+int execl(const char *path, const char *arg, ...)
+{
+    va_list args;
+    size_t count;
+
+    va_start(args, arg);
+    count = audit_count_args(arg, args);
+    va_end(args);
+    {
+        char *argv[count];
+
+        va_start(args, arg);
+        audit_collect_args(argv, count, arg, args);
+        va_end(args);
+        return audit_execv("execv", path, argv);
+    }
+}
+
+int execlp(const char *file, const char *arg, ...)
+{
+    va_list args;
+    size_t count;
+
+    va_start(args, arg);
+    count = audit_count_args(arg, args);
+    va_end(args);
+    {
+        char *argv[count];
+
+        va_start(args, arg);
+        audit_collect_args(argv, count, arg, args);
+        va_end(args);
+        return audit_execv("execvp", file, argv);
+    }
+}
+
+int execle(const char *path, const char *arg, ...)
+{
+    static audit_execve_t real;
+    va_list args;
+    size_t count;
+    char *const *envp;
+
+    va_start(args, arg);
+    count = audit_count_args(arg, args);
+    va_end(args);
+    {
+        char *argv[count];
+
+        /* The environment follows the NULL that ends the arguments */
+        va_start(args, arg);
+        audit_collect_args(argv, count, arg, args);
+        envp = va_arg(args, char *const *);
+        va_end(args);
+
+        if (real == NULL)
+        {
+            real = (audit_execve_t)audit_real("execve");
+        }
+        if (real == NULL)
+        {
+            errno = ENOSYS;
+            return -1;
+        }
+        audit_count(AUDIT_EXEC, 0, 1);
+        return real(path, argv, envp);
+    }
+}
+
+typedef int (*audit_spawn_t)(pid_t *, const char *, const posix_spawn_file_actions_t *, const posix_spawnattr_t *,
+                             char *const[], char *const[]);
+
+static int audit_spawn(const char *symbol, pid_t *pid, const char *path, const posix_spawn_file_actions_t *actions,
+                       const posix_spawnattr_t *attr, char *const argv[], char *const envp[])
+{
+    audit_spawn_t real = (audit_spawn_t)audit_real(symbol);
+    uint64_t start = audit_now_ns();
+    int ret;
+
+    if (real == NULL)
+    {
+        return ENOSYS;
+    }
+    ret = real(pid, path, actions, attr, argv, envp);
+    if (ret == 0)
+    {
+        audit_count(AUDIT_SPAWN, start, 1);
+    }
+    return ret;
+}
+
+int posix_spawn(pid_t *pid, const char *path, const posix_spawn_file_actions_t *actions,
+                const posix_spawnattr_t *attr, char *const argv[], char *const envp[])
+{
+    return audit_spawn("posix_spawn", pid, path, actions, attr, argv, envp);
+}
+
+int posix_spawnp(pid_t *pid, const char *file, const posix_spawn_file_actions_t *actions,
+                 const posix_spawnattr_t *attr, char *const argv[], char *const envp[])
+{
+    return audit_spawn("posix_spawnp", pid, file, actions, attr, argv, envp);
+}
+
+FILE *popen(const char *command, const char *type)
+{
+    static FILE *(*real)(const char *, const char *);
+    uint64_t start = audit_now_ns();
+    FILE *fp;
+
+    if (real == NULL)
+    {
+        real = (FILE *(*)(const char *, const char *))audit_real("popen");
+    }
+    if (real == NULL)
+    {
+        errno = ENOSYS;
+        return NULL;
+    }
+    fp = real(command, type);
+    if (fp != NULL)
+    {
+        audit_count(AUDIT_POPEN, start, 1);
+    }
+    return fp;
+}
+
+/* Waiting for the command is part of the cost of the popen() that started it */
+int pclose(FILE *fp)
+{
+    static int (*real)(FILE *);
+    uint64_t start = audit_now_ns();
+    int ret;
+
+    if (real == NULL)
+    {
+        real = (int (*)(FILE *))audit_real("pclose");
+    }
+    if (real == NULL)
+    {
+        errno = ENOSYS;
+        return -1;
+    }
+    ret = real(fp);
+    audit_count(AUDIT_POPEN, start, 0);
+    return ret;
+}
+
+int system(const char *command)
+{
+    static int (*real)(const char *);
+    uint64_t start = audit_now_ns();
+    int ret;
+
+    if (real == NULL)
+    {
+        real = (int (*)(const char *))audit_real("system");
+    }
+    if (real == NULL)
+    {
+        errno = ENOSYS;
+        return -1;
+    }
+    ret = real(command);
+    if (command != NULL)
+    {
+        audit_count(AUDIT_SYSTEM, start, 1);
+    }
+    return ret;
+}
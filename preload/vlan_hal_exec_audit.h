@@ -0,0 +1,79 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_exec_audit.h
+ *
+ * LD_PRELOAD shim that counts the processes a HAL starts. Build it with
+ * "make exec-audit" and run the suite with
+ * LD_PRELOAD=bin/libvlan_hal_exec_audit.so.
+ *
+ * The shim interposes the public HAL API and fork(), vfork(), clone(), the
+ * exec family, posix_spawn(), posix_spawnp(), popen() and system(). Each
+ * process start is counted against the outermost HAL API the calling thread
+ * is in, or against VLAN_HAL_EXEC_AUDIT_OUTSIDE when the caller is not in
+ * the HAL. An exec in a child the HAL forked is counted too, because the
+ * counters live in memory shared with the child. Processes started by those
+ * children after their exec are not counted.
+ *
+ * HAL calls can only be interposed when the HAL is a shared library, as on a
+ * target. With the skeleton linked into the test binary, every process start
+ * is counted against VLAN_HAL_EXEC_AUDIT_OUTSIDE.
+ *
+ * The shim is inert until the suite calls vlan_hal_exec_audit_begin(). The
+ * suite finds it with dlsym(), so the same binary runs with or without it,
+ * see test_resources.h.
+ */
+#ifndef __VLAN_HAL_EXEC_AUDIT_H__
+#define __VLAN_HAL_EXEC_AUDIT_H__
+
+#include <stddef.h>
+
+/** Comma-separated HAL APIs that must not start processes, "*" for all of them */
+#define VLAN_HAL_EXEC_AUDIT_DENY_ENV "VLAN_HAL_EXEC_AUDIT_DENY"
+
+/** Name process starts outside any HAL API are reported under */
+#define VLAN_HAL_EXEC_AUDIT_OUTSIDE "(test)"
+
+#define VLAN_HAL_EXEC_AUDIT_BEGIN "vlan_hal_exec_audit_begin"
+#define VLAN_HAL_EXEC_AUDIT_END "vlan_hal_exec_audit_end"
+
+typedef void (*vlan_hal_exec_audit_begin_t)(void);
+typedef unsigned int (*vlan_hal_exec_audit_end_t)(char *report, size_t size);
+
+/**
+ * @brief Start counting for a new test, dropping the counts of the previous one.
+ */
+void vlan_hal_exec_audit_begin(void);
+
+/**
+ * @brief Stop counting and describe what the test started.
+ *
+ * @p report receives the members of a JSON object, one per HAL API that was
+ * called or started a process, for example
+ * "get_vlanId_for_GroupName": {"calls": 4, "popen": 4, "popen_us": 2310, "max_per_call": 1}.
+ * Each kind of start has a count and a total latency, except exec, which
+ * only returns when it fails. max_per_call is the most processes one call
+ * started. The report is truncated to fit @p size and is empty if nothing
+ * was called.
+ *
+ * @return Process starts inside the APIs listed in VLAN_HAL_EXEC_AUDIT_DENY.
+ */
+unsigned int vlan_hal_exec_audit_end(char *report, size_t size);
+
+#endif /* __VLAN_HAL_EXEC_AUDIT_H__ */
@@ -15,130 +15,1403 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <setjmp.h>
+#include <pthread.h>
 #include "vlan_hal.h"
+#include "vlan_hal_group_table.h"
+#include "vlan_hal_vlan_bitmap.h"
+#include "vlan_hal_port_index.h"
+#include "vlan_hal_config_store.h"
+#include "vlan_hal_config_map.h"
+#include "vlan_hal_rcu.h"
+#include "vlan_hal_reader.h"
+#include "vlan_hal_spawn.h"
+#include "vlan_hal_validate.h"
+#include "vlan_hal_backend.h"
+#include "vlan_hal_ext.h"
+
+/* VLAN IDs assigned to at least one group, gVlanGroups counts the groups per ID */
+static vlan_bitmap_t gVlanBitmap;
+static uint16_t gVlanGroups[VLAN_BITMAP_ID_MAX + 1];
+/* Optional persistent copy of the group table, see vlan_hal_config_open() */
+static vlan_config_store_t gConfigStore = { -1, NULL, 0, 0 };
+static int gConfigReady = 0;
+/* Optional memory-mapped copy of the group table for other processes, see vlan_hal_config_publish() */
+static vlan_config_map_t gConfigMap = { NULL, NULL, 0, 0 };
+
+/*
+ * The registry is split into shards by name hash: groups by group name and
+ * the port index, port "<ifName>.<vlanID>" -> bridge, by port name. A shard
+ * is NULL until something hashes to it.
+ */
+#define VLAN_HAL_SHARD_BITS 6
+#define VLAN_HAL_SHARDS (1u << VLAN_HAL_SHARD_BITS)
+
+/*
+ * Concurrency: writers serialise on gWriteLock. The first change a write
+ * makes to a shard copies it, later changes in the same write go to the
+ * copy. Before unlocking, the writer publishes a new immutable snapshot
+ * that points at the copied shards and shares every other shard with the
+ * previous one, so a write costs the shards it touches rather than the
+ * whole registry. Readers only look at gSnapshot inside an RCU read
+ * section, so they never wait for a writer; the previous snapshot and the
+ * shards it no longer shares are freed once no reader can hold them.
+ */
+typedef struct
+{
+  vlan_group_table_t *groups[VLAN_HAL_SHARDS];
+  vlan_port_index_t *ports[VLAN_HAL_SHARDS];
+  vlan_bitmap_t vlans;
+  uint32_t generation;          /*!< Bumped on every publish, 0 for gEmptySnapshot */
+} vlan_hal_snapshot_t;
+
+static pthread_mutex_t gWriteLock = PTHREAD_MUTEX_INITIALIZER;
+static vlan_hal_snapshot_t *gSnapshot = NULL;
+/* Empty tables, seen by readers before the first write */
+static const vlan_hal_snapshot_t gEmptySnapshot;
+static uint32_t gGeneration = 0;
+/* The registry as writers see it: the published shards plus the ones the current write copied */
+static vlan_hal_snapshot_t gRegistry;
+/* One bit per shard of gRegistry copied by the current write, VLAN_HAL_SHARDS bits */
+static uint64_t gGroupsCopied = 0;
+static uint64_t gPortsCopied = 0;
+static uint32_t gGroupCount = 0;
+/* Allocated by the first change of a write, so publishing it cannot fail */
+static vlan_hal_snapshot_t *gNextSnapshot = NULL;
+
+/* The tables pick slots with the low bits of the same hash, shards use the high ones */
+static uint32_t vlan_hal_shard(const char *name)
+{
+  return vlan_group_table_hash(name) >> (32 - VLAN_HAL_SHARD_BITS);
+}
+
+static vlan_group_entry_t *vlan_hal_group(const vlan_hal_snapshot_t *registry, const char *groupName)
+{
+  return vlan_group_table_find(registry->groups[vlan_hal_shard(groupName)], groupName);
+}
+
+static vlan_port_entry_t *vlan_hal_port(const vlan_hal_snapshot_t *registry, const char *port)
+{
+  return vlan_port_index_find(registry->ports[vlan_hal_shard(port)], port);
+}
+
+/* Returns group shard @shard, copied for the current write, or NULL on allocation failure */
+static vlan_group_table_t *vlan_hal_groups_write(uint32_t shard)
+{
+  vlan_group_table_t *copy;
+
+  if (gGroupsCopied & (1ull << shard))
+  {
+    return gRegistry.groups[shard];
+  }
+  if ((gNextSnapshot == NULL) && ((gNextSnapshot = malloc(sizeof(*gNextSnapshot))) == NULL))
+  {
+    return NULL;
+  }
+  copy = calloc(1, sizeof(*copy));
+  if ((copy == NULL) ||
+      ((gRegistry.groups[shard] != NULL) && (vlan_group_table_copy(copy, gRegistry.groups[shard]) != 0)))
+  {
+    free(copy);
+    return NULL;
+  }
+  gRegistry.groups[shard] = copy;
+  gGroupsCopied |= 1ull << shard;
+  return copy;
+}
+
+/* As vlan_hal_groups_write() for port shard @shard */
+static vlan_port_index_t *vlan_hal_ports_write(uint32_t shard)
+{
+  vlan_port_index_t *copy;
+
+  if (gPortsCopied & (1ull << shard))
+  {
+    return gRegistry.ports[shard];
+  }
+  if ((gNextSnapshot == NULL) && ((gNextSnapshot = malloc(sizeof(*gNextSnapshot))) == NULL))
+  {
+    return NULL;
+  }
+  copy = calloc(1, sizeof(*copy));
+  if ((copy == NULL) ||
+      ((gRegistry.ports[shard] != NULL) && (vlan_port_index_copy(copy, gRegistry.ports[shard]) != 0)))
+  {
+    free(copy);
+    return NULL;
+  }
+  gRegistry.ports[shard] = copy;
+  gPortsCopied |= 1ull << shard;
+  return copy;
+}
+
+static void vlan_hal_write_begin(void)
+{
+  pthread_mutex_lock(&gWriteLock);
+}
+
+/* Frees @snapshot along with the shards its successor replaced, the shared ones live on */
+static void vlan_hal_snapshot_retire(vlan_hal_snapshot_t *snapshot, uint64_t groups, uint64_t ports)
+{
+  uint32_t shard;
+
+  if (snapshot == NULL)
+  {
+    return;
+  }
+  for (shard = 0; shard < VLAN_HAL_SHARDS; shard++)
+  {
+    if (groups & (1ull << shard))
+    {
+      vlan_group_table_deinit(snapshot->groups[shard]);
+      free(snapshot->groups[shard]);
+    }
+    if (ports & (1ull << shard))
+    {
+      vlan_port_index_deinit(snapshot->ports[shard]);
+      free(snapshot->ports[shard]);
+    }
+  }
+  free(snapshot);
+}
+
+/* Publishes the shards the write copied, retiring the previous snapshot */
+static void vlan_hal_write_end(void)
+{
+  vlan_hal_snapshot_t *snapshot = gNextSnapshot;
+  vlan_hal_snapshot_t *previous;
+
+  if ((gGroupsCopied | gPortsCopied) != 0)
+  {
+    gRegistry.vlans = gVlanBitmap;
+    gRegistry.generation = ++gGeneration;
+    *snapshot = gRegistry;
+    gNextSnapshot = NULL;
+    previous = __atomic_exchange_n(&gSnapshot, snapshot, __ATOMIC_SEQ_CST);
+    /* From inside a read section this thread may still hold @previous, leak it rather than free it */
+    if (vlan_rcu_synchronize() == 0)
+    {
+      vlan_hal_snapshot_retire(previous, gGroupsCopied, gPortsCopied);
+    }
+    gGroupsCopied = 0;
+    gPortsCopied = 0;
+  }
+  pthread_mutex_unlock(&gWriteLock);
+}
+
+/* Every read_begin must be paired with read_end once the snapshot is no longer used */
+static const vlan_hal_snapshot_t *vlan_hal_read_begin(void)
+{
+  const vlan_hal_snapshot_t *snapshot;
+
+  vlan_rcu_read_lock();
+  snapshot = __atomic_load_n(&gSnapshot, __ATOMIC_SEQ_CST);
+  return (snapshot != NULL) ? snapshot : &gEmptySnapshot;
+}
+
+static void vlan_hal_read_end(void)
+{
+  vlan_rcu_read_unlock();
+}
+
+static int vlan_hal_is_valid_name(const char *name)
+{
+  return vlan_validate_name(name) > 0;
+}
+
+static int vlan_hal_parse_vlanID(const char *vlanID, uint16_t *value)
+{
+  return vlan_validate_vlan_id(vlanID, value);
+}
+
+static vlan_group_entry_t *vlan_hal_find_group(const char *groupName)
+{
+  if (!vlan_hal_is_valid_name(groupName))
+  {
+    return NULL;
+  }
+  return vlan_hal_group(&gRegistry, groupName);
+}
+
+/* Validates an interface/VLAN pair and builds its port name, the reverse index key */
+static int vlan_hal_parse_port(const char *ifName, const char *vlanID, uint16_t *vlan, char *port)
+{
+  if (!vlan_hal_is_valid_name(ifName) || (vlan_hal_parse_vlanID(vlanID, vlan) != 0))
+  {
+    return -1;
+  }
+  return vlan_hal_backend_port_name(ifName, *vlan, port, IFNAMSIZ);
+}
+
+/* Copies every port shard holding a port of @bridge, so removing them cannot fail */
+static int vlan_hal_copy_members(vlan_name_t bridge)
+{
+  vlan_port_entry_t *entry;
+  uint32_t shard;
+  uint32_t cursor;
+
+  for (shard = 0; shard < VLAN_HAL_SHARDS; shard++)
+  {
+    cursor = 0;
+    while ((entry = vlan_port_index_next(gRegistry.ports[shard], &cursor)) != NULL)
+    {
+      if (entry->bridge == bridge)
+      {
+        if (vlan_hal_ports_write(shard) == NULL)
+        {
+          return -1;
+        }
+        break;
+      }
+    }
+  }
+  return 0;
+}
+
+/*
+ * Drops every port of @group from the index, deleting it through the
+ * backend first when @detach is set. Stops at the first backend failure.
+ */
+static int vlan_hal_remove_members(const vlan_group_entry_t *group, int detach)
+{
+  vlan_name_t bridge = group->name;
+  const vlan_hal_backend_t *backend = vlan_hal_backend_get();
+  vlan_port_index_t *ports;
+  vlan_port_entry_t *entry;
+  uint32_t shard;
+  uint32_t cursor;
+
+  for (shard = 0; shard < VLAN_HAL_SHARDS; shard++)
+  {
+    ports = gRegistry.ports[shard];
+    cursor = 0;
+    while ((entry = vlan_port_index_next(ports, &cursor)) != NULL)
+    {
+      if (entry->bridge != bridge)
+      {
+        continue;
+      }
+      if (detach && (backend->del_port(vlan_name_str(bridge), vlan_name_str(entry->ifName), entry->vlanID) != 0))
+      {
+        return -1;
+      }
+      /* The copy keeps the slot layout, so the walk carries on in it */
+      ports = vlan_hal_ports_write(shard);
+      if (ports == NULL)
+      {
+        return -1;
+      }
+      vlan_port_index_remove(ports, vlan_name_str(entry->port));
+    }
+  }
+  return 0;
+}
+
+static void vlan_hal_vlan_hold(uint16_t vlan)
+{
+  if (gVlanGroups[vlan]++ == 0)
+  {
+    vlan_bitmap_set(&gVlanBitmap, vlan);
+  }
+}
+
+static void vlan_hal_vlan_drop(uint16_t vlan)
+{
+  if (--gVlanGroups[vlan] == 0)
+  {
+    vlan_bitmap_clear(&gVlanBitmap, vlan);
+  }
+}
+
+/* Rewrites the config log from the group shards once it is mostly superseded records */
+static void vlan_hal_config_maybe_compact(void)
+{
+  if (vlan_config_store_needs_compaction(&gConfigStore, gGroupCount))
+  {
+    /* On failure the existing log is still complete, compaction is retried on a later change */
+    vlan_config_store_compact(&gConfigStore, (const vlan_group_table_t *const *)gRegistry.groups, VLAN_HAL_SHARDS);
+  }
+}
+
+/* Records groupName -> vlan and keeps gVlanBitmap and the config log in step */
+static int vlan_hal_assign_vlan(const char *groupName, uint16_t vlan)
+{
+  vlan_group_entry_t *group = vlan_hal_group(&gRegistry, groupName);
+  vlan_group_table_t *groups;
+  uint16_t previous = 0;
+
+  if (group != NULL)
+  {
+    if (group->vlanID == vlan)
+    {
+      return 0;
+    }
+    previous = group->vlanID;
+  }
+  groups = vlan_hal_groups_write(vlan_hal_shard(groupName));
+  if (groups == NULL)
+  {
+    return -1;
+  }
+  if (gConfigReady && (vlan_config_store_put(&gConfigStore, groupName, vlan) != 0))
+  {
+    return -1;
+  }
+  if (vlan_group_table_insert(groups, groupName, vlan) != 0)
+  {
+    return -1;
+  }
+  if (previous == 0)
+  {
+    gGroupCount++;
+  }
+  vlan_hal_vlan_hold(vlan);
+  if (previous != 0)
+  {
+    vlan_hal_vlan_drop(previous);
+  }
+  if (gConfigMap.header != NULL)
+  {
+    vlan_config_map_put(&gConfigMap, groupName, vlan);
+  }
+  if (gConfigReady)
+  {
+    vlan_hal_config_maybe_compact();
+  }
+  return 0;
+}
+
+/*
+ * First half of forgetting @groupName: copies every shard the release
+ * changes and logs it, so vlan_hal_release_apply() cannot fail.
+ */
+static int vlan_hal_release_prepare(const char *groupName)
+{
+  vlan_group_entry_t *group = vlan_hal_group(&gRegistry, groupName);
+
+  if ((group == NULL) || (vlan_hal_groups_write(vlan_hal_shard(groupName)) == NULL) ||
+      (vlan_hal_copy_members(group->name) != 0))
+  {
+    return -1;
+  }
+  if (gConfigReady && (vlan_config_store_del(&gConfigStore, groupName) != 0))
+  {
+    return -1;
+  }
+  return 0;
+}
+
+/* Second half: drops the prepared group and its ports from the registry */
+static void vlan_hal_release_apply(const char *groupName)
+{
+  vlan_group_table_t *groups = gRegistry.groups[vlan_hal_shard(groupName)];
+  vlan_group_entry_t *group = vlan_group_table_find(groups, groupName);
+
+  vlan_hal_remove_members(group, 0);
+  vlan_hal_vlan_drop(group->vlanID);
+  vlan_group_table_remove(groups, groupName);
+  gGroupCount--;
+  if (gConfigMap.header != NULL)
+  {
+    vlan_config_map_del(&gConfigMap, groupName);
+  }
+  if (gConfigReady)
+  {
+    vlan_hal_config_maybe_compact();
+  }
+}
+
+/* Forgets @groupName and its ports, the bridge itself is left to the caller */
+static int vlan_hal_release_group(const char *groupName)
+{
+  if (vlan_hal_release_prepare(groupName) != 0)
+  {
+    return -1;
+  }
+  vlan_hal_release_apply(groupName);
+  return 0;
+}
+
+static void vlan_hal_config_replay(void *ctx, vlan_config_op_t op, const char *name, uint16_t vlanID)
+{
+  (void)ctx;
+  if (op == VLAN_CONFIG_OP_PUT)
+  {
+    vlan_hal_assign_vlan(name, vlanID);
+  }
+  else
+  {
+    vlan_hal_release_group(name);
+  }
+}
+
+static int vlan_hal_config_open_locked(const char *path)
+{
+  if ((path == NULL) || gConfigReady)
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_config_store_open(&gConfigStore, path, vlan_hal_config_replay, NULL) != 0)
+  {
+    return RETURN_ERR;
+  }
+  gConfigReady = 1;
+  vlan_hal_config_maybe_compact();
+  return RETURN_OK;
+}
+
+int vlan_hal_config_open(const char *path)
+{
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = vlan_hal_config_open_locked(path);
+  vlan_hal_write_end();
+  return ret;
+}
+
+static int vlan_hal_config_sync_locked(void)
+{
+  if (!gConfigReady || (vlan_config_store_sync(&gConfigStore) != 0))
+  {
+    return RETURN_ERR;
+  }
+  return RETURN_OK;
+}
+
+int vlan_hal_config_sync(void)
+{
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = vlan_hal_config_sync_locked();
+  vlan_hal_write_end();
+  return ret;
+}
+
+static void vlan_hal_config_close_locked(void)
+{
+  if (gConfigReady)
+  {
+    vlan_config_store_close(&gConfigStore);
+    gConfigReady = 0;
+  }
+}
+
+void vlan_hal_config_close(void)
+{
+  vlan_hal_write_begin();
+  vlan_hal_config_close_locked();
+  vlan_hal_write_end();
+}
+
+static int vlan_hal_config_publish_locked(const char *path)
+{
+  vlan_group_entry_t *group;
+  uint32_t shard;
+  uint32_t cursor;
+
+  if ((path == NULL) || (gConfigMap.header != NULL))
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_config_map_create(&gConfigMap, path) != 0)
+  {
+    return RETURN_ERR;
+  }
+  for (shard = 0; shard < VLAN_HAL_SHARDS; shard++)
+  {
+    cursor = 0;
+    while ((group = vlan_group_table_next(gRegistry.groups[shard], &cursor)) != NULL)
+    {
+      vlan_config_map_put(&gConfigMap, vlan_name_str(group->name), group->vlanID);
+    }
+  }
+  return RETURN_OK;
+}
+
+int vlan_hal_config_publish(const char *path)
+{
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = vlan_hal_config_publish_locked(path);
+  vlan_hal_write_end();
+  return ret;
+}
+
+static void vlan_hal_config_unpublish_locked(void)
+{
+  vlan_config_map_close(&gConfigMap);
+}
+
+void vlan_hal_config_unpublish(void)
+{
+  vlan_hal_write_begin();
+  vlan_hal_config_unpublish_locked();
+  vlan_hal_write_end();
+}
+
+static int vlan_hal_create_group(const char *groupName, uint16_t vlan)
+{
+  if ((vlan_hal_group(&gRegistry, groupName) == NULL) &&
+      (vlan_hal_backend_get()->add_bridge(groupName) != 0))
+  {
+    return -1;
+  }
+  return vlan_hal_assign_vlan(groupName, vlan);
+}
+
+static int vlan_hal_addGroup_locked(const char *groupName, const char *default_vlanID)
+{
+  uint16_t vlan;
+
+  if (!vlan_hal_is_valid_name(groupName) || (vlan_hal_parse_vlanID(default_vlanID, &vlan) != 0))
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_hal_create_group(groupName, vlan) != 0)
+  {
+    return RETURN_ERR;
+  }
+  return RETURN_OK;
+}
 
 int vlan_hal_addGroup(const char *groupName, const char *default_vlanID)
 {
-  /*TODO: Implement Me!*/
-  (void)groupName;
-  (void)default_vlanID;
-  return (int)0;
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = vlan_hal_addGroup_locked(groupName, default_vlanID);
+  vlan_hal_write_end();
+  return ret;
+}
+
+static int vlan_hal_addDynamicGroup_locked(const char *groupName, char *vlanID)
+{
+  int vlan;
+
+  if (!vlan_hal_is_valid_name(groupName) || (vlanID == NULL))
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_hal_group(&gRegistry, groupName) != NULL)
+  {
+    return RETURN_ERR;
+  }
+  vlan = vlan_bitmap_find_free(&gVlanBitmap, VLAN_BITMAP_ID_MIN, VLAN_BITMAP_ID_MAX);
+  if (vlan < 0)
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_hal_create_group(groupName, (uint16_t)vlan) != 0)
+  {
+    return RETURN_ERR;
+  }
+  sprintf(vlanID, "%d", vlan);
+  return RETURN_OK;
+}
+
+int vlan_hal_addDynamicGroup(const char *groupName, char *vlanID)
+{
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = vlan_hal_addDynamicGroup_locked(groupName, vlanID);
+  vlan_hal_write_end();
+  return ret;
+}
+
+int vlan_hal_getVlanUsage(unsigned int *inUse, unsigned int *available)
+{
+  unsigned int used;
+
+  if ((inUse == NULL) && (available == NULL))
+  {
+    return RETURN_ERR;
+  }
+  used = vlan_bitmap_count(&vlan_hal_read_begin()->vlans);
+  vlan_hal_read_end();
+  if (inUse != NULL)
+  {
+    *inUse = used;
+  }
+  if (available != NULL)
+  {
+    *available = (VLAN_BITMAP_ID_MAX - VLAN_BITMAP_ID_MIN + 1) - used;
+  }
+  return RETURN_OK;
+}
+
+static int vlan_hal_delGroup_locked(const char *groupName)
+{
+  vlan_group_entry_t *group = vlan_hal_find_group(groupName);
+  uint16_t vlan;
+
+  if (group == NULL)
+  {
+    return RETURN_ERR;
+  }
+  vlan = group->vlanID;
+  /* Logged before the bridge goes, so a failed append leaves both the group and its bridge */
+  if (vlan_hal_release_prepare(groupName) != 0)
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_hal_backend_get()->del_bridge(groupName) != 0)
+  {
+    /* The group stays, put its record back; should that fail too, the next compaction rewrites it */
+    if (gConfigReady)
+    {
+      vlan_config_store_put(&gConfigStore, groupName, vlan);
+    }
+    return RETURN_ERR;
+  }
+  /* Removing the bridge releases its ports, the VLAN links themselves stay */
+  vlan_hal_release_apply(groupName);
+  return RETURN_OK;
 }
 
 int vlan_hal_delGroup(const char *groupName)
 {
-  /*TODO: Implement Me!*/
-  (void)groupName;
-  return (int)0;
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = vlan_hal_delGroup_locked(groupName);
+  vlan_hal_write_end();
+  return ret;
+}
+
+static int vlan_hal_addInterface_locked(const char *groupName, const char *ifName, const char *vlanID)
+{
+  vlan_port_index_t *ports;
+  char port[IFNAMSIZ];
+  uint16_t vlan;
+
+  if (vlan_hal_parse_port(ifName, vlanID, &vlan, port) != 0)
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_hal_find_group(groupName) == NULL)
+  {
+    return RETURN_ERR;
+  }
+  ports = vlan_hal_ports_write(vlan_hal_shard(port));
+  if (ports == NULL)
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_hal_backend_get()->add_port(groupName, ifName, vlan) != 0)
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_port_index_insert(ports, port, ifName, vlan, groupName) != 0)
+  {
+    return RETURN_ERR;
+  }
+  return RETURN_OK;
 }
 
 int vlan_hal_addInterface(const char *groupName, const char *ifName, const char *vlanID)
 {
-  /*TODO: Implement Me!*/
-  (void)groupName;
-  (void)ifName;
-  (void)vlanID;
-  return (int)0;
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = vlan_hal_addInterface_locked(groupName, ifName, vlanID);
+  vlan_hal_write_end();
+  return ret;
+}
+
+static int vlan_hal_addInterfaces_locked(const char *groupName, vlan_hal_interface_t *interfaces, int count)
+{
+  const vlan_hal_backend_t *backend = vlan_hal_backend_get();
+  vlan_hal_port_t *ports;
+  int *index;
+  int result = RETURN_OK;
+  int used = 0;
+  int i;
+
+  if ((interfaces == NULL) || (count <= 0))
+  {
+    return RETURN_ERR;
+  }
+  for (i = 0; i < count; i++)
+  {
+    interfaces[i].status = RETURN_ERR;
+  }
+  if (vlan_hal_find_group(groupName) == NULL)
+  {
+    return RETURN_ERR;
+  }
+  ports = malloc(sizeof(*ports) * (size_t)count);
+  index = malloc(sizeof(*index) * (size_t)count);
+  if ((ports == NULL) || (index == NULL))
+  {
+    free(ports);
+    free(index);
+    return RETURN_ERR;
+  }
+
+  for (i = 0; i < count; i++)
+  {
+    char port[IFNAMSIZ];
+    uint16_t vlan;
+
+    if (vlan_hal_parse_port(interfaces[i].ifName, interfaces[i].vlanID, &vlan, port) != 0)
+    {
+      result = RETURN_ERR;
+      continue;
+    }
+    ports[used].ifName = interfaces[i].ifName;
+    ports[used].vlanID = vlan;
+    ports[used].status = 0;
+    index[used++] = i;
+  }
+
+  if (backend->add_ports != NULL)
+  {
+    if ((used > 0) && (backend->add_ports(groupName, ports, used) != 0))
+    {
+      used = 0;
+      result = RETURN_ERR;
+    }
+  }
+  else
+  {
+    for (i = 0; i < used; i++)
+    {
+      ports[i].status = backend->add_port(groupName, ports[i].ifName, ports[i].vlanID);
+    }
+  }
+
+  for (i = 0; i < used; i++)
+  {
+    vlan_port_index_t *shard;
+    char port[IFNAMSIZ];
+
+    if ((ports[i].status == 0) &&
+        ((vlan_hal_backend_port_name(ports[i].ifName, ports[i].vlanID, port, sizeof(port)) != 0) ||
+         ((shard = vlan_hal_ports_write(vlan_hal_shard(port))) == NULL) ||
+         (vlan_port_index_insert(shard, port, ports[i].ifName, ports[i].vlanID, groupName) != 0)))
+    {
+      ports[i].status = -1;
+    }
+    interfaces[index[i]].status = (ports[i].status == 0) ? RETURN_OK : RETURN_ERR;
+    if (ports[i].status != 0)
+    {
+      result = RETURN_ERR;
+    }
+  }
+  free(ports);
+  free(index);
+  return result;
+}
+
+int vlan_hal_addInterfaces(const char *groupName, vlan_hal_interface_t *interfaces, int count)
+{
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = vlan_hal_addInterfaces_locked(groupName, interfaces, count);
+  vlan_hal_write_end();
+  return ret;
+}
+
+static int vlan_hal_delInterface_locked(const char *groupName, const char *ifName, const char *vlanID)
+{
+  vlan_group_entry_t *group;
+  vlan_port_entry_t *entry;
+  vlan_port_index_t *ports;
+  char port[IFNAMSIZ];
+  uint16_t vlan;
+
+  if (vlan_hal_parse_port(ifName, vlanID, &vlan, port) != 0)
+  {
+    return RETURN_ERR;
+  }
+  group = vlan_hal_find_group(groupName);
+  if (group == NULL)
+  {
+    return RETURN_ERR;
+  }
+  entry = vlan_hal_port(&gRegistry, port);
+  if ((entry == NULL) || (entry->bridge != group->name))
+  {
+    return RETURN_ERR;
+  }
+  ports = vlan_hal_ports_write(vlan_hal_shard(port));
+  if (ports == NULL)
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_hal_backend_get()->del_port(groupName, ifName, vlan) != 0)
+  {
+    return RETURN_ERR;
+  }
+  vlan_port_index_remove(ports, port);
+  return RETURN_OK;
 }
 
 int vlan_hal_delInterface(const char *groupName, const char *ifName, const char *vlanID)
 {
-  /*TODO: Implement Me!*/
-  (void)groupName;
-  (void)ifName;
-  (void)vlanID;
-  return (int)0;
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = vlan_hal_delInterface_locked(groupName, ifName, vlanID);
+  vlan_hal_write_end();
+  return ret;
 }
 
 int vlan_hal_printGroup(const char *groupName)
 {
-  /*TODO: Implement Me!*/
-  (void)groupName;
-  return (int)0;
+  const vlan_hal_snapshot_t *snapshot;
+  vlan_group_entry_t *group;
+  vlan_port_entry_t *entry;
+  uint32_t shard;
+  uint32_t cursor;
+
+  if (!vlan_hal_is_valid_name(groupName))
+  {
+    return RETURN_ERR;
+  }
+  snapshot = vlan_hal_read_begin();
+  group = vlan_hal_group(snapshot, groupName);
+  if (group == NULL)
+  {
+    vlan_hal_read_end();
+    return RETURN_ERR;
+  }
+  printf("Group: %s VLAN: %u\n", vlan_name_str(group->name), group->vlanID);
+  for (shard = 0; shard < VLAN_HAL_SHARDS; shard++)
+  {
+    cursor = 0;
+    while ((entry = vlan_port_index_next(snapshot->ports[shard], &cursor)) != NULL)
+    {
+      if (entry->bridge == group->name)
+      {
+        printf("  Interface: %s\n", vlan_name_str(entry->port));
+      }
+    }
+  }
+  vlan_hal_read_end();
+  return RETURN_OK;
+}
+
+/* Records copied out per read section, the callback runs once the section has ended */
+#define VLAN_HAL_WALK_BATCH 16
+
+typedef struct
+{
+  vlan_hal_record_t record;
+  uint32_t phase;               /*!< Cursor position after this record */
+  uint32_t shard;
+  uint32_t slot;
+} vlan_hal_walk_item_t;
+
+/*
+ * Copies up to @max records from @cursor on out of the current snapshot
+ * and moves @cursor past them. Each item remembers the position after it,
+ * so a callback that pauses part way through a batch loses nothing.
+ */
+static unsigned int vlan_hal_walk_fill(vlan_hal_cursor_t *cursor, vlan_hal_walk_item_t *items, unsigned int max)
+{
+  const vlan_hal_snapshot_t *snapshot;
+  vlan_group_entry_t *group;
+  vlan_port_entry_t *entry;
+  vlan_hal_record_t *record;
+  unsigned int count = 0;
+
+  snapshot = vlan_hal_read_begin();
+  if ((cursor->phase == VLAN_HAL_CURSOR_GROUPS) && (cursor->shard == 0) && (cursor->slot == 0))
+  {
+    cursor->generation = snapshot->generation;
+    cursor->changed = 0;
+  }
+  else if (cursor->generation != snapshot->generation)
+  {
+    cursor->changed = 1;
+  }
+
+  while ((cursor->phase == VLAN_HAL_CURSOR_GROUPS) && (count < max))
+  {
+    if (cursor->shard >= VLAN_HAL_SHARDS)
+    {
+      cursor->phase = VLAN_HAL_CURSOR_MEMBERS;
+      cursor->shard = 0;
+      cursor->slot = 0;
+      break;
+    }
+    group = vlan_group_table_next(snapshot->groups[cursor->shard], &cursor->slot);
+    if (group == NULL)
+    {
+      cursor->shard++;
+      cursor->slot = 0;
+      continue;
+    }
+    record = &items[count].record;
+    record->type = VLAN_HAL_RECORD_GROUP;
+    record->vlanID = group->vlanID;
+    strcpy(record->groupName, vlan_name_str(group->name));
+    record->ifName[0] = '\0';
+    record->portName[0] = '\0';
+    items[count].phase = cursor->phase;
+    items[count].shard = cursor->shard;
+    items[count++].slot = cursor->slot;
+  }
+  while ((cursor->phase == VLAN_HAL_CURSOR_MEMBERS) && (count < max))
+  {
+    if (cursor->shard >= VLAN_HAL_SHARDS)
+    {
+      cursor->phase = VLAN_HAL_CURSOR_DONE;
+      break;
+    }
+    entry = vlan_port_index_next(snapshot->ports[cursor->shard], &cursor->slot);
+    if (entry == NULL)
+    {
+      cursor->shard++;
+      cursor->slot = 0;
+      continue;
+    }
+    record = &items[count].record;
+    record->type = VLAN_HAL_RECORD_MEMBER;
+    record->vlanID = entry->vlanID;
+    strcpy(record->groupName, vlan_name_str(entry->bridge));
+    strcpy(record->ifName, vlan_name_str(entry->ifName));
+    strcpy(record->portName, vlan_name_str(entry->port));
+    items[count].phase = cursor->phase;
+    items[count].shard = cursor->shard;
+    items[count++].slot = cursor->slot;
+  }
+  vlan_hal_read_end();
+  return count;
+}
+
+/*
+ * Streams records: every group in shard and slot order, then every member
+ * port likewise. The cursor remembers the phase, shard and slot, so a walk
+ * can be split across calls without holding anything. Records are copied
+ * out in batches and @fn only runs outside the read section, so it may
+ * call back into the HAL, even to change the registry.
+ */
+int vlan_hal_walkGroups(vlan_hal_cursor_t *cursor, unsigned int maxRecords, vlan_hal_record_fn fn, void *ctx)
+{
+  vlan_hal_walk_item_t items[VLAN_HAL_WALK_BATCH];
+  vlan_hal_cursor_t next;
+  unsigned int emitted = 0;
+  unsigned int count;
+  unsigned int i;
+  int stop = 0;
+
+  if ((cursor == NULL) || (fn == NULL))
+  {
+    return RETURN_ERR;
+  }
+  while (!stop && (cursor->phase != VLAN_HAL_CURSOR_DONE) && ((maxRecords == 0) || (emitted < maxRecords)))
+  {
+    next = *cursor;
+    count = VLAN_HAL_WALK_BATCH;
+    if ((maxRecords != 0) && (maxRecords - emitted < count))
+    {
+      count = maxRecords - emitted;
+    }
+    count = vlan_hal_walk_fill(&next, items, count);
+    cursor->generation = next.generation;
+    cursor->changed = next.changed;
+    for (i = 0; (i < count) && !stop; i++)
+    {
+      cursor->phase = items[i].phase;
+      cursor->shard = items[i].shard;
+      cursor->slot = items[i].slot;
+      stop = fn(ctx, &items[i].record);
+      emitted++;
+    }
+    if (!stop)
+    {
+      /* Also covers a phase change that produced no record */
+      cursor->phase = next.phase;
+      cursor->shard = next.shard;
+      cursor->slot = next.slot;
+    }
+  }
+  return (cursor->phase == VLAN_HAL_CURSOR_DONE) ? RETURN_OK : VLAN_HAL_WALK_MORE;
+}
+
+typedef struct
+{
+  vlan_hal_record_t *records;
+  unsigned int capacity;
+  unsigned int count;
+} vlan_hal_read_ctx_t;
+
+static int vlan_hal_read_record(void *ctx, const vlan_hal_record_t *record)
+{
+  vlan_hal_read_ctx_t *read = ctx;
+
+  read->records[read->count++] = *record;
+  return 0;
+}
+
+int vlan_hal_readGroups(vlan_hal_cursor_t *cursor, vlan_hal_record_t *records, unsigned int capacity, unsigned int *count)
+{
+  vlan_hal_read_ctx_t read = { records, capacity, 0 };
+  int ret;
+
+  if ((records == NULL) || (capacity == 0) || (count == NULL))
+  {
+    return RETURN_ERR;
+  }
+  ret = vlan_hal_walkGroups(cursor, capacity, vlan_hal_read_record, &read);
+  *count = read.count;
+  return ret;
+}
+
+static int vlan_hal_print_group_record(void *ctx, const vlan_hal_record_t *record)
+{
+  (void)ctx;
+  if (record->type != VLAN_HAL_RECORD_GROUP)
+  {
+    return 1;
+  }
+  printf("Group: %s VLAN: %u\n", record->groupName, record->vlanID);
+  return 0;
 }
 
 int vlan_hal_printAllGroup(void)
 {
-  /*TODO: Implement Me!*/
-  return (int)0;
+  vlan_hal_cursor_t cursor = VLAN_HAL_CURSOR_INIT;
+
+  /* Members follow every group in the stream, the callback stops at the first one */
+  vlan_hal_walkGroups(&cursor, 0, vlan_hal_print_group_record, NULL);
+  return RETURN_OK;
+}
+
+static int vlan_hal_delete_all_Interfaces_locked(const char *groupName)
+{
+  vlan_group_entry_t *group = vlan_hal_find_group(groupName);
+
+  if (group == NULL)
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_hal_remove_members(group, 1) != 0)
+  {
+    return RETURN_ERR;
+  }
+  return RETURN_OK;
 }
 
 int vlan_hal_delete_all_Interfaces(const char *groupName)
 {
-  /*TODO: Implement Me!*/
-  (void)groupName;
-  return (int)0;
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = vlan_hal_delete_all_Interfaces_locked(groupName);
+  vlan_hal_write_end();
+  return ret;
 }
 
 int _is_this_group_available_in_linux_bridge(char *br_name)
 {
-  /*TODO: Implement Me!*/
-  (void)br_name;
-  return (int)0;
+  const vlan_hal_backend_t *backend = vlan_hal_backend_get();
+  int found;
+
+  if (!vlan_hal_is_valid_name(br_name))
+  {
+    return RETURN_ERR;
+  }
+  if (backend->has_bridge != NULL)
+  {
+    return (backend->has_bridge(br_name) == 1) ? RETURN_OK : RETURN_ERR;
+  }
+  found = (vlan_hal_group(vlan_hal_read_begin(), br_name) != NULL);
+  vlan_hal_read_end();
+  return found ? RETURN_OK : RETURN_ERR;
 }
 
 int _is_this_interface_available_in_linux_bridge(char *if_name, char *vlanID)
 {
-  /*TODO: Implement Me!*/
-  (void)if_name;
-  (void)vlanID;
-  return (int)0;
+  const vlan_hal_backend_t *backend = vlan_hal_backend_get();
+  vlan_port_entry_t *entry;
+  char bridge[IFNAMSIZ];
+  char port[IFNAMSIZ];
+  uint16_t vlan;
+  int found;
+
+  if (vlan_hal_parse_port(if_name, vlanID, &vlan, port) != 0)
+  {
+    return RETURN_ERR;
+  }
+  entry = vlan_hal_port(vlan_hal_read_begin(), port);
+  found = (entry != NULL);
+  if (found)
+  {
+    strcpy(bridge, vlan_name_str(entry->bridge));
+  }
+  vlan_hal_read_end();
+  if (!found)
+  {
+    return RETURN_ERR;
+  }
+  /* The index names the bridge, the system confirms the port is still there, outside the read section */
+  if ((backend->has_port != NULL) && (backend->has_port(bridge, port) != 1))
+  {
+    return RETURN_ERR;
+  }
+  return RETURN_OK;
 }
 
 int _is_this_interface_available_in_given_linux_bridge(char *if_name, char *br_name, char *vlanID)
 {
-  /*TODO: Implement Me!*/
-  (void)if_name;
-  (void)br_name;
-  (void)vlanID;
-  return (int)0;
+  const vlan_hal_backend_t *backend = vlan_hal_backend_get();
+  vlan_port_entry_t *entry;
+  char port[IFNAMSIZ];
+  uint16_t vlan;
+  int found;
+
+  if (!vlan_hal_is_valid_name(br_name) || (vlan_hal_parse_port(if_name, vlanID, &vlan, port) != 0))
+  {
+    return RETURN_ERR;
+  }
+  if (backend->has_port != NULL)
+  {
+    return (backend->has_port(br_name, port) == 1) ? RETURN_OK : RETURN_ERR;
+  }
+  entry = vlan_hal_port(vlan_hal_read_begin(), port);
+  found = (entry != NULL) && (strcmp(vlan_name_str(entry->bridge), br_name) == 0);
+  vlan_hal_read_end();
+  return found ? RETURN_OK : RETURN_ERR;
 }
 
 void _get_shell_outputbuffer(char *cmd, char *out, int len)
 {
-  /*TODO: Implement Me!*/
-  (void)cmd;
-  (void)out;
-  (void)len;
+  FILE *fp;
+
+  if ((cmd == NULL) || (out == NULL) || (len <= 0))
+  {
+    return;
+  }
+  out[0] = '\0';
+  fp = popen(cmd, "r");
+  if (fp == NULL)
+  {
+    return;
+  }
+  _get_shell_outputbuffer_res(fp, out, len);
+  pclose(fp);
 }
 
+/*
+ * Reads straight from the pipe descriptor, @fp must not have been read
+ * through stdio. Output beyond @len - 1 bytes is drained so the command
+ * is not killed by SIGPIPE, use vlan_hal_read_all() to keep it.
+ */
 void _get_shell_outputbuffer_res(FILE *fp, char *out, int len)
 {
-  /*TODO: Implement Me!*/
-  (void)fp;
-  (void)out;
-  (void)len;
+  long got;
+
+  if ((fp == NULL) || (out == NULL) || (len <= 0))
+  {
+    return;
+  }
+  got = vlan_reader_fill(fileno(fp), out, (size_t)len - 1);
+  if (got < 0)
+  {
+    got = 0;
+  }
+  if ((got > 0) && (out[got - 1] == '\n'))
+  {
+    got--;
+  }
+  out[got] = '\0';
+  vlan_reader_lines(fileno(fp), NULL, 0, NULL, NULL);
+}
+
+int vlan_hal_read_lines(FILE *fp, vlan_hal_line_fn fn, void *ctx)
+{
+  if ((fp == NULL) || (fn == NULL))
+  {
+    return RETURN_ERR;
+  }
+  return (vlan_reader_lines(fileno(fp), NULL, 0, fn, ctx) < 0) ? RETURN_ERR : RETURN_OK;
+}
+
+char *vlan_hal_read_all(FILE *fp, size_t *length)
+{
+  vlan_reader_arena_t arena = VLAN_READER_ARENA_INIT;
+
+  if (fp == NULL)
+  {
+    return NULL;
+  }
+  if (vlan_reader_slurp(fileno(fp), &arena) != 0)
+  {
+    vlan_reader_arena_release(&arena);
+    return NULL;
+  }
+  if (length != NULL)
+  {
+    *length = arena.length;
+  }
+  return arena.data;
+}
+
+void vlan_hal_backend_failed(vlan_hal_backend_op_t op, const char *brName, const char *ifName, uint16_t vlanID)
+{
+  vlan_port_index_t *ports;
+  vlan_port_entry_t *entry;
+  char port[IFNAMSIZ];
+
+  vlan_hal_write_begin();
+  switch (op)
+  {
+    case VLAN_HAL_BACKEND_ADD_BRIDGE:
+      /* Ports queued behind the bridge went with it */
+      vlan_hal_release_group(brName);
+      break;
+    case VLAN_HAL_BACKEND_ADD_PORT:
+      if (vlan_hal_backend_port_name(ifName, vlanID, port, sizeof(port)) != 0)
+      {
+        break;
+      }
+      entry = vlan_hal_port(&gRegistry, port);
+      if ((entry != NULL) && (strcmp(vlan_name_str(entry->bridge), brName) == 0) &&
+          ((ports = vlan_hal_ports_write(vlan_hal_shard(port))) != NULL))
+      {
+        vlan_port_index_remove(ports, port);
+      }
+      break;
+    case VLAN_HAL_BACKEND_DEL_PORT:
+      if ((vlan_hal_backend_port_name(ifName, vlanID, port, sizeof(port)) != 0) ||
+          (vlan_hal_group(&gRegistry, brName) == NULL) || (vlan_hal_port(&gRegistry, port) != NULL))
+      {
+        break;
+      }
+      ports = vlan_hal_ports_write(vlan_hal_shard(port));
+      if (ports != NULL)
+      {
+        vlan_port_index_insert(ports, port, ifName, vlanID, brName);
+      }
+      break;
+    default:
+      /* Bridge removal is applied before it returns, its caller already knows */
+      break;
+  }
+  vlan_hal_write_end();
+}
+
+int vlan_hal_commit(void)
+{
+  const vlan_hal_backend_t *backend = vlan_hal_backend_get();
+
+  if (backend->flush == NULL)
+  {
+    return RETURN_OK;
+  }
+  return (backend->flush() == 0) ? RETURN_OK : RETURN_ERR;
+}
+
+int vlan_hal_run(const char *const argv[], vlan_hal_line_fn fn, void *ctx)
+{
+  int ret;
+
+  if ((argv == NULL) || (argv[0] == NULL))
+  {
+    return RETURN_ERR;
+  }
+  ret = vlan_spawn_lines(argv, fn, ctx);
+  return (ret < 0) ? RETURN_ERR : ret;
+}
+
+static int insert_VLAN_ConfigEntry_locked(char *groupName, char *vlanID)
+{
+  uint16_t vlan;
+
+  if (!vlan_hal_is_valid_name(groupName) || (vlan_hal_parse_vlanID(vlanID, &vlan) != 0))
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_hal_assign_vlan(groupName, vlan) != 0)
+  {
+    return RETURN_ERR;
+  }
+  return RETURN_OK;
 }
 
 int insert_VLAN_ConfigEntry(char *groupName, char *vlanID)
 {
-  /*TODO: Implement Me!*/
-  (void)groupName;
-  (void)vlanID;
-  return (int)0;
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = insert_VLAN_ConfigEntry_locked(groupName, vlanID);
+  vlan_hal_write_end();
+  return ret;
+}
+
+static int delete_VLAN_ConfigEntry_locked(char *groupName)
+{
+  if (!vlan_hal_is_valid_name(groupName))
+  {
+    return RETURN_ERR;
+  }
+  if (vlan_hal_release_group(groupName) != 0)
+  {
+    return RETURN_ERR;
+  }
+  return RETURN_OK;
 }
 
 int delete_VLAN_ConfigEntry(char *groupName)
 {
-  /*TODO: Implement Me!*/
-  (void)groupName;
-  return (int)0;
+  int ret;
+
+  vlan_hal_write_begin();
+  ret = delete_VLAN_ConfigEntry_locked(groupName);
+  vlan_hal_write_end();
+  return ret;
 }
 
 int get_vlanId_for_GroupName(const char *groupName, char *vlanID)
 {
-  /*TODO: Implement Me!*/
-  (void)groupName;
-  (void)vlanID;
-  return (int)0;
+  vlan_group_entry_t *group;
+  uint16_t vlan = 0;
+
+  if ((vlanID == NULL) || !vlan_hal_is_valid_name(groupName))
+  {
+    return RETURN_ERR;
+  }
+  group = vlan_hal_group(vlan_hal_read_begin(), groupName);
+  if (group != NULL)
+  {
+    vlan = group->vlanID;
+  }
+  vlan_hal_read_end();
+  if (vlan == 0)
+  {
+    return RETURN_ERR;
+  }
+  /* At most "4094" plus the terminator, callers commonly pass a 5 byte buffer */
+  sprintf(vlanID, "%u", vlan);
+  return RETURN_OK;
 }
 
-int print_all_vlanId_Configuration(void)
+static int vlan_hal_print_config_record(void *ctx, const vlan_hal_record_t *record)
 {
-  /*TODO: Implement Me!*/
-  return (int)0;
+  (void)ctx;
+  if (record->type != VLAN_HAL_RECORD_GROUP)
+  {
+    return 1;
+  }
+  printf("%s %u\n", record->groupName, record->vlanID);
+  return 0;
 }
 
+int print_all_vlanId_Configuration(void)
+{
+  vlan_hal_cursor_t cursor = VLAN_HAL_CURSOR_INIT;
+
+  vlan_hal_walkGroups(&cursor, 0, vlan_hal_print_config_record, NULL);
+  return RETURN_OK;
+}
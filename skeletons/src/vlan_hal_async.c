@@ -0,0 +1,454 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <net/if.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+
+/*
+ * A serial offload queue: one worker thread waits in epoll on gSubmitFd,
+ * runs queued operations through the synchronous API in submission order,
+ * and completes each one by calling its callback or queueing it for
+ * vlan_hal_async_reap(). It takes the calls off the submitter's thread but
+ * does not overlap them. Every mutating call holds the registry write lock
+ * across its backend call, so a pool of workers would only queue on that
+ * lock, and would give up the submission order callers rely on.
+ */
+
+typedef enum
+{
+  VLAN_HAL_ASYNC_ADD_GROUP = 0,
+  VLAN_HAL_ASYNC_DEL_GROUP,
+  VLAN_HAL_ASYNC_ADD_INTERFACE,
+  VLAN_HAL_ASYNC_DEL_INTERFACE,
+  VLAN_HAL_ASYNC_DEL_ALL_INTERFACES
+} vlan_hal_async_op_t;
+
+typedef struct vlan_hal_async_job_s
+{
+  struct vlan_hal_async_job_s *next;
+  vlan_hal_async_op_t op;
+  char groupName[IFNAMSIZ];
+  char ifName[IFNAMSIZ];
+  char vlanID[8];
+  vlan_hal_async_fn done;
+  void *ctx;
+  int result;
+} vlan_hal_async_job_t;
+
+typedef struct
+{
+  vlan_hal_async_job_t *head;
+  vlan_hal_async_job_t *tail;
+} vlan_hal_async_queue_t;
+
+static pthread_mutex_t gAsyncLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gAsyncIdle = PTHREAD_COND_INITIALIZER;
+static pthread_t gWorker;
+static int gRunning = 0;
+static int gStopping = 0;
+/* The worker could not wait for submissions and has exited, submissions fail until vlan_hal_async_stop() */
+static int gBroken = 0;
+static int gEpollFd = -1;
+static int gSubmitFd = -1;
+static int gCompleteFd = -1;
+static vlan_hal_async_queue_t gSubmitted;
+static vlan_hal_async_queue_t gCompleted;
+/* Submitted but not yet completed, vlan_hal_async_drain() waits for 0 */
+static unsigned int gInFlight = 0;
+
+static void vlan_hal_async_push(vlan_hal_async_queue_t *queue, vlan_hal_async_job_t *job)
+{
+  job->next = NULL;
+  if (queue->tail != NULL)
+  {
+    queue->tail->next = job;
+  }
+  else
+  {
+    queue->head = job;
+  }
+  queue->tail = job;
+}
+
+static vlan_hal_async_job_t *vlan_hal_async_pop(vlan_hal_async_queue_t *queue)
+{
+  vlan_hal_async_job_t *job = queue->head;
+
+  if (job != NULL)
+  {
+    queue->head = job->next;
+    if (queue->head == NULL)
+    {
+      queue->tail = NULL;
+    }
+  }
+  return job;
+}
+
+static void vlan_hal_async_signal(int fd)
+{
+  uint64_t one = 1;
+
+  /* Only fails if the counter would overflow, in which case the fd is readable anyway */
+  (void)!write(fd, &one, sizeof(one));
+}
+
+static void vlan_hal_async_clear(int fd)
+{
+  uint64_t count;
+
+  (void)!read(fd, &count, sizeof(count));
+}
+
+static int vlan_hal_async_run(const vlan_hal_async_job_t *job)
+{
+  switch (job->op)
+  {
+    case VLAN_HAL_ASYNC_ADD_GROUP:
+      return vlan_hal_addGroup(job->groupName, job->vlanID);
+    case VLAN_HAL_ASYNC_DEL_GROUP:
+      return vlan_hal_delGroup(job->groupName);
+    case VLAN_HAL_ASYNC_ADD_INTERFACE:
+      return vlan_hal_addInterface(job->groupName, job->ifName, job->vlanID);
+    case VLAN_HAL_ASYNC_DEL_INTERFACE:
+      return vlan_hal_delInterface(job->groupName, job->ifName, job->vlanID);
+    case VLAN_HAL_ASYNC_DEL_ALL_INTERFACES:
+      return vlan_hal_delete_all_Interfaces(job->groupName);
+  }
+  return RETURN_ERR;
+}
+
+static void vlan_hal_async_complete(vlan_hal_async_job_t *job)
+{
+  if (job->done != NULL)
+  {
+    job->done(job->ctx, job->result);
+    free(job);
+    pthread_mutex_lock(&gAsyncLock);
+  }
+  else
+  {
+    pthread_mutex_lock(&gAsyncLock);
+    vlan_hal_async_push(&gCompleted, job);
+    vlan_hal_async_signal(gCompleteFd);
+  }
+  if (--gInFlight == 0)
+  {
+    pthread_cond_broadcast(&gAsyncIdle);
+  }
+  pthread_mutex_unlock(&gAsyncLock);
+}
+
+/* Fails everything still queued, so vlan_hal_async_drain() does not wait for a worker that has gone */
+static void vlan_hal_async_fail_queued(void)
+{
+  vlan_hal_async_queue_t queued;
+  vlan_hal_async_job_t *job;
+
+  pthread_mutex_lock(&gAsyncLock);
+  gBroken = 1;
+  queued = gSubmitted;
+  gSubmitted.head = NULL;
+  gSubmitted.tail = NULL;
+  pthread_mutex_unlock(&gAsyncLock);
+
+  while ((job = vlan_hal_async_pop(&queued)) != NULL)
+  {
+    job->result = RETURN_ERR;
+    vlan_hal_async_complete(job);
+  }
+}
+
+static void *vlan_hal_async_worker(void *arg)
+{
+  struct epoll_event event;
+  vlan_hal_async_queue_t batch;
+  vlan_hal_async_job_t *job;
+  int stopping;
+
+  (void)arg;
+  for (;;)
+  {
+    if ((epoll_wait(gEpollFd, &event, 1, -1) < 0) && (errno != EINTR))
+    {
+      vlan_hal_async_fail_queued();
+      break;
+    }
+    vlan_hal_async_clear(gSubmitFd);
+
+    pthread_mutex_lock(&gAsyncLock);
+    batch = gSubmitted;
+    gSubmitted.head = NULL;
+    gSubmitted.tail = NULL;
+    stopping = gStopping;
+    pthread_mutex_unlock(&gAsyncLock);
+
+    while ((job = vlan_hal_async_pop(&batch)) != NULL)
+    {
+      job->result = vlan_hal_async_run(job);
+      vlan_hal_async_complete(job);
+    }
+    /* Stop is only requested once the queue has drained */
+    if (stopping)
+    {
+      break;
+    }
+  }
+  return NULL;
+}
+
+static void vlan_hal_async_close_fds(void)
+{
+  if (gEpollFd >= 0)
+  {
+    close(gEpollFd);
+    gEpollFd = -1;
+  }
+  if (gSubmitFd >= 0)
+  {
+    close(gSubmitFd);
+    gSubmitFd = -1;
+  }
+  if (gCompleteFd >= 0)
+  {
+    close(gCompleteFd);
+    gCompleteFd = -1;
+  }
+}
+
+/* Called with gAsyncLock held */
+static int vlan_hal_async_start_locked(void)
+{
+  struct epoll_event event;
+
+  if (gRunning)
+  {
+    return 0;
+  }
+  gEpollFd = epoll_create1(EPOLL_CLOEXEC);
+  gSubmitFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  gCompleteFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if ((gEpollFd < 0) || (gSubmitFd < 0) || (gCompleteFd < 0))
+  {
+    vlan_hal_async_close_fds();
+    return -1;
+  }
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  if ((epoll_ctl(gEpollFd, EPOLL_CTL_ADD, gSubmitFd, &event) != 0) ||
+      (pthread_create(&gWorker, NULL, vlan_hal_async_worker, NULL) != 0))
+  {
+    vlan_hal_async_close_fds();
+    return -1;
+  }
+  gStopping = 0;
+  gRunning = 1;
+  return 0;
+}
+
+int vlan_hal_async_start(void)
+{
+  int ret;
+
+  pthread_mutex_lock(&gAsyncLock);
+  ret = vlan_hal_async_start_locked();
+  pthread_mutex_unlock(&gAsyncLock);
+  return (ret == 0) ? RETURN_OK : RETURN_ERR;
+}
+
+int vlan_hal_async_fd(void)
+{
+  int fd;
+
+  pthread_mutex_lock(&gAsyncLock);
+  fd = (vlan_hal_async_start_locked() == 0) ? gCompleteFd : -1;
+  pthread_mutex_unlock(&gAsyncLock);
+  return fd;
+}
+
+void vlan_hal_async_drain(void)
+{
+  pthread_mutex_lock(&gAsyncLock);
+  while (gInFlight != 0)
+  {
+    pthread_cond_wait(&gAsyncIdle, &gAsyncLock);
+  }
+  pthread_mutex_unlock(&gAsyncLock);
+}
+
+void vlan_hal_async_stop(void)
+{
+  vlan_hal_async_job_t *job;
+
+  vlan_hal_async_drain();
+  pthread_mutex_lock(&gAsyncLock);
+  if (!gRunning)
+  {
+    pthread_mutex_unlock(&gAsyncLock);
+    return;
+  }
+  gStopping = 1;
+  vlan_hal_async_signal(gSubmitFd);
+  pthread_mutex_unlock(&gAsyncLock);
+
+  pthread_join(gWorker, NULL);
+
+  pthread_mutex_lock(&gAsyncLock);
+  while ((job = vlan_hal_async_pop(&gCompleted)) != NULL)
+  {
+    free(job);
+  }
+  vlan_hal_async_close_fds();
+  gRunning = 0;
+  gBroken = 0;
+  pthread_mutex_unlock(&gAsyncLock);
+}
+
+unsigned int vlan_hal_async_reap(vlan_hal_completion_t *completions, unsigned int capacity)
+{
+  vlan_hal_async_job_t *job;
+  unsigned int count = 0;
+
+  if ((completions == NULL) || (capacity == 0))
+  {
+    return 0;
+  }
+  pthread_mutex_lock(&gAsyncLock);
+  if (gCompleteFd >= 0)
+  {
+    vlan_hal_async_clear(gCompleteFd);
+  }
+  while ((count < capacity) && ((job = vlan_hal_async_pop(&gCompleted)) != NULL))
+  {
+    completions[count].ctx = job->ctx;
+    completions[count].result = job->result;
+    count++;
+    free(job);
+  }
+  /* Leave the fd readable while completions remain */
+  if ((gCompleted.head != NULL) && (gCompleteFd >= 0))
+  {
+    vlan_hal_async_signal(gCompleteFd);
+  }
+  pthread_mutex_unlock(&gAsyncLock);
+  return count;
+}
+
+static int vlan_hal_async_copy(char *to, size_t size, const char *from)
+{
+  size_t length;
+
+  if (from == NULL)
+  {
+    return -1;
+  }
+  length = strlen(from);
+  if (length >= size)
+  {
+    return -1;
+  }
+  memcpy(to, from, length + 1);
+  return 0;
+}
+
+static int vlan_hal_async_submit(vlan_hal_async_op_t op, const char *groupName, const char *ifName, const char *vlanID,
+                                 vlan_hal_async_fn done, void *ctx)
+{
+  vlan_hal_async_job_t *job = calloc(1, sizeof(vlan_hal_async_job_t));
+
+  if (job == NULL)
+  {
+    return RETURN_ERR;
+  }
+  /* Arguments too long for the synchronous call are rejected now rather than on completion */
+  if ((vlan_hal_async_copy(job->groupName, sizeof(job->groupName), groupName) != 0) ||
+      ((ifName != NULL) && (vlan_hal_async_copy(job->ifName, sizeof(job->ifName), ifName) != 0)) ||
+      ((vlanID != NULL) && (vlan_hal_async_copy(job->vlanID, sizeof(job->vlanID), vlanID) != 0)))
+  {
+    free(job);
+    return RETURN_ERR;
+  }
+  job->op = op;
+  job->done = done;
+  job->ctx = ctx;
+
+  pthread_mutex_lock(&gAsyncLock);
+  if ((vlan_hal_async_start_locked() != 0) || gStopping || gBroken)
+  {
+    pthread_mutex_unlock(&gAsyncLock);
+    free(job);
+    return RETURN_ERR;
+  }
+  /* The worker takes the whole queue at once, so only the first submission into an empty one wakes it */
+  if (gSubmitted.head == NULL)
+  {
+    vlan_hal_async_signal(gSubmitFd);
+  }
+  vlan_hal_async_push(&gSubmitted, job);
+  gInFlight++;
+  pthread_mutex_unlock(&gAsyncLock);
+  return RETURN_OK;
+}
+
+int vlan_hal_addGroup_async(const char *groupName, const char *vlanID, vlan_hal_async_fn done, void *ctx)
+{
+  if (vlanID == NULL)
+  {
+    return RETURN_ERR;
+  }
+  return vlan_hal_async_submit(VLAN_HAL_ASYNC_ADD_GROUP, groupName, NULL, vlanID, done, ctx);
+}
+
+int vlan_hal_delGroup_async(const char *groupName, vlan_hal_async_fn done, void *ctx)
+{
+  return vlan_hal_async_submit(VLAN_HAL_ASYNC_DEL_GROUP, groupName, NULL, NULL, done, ctx);
+}
+
+int vlan_hal_addInterface_async(const char *groupName, const char *ifName, const char *vlanID,
+                                vlan_hal_async_fn done, void *ctx)
+{
+  if ((ifName == NULL) || (vlanID == NULL))
+  {
+    return RETURN_ERR;
+  }
+  return vlan_hal_async_submit(VLAN_HAL_ASYNC_ADD_INTERFACE, groupName, ifName, vlanID, done, ctx);
+}
+
+int vlan_hal_delInterface_async(const char *groupName, const char *ifName, const char *vlanID,
+                                vlan_hal_async_fn done, void *ctx)
+{
+  if ((ifName == NULL) || (vlanID == NULL))
+  {
+    return RETURN_ERR;
+  }
+  return vlan_hal_async_submit(VLAN_HAL_ASYNC_DEL_INTERFACE, groupName, ifName, vlanID, done, ctx);
+}
+
+int vlan_hal_delete_all_Interfaces_async(const char *groupName, vlan_hal_async_fn done, void *ctx)
+{
+  return vlan_hal_async_submit(VLAN_HAL_ASYNC_DEL_ALL_INTERFACES, groupName, NULL, NULL, done, ctx);
+}
@@ -0,0 +1,667 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <net/if.h>
+#include "vlan_hal_backend.h"
+#include "vlan_hal_ip_batch.h"
+#include "vlan_hal_link_cache.h"
+#include "vlan_hal_netlink.h"
+#include "vlan_hal_sysfs.h"
+
+static const vlan_hal_backend_t *gBackend = NULL;
+static vlan_netlink_t gNetlink = { -1, 0 };
+/* Pending commands of the "ip" backend, shared by writers and the existence checks */
+static pthread_mutex_t gIpLock = PTHREAD_MUTEX_INITIALIZER;
+static vlan_ip_batch_t gIpBatch;
+static int gIpReady = 0;
+/* Wakes the flush thread, on CLOCK_MONOTONIC like the batch deadline */
+static pthread_cond_t gIpWake;
+/* Deadline the flush thread sleeps until, 0 while it waits for commands */
+static uint64_t gIpArmedNs = 0;
+
+/* Existence answers of the kernel backends, opened on the first query. Hits take no lock */
+static pthread_mutex_t gLinkCacheLock = PTHREAD_MUTEX_INITIALIZER;
+static vlan_link_cache_t gLinkCache = { -1, 0, 0, 0, 0, { { 0 } } };
+static int gLinkCacheReady = 0;
+
+static void vlan_hal_ip_exit(void);
+
+int vlan_hal_backend_port_name(const char *ifName, uint16_t vlanID, char *portName, size_t size)
+{
+  int written;
+
+  if (size > IFNAMSIZ)
+  {
+    size = IFNAMSIZ;
+  }
+  written = snprintf(portName, size, "%s.%u", ifName, vlanID);
+  if ((written < 0) || ((size_t)written >= size))
+  {
+    return -1;
+  }
+  return 0;
+}
+
+void vlan_hal_backend_link_cache_attach(int fd)
+{
+  pthread_mutex_lock(&gLinkCacheLock);
+  vlan_link_cache_close(&gLinkCache);
+  vlan_link_cache_attach(&gLinkCache, fd);
+  __atomic_store_n(&gLinkCacheReady, 1, __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&gLinkCacheLock);
+}
+
+/*
+ * sysfs answers through the link cache. When no notification socket can be
+ * opened the cache stays disabled and every query goes to sysfs.
+ *
+ * A hit costs a poll() and a lock-free probe. gLinkCacheLock is only taken
+ * to apply notifications or to store an answer read on a miss.
+ */
+static int vlan_hal_cached_query(const char *brName, const char *portName)
+{
+  uint32_t generation;
+  int answer;
+
+  if (!__atomic_load_n(&gLinkCacheReady, __ATOMIC_ACQUIRE))
+  {
+    pthread_mutex_lock(&gLinkCacheLock);
+    if (!gLinkCacheReady)
+    {
+      vlan_link_cache_open(&gLinkCache);
+      __atomic_store_n(&gLinkCacheReady, 1, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&gLinkCacheLock);
+  }
+  if (vlan_link_cache_pending(&gLinkCache))
+  {
+    pthread_mutex_lock(&gLinkCacheLock);
+    vlan_link_cache_sync(&gLinkCache);
+    pthread_mutex_unlock(&gLinkCacheLock);
+  }
+  generation = vlan_link_cache_generation(&gLinkCache);
+  answer = vlan_link_cache_get(&gLinkCache, brName, portName);
+  if (answer >= 0)
+  {
+    return answer;
+  }
+
+  answer = (portName != NULL) ? vlan_sysfs_has_port(brName, portName) : vlan_sysfs_has_bridge(brName);
+  pthread_mutex_lock(&gLinkCacheLock);
+  /* A notification applied since the read may be about this very answer */
+  vlan_link_cache_sync(&gLinkCache);
+  if (vlan_link_cache_generation(&gLinkCache) == generation)
+  {
+    vlan_link_cache_put(&gLinkCache, brName, portName, answer);
+  }
+  pthread_mutex_unlock(&gLinkCacheLock);
+  return answer;
+}
+
+static int vlan_hal_cached_has_bridge(const char *brName)
+{
+  return vlan_hal_cached_query(brName, NULL);
+}
+
+static int vlan_hal_cached_has_port(const char *brName, const char *portName)
+{
+  return vlan_hal_cached_query(brName, portName);
+}
+
+/* "none": the registry in vlan_hal.c is the only state */
+
+static int vlan_hal_none_bridge(const char *brName)
+{
+  (void)brName;
+  return 0;
+}
+
+static int vlan_hal_none_port(const char *brName, const char *ifName, uint16_t vlanID)
+{
+  (void)brName;
+  (void)ifName;
+  (void)vlanID;
+  return 0;
+}
+
+const vlan_hal_backend_t vlan_hal_backend_none =
+{
+  "none",
+  vlan_hal_none_bridge,
+  vlan_hal_none_bridge,
+  vlan_hal_none_port,
+  vlan_hal_none_port,
+  NULL,
+  NULL,
+  NULL,
+  NULL
+};
+
+/* "netlink": one NETLINK_ROUTE socket, opened on first use. Existence checks read sysfs through the link cache */
+
+static vlan_netlink_t *vlan_hal_netlink_channel(void)
+{
+  if ((gNetlink.fd < 0) && (vlan_netlink_open(&gNetlink) != 0))
+  {
+    return NULL;
+  }
+  return &gNetlink;
+}
+
+void vlan_hal_backend_netlink_attach(int fd)
+{
+  vlan_netlink_close(&gNetlink);
+  if (fd >= 0)
+  {
+    vlan_netlink_attach(&gNetlink, fd);
+  }
+}
+
+static int vlan_hal_netlink_add_bridge(const char *brName)
+{
+  vlan_netlink_t *nl = vlan_hal_netlink_channel();
+  int ret;
+
+  if (nl == NULL)
+  {
+    return -ENOTCONN;
+  }
+  /* An existing bridge of the same name is adopted, as brctl addbr callers expect */
+  ret = vlan_netlink_add_bridge(nl, brName);
+  if ((ret != 0) && (ret != -EEXIST))
+  {
+    return ret;
+  }
+  return vlan_netlink_set_up(nl, brName, 1);
+}
+
+static int vlan_hal_netlink_del_bridge(const char *brName)
+{
+  vlan_netlink_t *nl = vlan_hal_netlink_channel();
+  int ret;
+
+  if (nl == NULL)
+  {
+    return -ENOTCONN;
+  }
+  ret = vlan_netlink_del_link(nl, brName);
+  return (ret == -ENODEV) ? 0 : ret;
+}
+
+static int vlan_hal_netlink_add_port(const char *brName, const char *ifName, uint16_t vlanID)
+{
+  vlan_netlink_t *nl = vlan_hal_netlink_channel();
+  char portName[IFNAMSIZ];
+  int ret;
+
+  if (nl == NULL)
+  {
+    return -ENOTCONN;
+  }
+  if (vlan_hal_backend_port_name(ifName, vlanID, portName, sizeof(portName)) != 0)
+  {
+    return -ENAMETOOLONG;
+  }
+  ret = vlan_netlink_add_vlan(nl, ifName, vlanID, portName);
+  if ((ret != 0) && (ret != -EEXIST))
+  {
+    return ret;
+  }
+  if ((ret = vlan_netlink_set_up(nl, portName, 1)) != 0)
+  {
+    return ret;
+  }
+  return vlan_netlink_set_master(nl, portName, brName);
+}
+
+static int vlan_hal_netlink_del_port(const char *brName, const char *ifName, uint16_t vlanID)
+{
+  vlan_netlink_t *nl = vlan_hal_netlink_channel();
+  char portName[IFNAMSIZ];
+  int ret;
+
+  (void)brName;
+  if (nl == NULL)
+  {
+    return -ENOTCONN;
+  }
+  if (vlan_hal_backend_port_name(ifName, vlanID, portName, sizeof(portName)) != 0)
+  {
+    return -ENAMETOOLONG;
+  }
+  /* Deleting the VLAN link also removes it from the bridge */
+  ret = vlan_netlink_del_link(nl, portName);
+  return (ret == -ENODEV) ? 0 : ret;
+}
+
+static int vlan_hal_netlink_add_ports(const char *brName, vlan_hal_port_t *ports, int count)
+{
+  vlan_netlink_t *nl = vlan_hal_netlink_channel();
+  vlan_netlink_port_t batch[VLAN_NETLINK_BATCH_MAX - 1];
+  char portNames[VLAN_NETLINK_BATCH_MAX - 1][IFNAMSIZ];
+  int chunk;
+  int done;
+  int used;
+  int ret;
+  int i;
+
+  if (nl == NULL)
+  {
+    return -ENOTCONN;
+  }
+  /* Each chunk costs two round trips (three if some ports already existed) */
+  for (done = 0; done < count; done += chunk)
+  {
+    chunk = count - done;
+    if (chunk > VLAN_NETLINK_BATCH_MAX - 1)
+    {
+      chunk = VLAN_NETLINK_BATCH_MAX - 1;
+    }
+    used = 0;
+    for (i = 0; i < chunk; i++)
+    {
+      vlan_hal_port_t *port = &ports[done + i];
+
+      port->status = 0;
+      if (vlan_hal_backend_port_name(port->ifName, port->vlanID, portNames[used], IFNAMSIZ) != 0)
+      {
+        port->status = -ENAMETOOLONG;
+        continue;
+      }
+      batch[used].ifName = port->ifName;
+      batch[used].vlanIfName = portNames[used];
+      batch[used].vlanID = port->vlanID;
+      batch[used].status = 0;
+      used++;
+    }
+    if (used == 0)
+    {
+      continue;
+    }
+    if ((ret = vlan_netlink_add_vlan_ports(nl, brName, batch, used)) != 0)
+    {
+      return ret;
+    }
+    used = 0;
+    for (i = 0; i < chunk; i++)
+    {
+      if (ports[done + i].status != -ENAMETOOLONG)
+      {
+        ports[done + i].status = batch[used++].status;
+      }
+    }
+  }
+  return 0;
+}
+
+const vlan_hal_backend_t vlan_hal_backend_netlink =
+{
+  "netlink",
+  vlan_hal_netlink_add_bridge,
+  vlan_hal_netlink_del_bridge,
+  vlan_hal_netlink_add_port,
+  vlan_hal_netlink_del_port,
+  vlan_hal_netlink_add_ports,
+  vlan_hal_cached_has_bridge,
+  vlan_hal_cached_has_port,
+  NULL
+};
+
+/*
+ * "ip": operations are queued in one batch and applied by "ip -batch -".
+ * They report success once queued; a flush thread applies them within
+ * maxDelayMs, vlan_hal_commit() flushes them at once, as do existence
+ * checks about a link with pending commands, and whatever is left is
+ * flushed at exit. Bridge removal alone is applied before it returns.
+ *
+ * A command that fails after its call returned has its change undone in
+ * the registry through vlan_hal_backend_failed(), and the next commit
+ * reports the failure. The operations run under the registry write lock,
+ * so failures they run into are handed to the flush thread; commit and the
+ * existence checks undo them themselves once gIpLock is released.
+ */
+
+static void vlan_hal_ip_undo(vlan_ip_batch_owner_t *failed, unsigned int count)
+{
+  unsigned int i;
+
+  for (i = 0; i < count; i++)
+  {
+    vlan_hal_backend_failed((vlan_hal_backend_op_t)failed[i].op, failed[i].brName, failed[i].ifName, failed[i].vlanID);
+  }
+  free(failed);
+}
+
+static void *vlan_hal_ip_flusher(void *arg)
+{
+  vlan_ip_batch_owner_t *failed;
+  struct timespec wake;
+  unsigned int count;
+  uint64_t deadline;
+  int ret;
+
+  (void)arg;
+  pthread_mutex_lock(&gIpLock);
+  for (;;)
+  {
+    deadline = vlan_ip_batch_deadline_ns(&gIpBatch);
+    clock_gettime(CLOCK_MONOTONIC, &wake);
+    if ((deadline != 0) && (deadline <= (uint64_t)wake.tv_sec * 1000000000u + (uint64_t)wake.tv_nsec))
+    {
+      ret = vlan_ip_batch_run(&gIpBatch);
+      if ((ret != 0) && (gIpBatch.error == 0))
+      {
+        gIpBatch.error = ret;
+      }
+      continue;
+    }
+    count = vlan_ip_batch_take_failed(&gIpBatch, &failed);
+    if (count != 0)
+    {
+      pthread_mutex_unlock(&gIpLock);
+      vlan_hal_ip_undo(failed, count);
+      pthread_mutex_lock(&gIpLock);
+      continue;
+    }
+    gIpArmedNs = deadline;
+    if (deadline == 0)
+    {
+      pthread_cond_wait(&gIpWake, &gIpLock);
+    }
+    else
+    {
+      wake.tv_sec = (time_t)(deadline / 1000000000u);
+      wake.tv_nsec = (long)(deadline % 1000000000u);
+      pthread_cond_timedwait(&gIpWake, &gIpLock, &wake);
+    }
+  }
+  return NULL;
+}
+
+static vlan_ip_batch_t *vlan_hal_ip_lock(void)
+{
+  pthread_condattr_t attr;
+  pthread_t thread;
+
+  pthread_mutex_lock(&gIpLock);
+  if (!gIpReady)
+  {
+    vlan_ip_batch_init(&gIpBatch, 0, 0);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&gIpWake, &attr);
+    pthread_condattr_destroy(&attr);
+    /* Without the thread commands wait for the next commit, query or exit */
+    if (pthread_create(&thread, NULL, vlan_hal_ip_flusher, NULL) == 0)
+    {
+      pthread_detach(thread);
+    }
+    atexit(vlan_hal_ip_exit);
+    gIpReady = 1;
+  }
+  return &gIpBatch;
+}
+
+/* Wakes the flush thread when its deadline no longer matches the batch, or failures wait for it */
+static void vlan_hal_ip_unlock(void)
+{
+  if ((vlan_ip_batch_deadline_ns(&gIpBatch) != gIpArmedNs) || (gIpBatch.failedCount != 0))
+  {
+    pthread_cond_signal(&gIpWake);
+  }
+  pthread_mutex_unlock(&gIpLock);
+}
+
+static void vlan_hal_ip_exit(void)
+{
+  /* Nothing is undone at exit, the registry is going away */
+  vlan_ip_batch_flush(vlan_hal_ip_lock());
+  vlan_hal_ip_unlock();
+}
+
+/* Unlocks, then undoes the changes of failed commands; only for callers outside the registry lock */
+static void vlan_hal_ip_unlock_undo(void)
+{
+  vlan_ip_batch_owner_t *failed;
+  unsigned int count;
+
+  count = vlan_ip_batch_take_failed(&gIpBatch, &failed);
+  vlan_hal_ip_unlock();
+  vlan_hal_ip_undo(failed, count);
+}
+
+static void vlan_hal_ip_owner(vlan_ip_batch_owner_t *owner, vlan_hal_backend_op_t op,
+                              const char *brName, const char *ifName, uint16_t vlanID)
+{
+  memset(owner, 0, sizeof(*owner));
+  owner->op = (int)op;
+  snprintf(owner->brName, sizeof(owner->brName), "%s", brName);
+  snprintf(owner->ifName, sizeof(owner->ifName), "%s", (ifName != NULL) ? ifName : "");
+  owner->vlanID = vlanID;
+}
+
+static int vlan_hal_ip_flush(void)
+{
+  int ret;
+
+  ret = vlan_ip_batch_flush(vlan_hal_ip_lock());
+  vlan_hal_ip_unlock_undo();
+  return ret;
+}
+
+int vlan_hal_backend_ip_configure(unsigned int maxCommands, unsigned int maxDelayMs)
+{
+  vlan_ip_batch_t *batch = vlan_hal_ip_lock();
+  int ret;
+
+  ret = vlan_ip_batch_flush(batch);
+  batch->maxCommands = (maxCommands != 0) ? maxCommands : VLAN_IP_BATCH_MAX_COMMANDS;
+  batch->maxDelayMs = (maxDelayMs != 0) ? maxDelayMs : VLAN_IP_BATCH_MAX_DELAY_MS;
+  vlan_hal_ip_unlock_undo();
+  return ret;
+}
+
+static int vlan_hal_ip_add_bridge(const char *brName)
+{
+  vlan_ip_batch_t *batch = vlan_hal_ip_lock();
+  vlan_ip_batch_owner_t owner;
+  int ret;
+
+  vlan_hal_ip_owner(&owner, VLAN_HAL_BACKEND_ADD_BRIDGE, brName, NULL, 0);
+  ret = vlan_ip_batch_queue(batch, &owner, "link add name %s type bridge", brName);
+  if (ret == 0)
+  {
+    ret = vlan_ip_batch_queue(batch, &owner, "link set %s up", brName);
+  }
+  vlan_hal_ip_unlock();
+  return ret;
+}
+
+/*
+ * A group whose bridge could not be removed cannot be put back together
+ * afterwards, so the removal runs now and its own result is returned.
+ * Failures of other commands in the same run are left for the flush thread.
+ */
+static int vlan_hal_ip_del_bridge(const char *brName)
+{
+  vlan_ip_batch_t *batch = vlan_hal_ip_lock();
+  vlan_ip_batch_owner_t owner;
+  int own;
+  int ret;
+
+  vlan_hal_ip_owner(&owner, VLAN_HAL_BACKEND_DEL_BRIDGE, brName, NULL, 0);
+  ret = vlan_ip_batch_queue(batch, &owner, "link del %s", brName);
+  if (ret == 0)
+  {
+    ret = vlan_ip_batch_run(batch);
+    own = vlan_ip_batch_claim_failed(batch, &owner);
+    /* Other commands failed too, the next commit reports them */
+    if ((ret != 0) && (batch->failedCount != 0) && (batch->error == 0))
+    {
+      batch->error = ret;
+    }
+    if (!own)
+    {
+      ret = 0;
+    }
+  }
+  vlan_hal_ip_unlock();
+  return ret;
+}
+
+static int vlan_hal_ip_queue_port(vlan_ip_batch_t *batch, const char *brName, const char *ifName, uint16_t vlanID)
+{
+  vlan_ip_batch_owner_t owner;
+  char portName[IFNAMSIZ];
+  int ret;
+
+  if (vlan_hal_backend_port_name(ifName, vlanID, portName, sizeof(portName)) != 0)
+  {
+    return -ENAMETOOLONG;
+  }
+  vlan_hal_ip_owner(&owner, VLAN_HAL_BACKEND_ADD_PORT, brName, ifName, vlanID);
+  ret = vlan_ip_batch_queue(batch, &owner, "link add link %s name %s type vlan id %u", ifName, portName, vlanID);
+  if (ret == 0)
+  {
+    ret = vlan_ip_batch_queue(batch, &owner, "link set %s master %s up", portName, brName);
+  }
+  return ret;
+}
+
+static int vlan_hal_ip_add_port(const char *brName, const char *ifName, uint16_t vlanID)
+{
+  int ret;
+
+  ret = vlan_hal_ip_queue_port(vlan_hal_ip_lock(), brName, ifName, vlanID);
+  vlan_hal_ip_unlock();
+  return ret;
+}
+
+static int vlan_hal_ip_del_port(const char *brName, const char *ifName, uint16_t vlanID)
+{
+  vlan_ip_batch_owner_t owner;
+  char portName[IFNAMSIZ];
+  int ret;
+
+  if (vlan_hal_backend_port_name(ifName, vlanID, portName, sizeof(portName)) != 0)
+  {
+    return -ENAMETOOLONG;
+  }
+  vlan_hal_ip_owner(&owner, VLAN_HAL_BACKEND_DEL_PORT, brName, ifName, vlanID);
+  ret = vlan_ip_batch_queue(vlan_hal_ip_lock(), &owner, "link del %s", portName);
+  vlan_hal_ip_unlock();
+  return ret;
+}
+
+static int vlan_hal_ip_add_ports(const char *brName, vlan_hal_port_t *ports, int count)
+{
+  vlan_ip_batch_t *batch = vlan_hal_ip_lock();
+  int failed = 0;
+  int i;
+
+  for (i = 0; i < count; i++)
+  {
+    ports[i].status = vlan_hal_ip_queue_port(batch, brName, ports[i].ifName, ports[i].vlanID);
+    failed |= (ports[i].status != 0);
+  }
+  vlan_hal_ip_unlock();
+  return failed ? -EIO : 0;
+}
+
+/*
+ * The system only reflects queued changes once they are flushed, so a query
+ * naming a link with pending commands flushes first. A failure of that flush
+ * is kept for the next vlan_hal_commit().
+ */
+static void vlan_hal_ip_settle(const char *brName, const char *portName)
+{
+  vlan_ip_batch_t *batch = vlan_hal_ip_lock();
+  int ret;
+
+  if (vlan_ip_batch_pending(batch, brName) || ((portName != NULL) && vlan_ip_batch_pending(batch, portName)))
+  {
+    ret = vlan_ip_batch_flush(batch);
+    if (ret != 0)
+    {
+      batch->error = ret;
+    }
+  }
+  vlan_hal_ip_unlock_undo();
+}
+
+static int vlan_hal_ip_has_bridge(const char *brName)
+{
+  vlan_hal_ip_settle(brName, NULL);
+  return vlan_hal_cached_has_bridge(brName);
+}
+
+static int vlan_hal_ip_has_port(const char *brName, const char *portName)
+{
+  vlan_hal_ip_settle(brName, portName);
+  return vlan_hal_cached_has_port(brName, portName);
+}
+
+const vlan_hal_backend_t vlan_hal_backend_ip =
+{
+  "ip",
+  vlan_hal_ip_add_bridge,
+  vlan_hal_ip_del_bridge,
+  vlan_hal_ip_add_port,
+  vlan_hal_ip_del_port,
+  vlan_hal_ip_add_ports,
+  vlan_hal_ip_has_bridge,
+  vlan_hal_ip_has_port,
+  vlan_hal_ip_flush
+};
+
+const vlan_hal_backend_t *vlan_hal_backend_get(void)
+{
+  const vlan_hal_backend_t *backend = __atomic_load_n(&gBackend, __ATOMIC_ACQUIRE);
+  const char *selected;
+
+  if (backend != NULL)
+  {
+    return backend;
+  }
+  /* Threads racing here all select the same backend */
+  selected = getenv(VLAN_HAL_BACKEND_ENV);
+  if ((selected != NULL) && (strcmp(selected, vlan_hal_backend_netlink.name) == 0))
+  {
+    backend = &vlan_hal_backend_netlink;
+  }
+  else if ((selected != NULL) && (strcmp(selected, vlan_hal_backend_ip.name) == 0))
+  {
+    backend = &vlan_hal_backend_ip;
+  }
+  else
+  {
+    backend = &vlan_hal_backend_none;
+  }
+  __atomic_store_n(&gBackend, backend, __ATOMIC_RELEASE);
+  return backend;
+}
+
+void vlan_hal_backend_set(const vlan_hal_backend_t *backend)
+{
+  __atomic_store_n(&gBackend, backend, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,145 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_backend.h
+ *
+ * Kernel-facing operations of the skeleton HAL. vlan_hal.c keeps the group
+ * registry and calls the selected backend to apply each change to the system.
+ *
+ * The backend is chosen from the VLAN_HAL_BACKEND environment variable on
+ * first use:
+ *  - unset or "none": state is kept in memory only, nothing touches the kernel
+ *  - "netlink": bridges and VLAN links are managed over rtnetlink
+ *  - "ip": changes are queued as iproute2 commands and applied in batches by
+ *    one "ip -batch -" process, see vlan_hal_ip_batch.h. A change that then
+ *    fails is undone in the registry through vlan_hal_backend_failed()
+ */
+#ifndef __VLAN_HAL_BACKEND_H__
+#define __VLAN_HAL_BACKEND_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define VLAN_HAL_BACKEND_ENV "VLAN_HAL_BACKEND"
+
+typedef struct
+{
+  const char *ifName;
+  uint16_t vlanID;
+  int status;                   /*!< Out: 0 or negative errno */
+} vlan_hal_port_t;
+
+/**
+ * @brief Backend operations. Each returns 0 on success or a negative errno.
+ *
+ * A port is the 802.1Q sub-interface "<ifName>.<vlanID>" enslaved to the bridge.
+ * add_ports is optional: it applies a whole batch and reports per-port status,
+ * when NULL callers fall back to add_port for each entry.
+ *
+ * has_bridge and has_port are optional queries against the system, returning
+ * 1 if present, 0 if absent or a negative errno. When NULL the HAL answers
+ * from its own registry.
+ *
+ * flush is optional: a backend that defers changes applies everything
+ * pending and reports whether it all succeeded. When NULL every operation
+ * is applied before it returns.
+ */
+typedef struct
+{
+  const char *name;
+  int (*add_bridge)(const char *brName);
+  int (*del_bridge)(const char *brName);
+  int (*add_port)(const char *brName, const char *ifName, uint16_t vlanID);
+  int (*del_port)(const char *brName, const char *ifName, uint16_t vlanID);
+  int (*add_ports)(const char *brName, vlan_hal_port_t *ports, int count);
+  int (*has_bridge)(const char *brName);
+  int (*has_port)(const char *brName, const char *portName);
+  int (*flush)(void);
+} vlan_hal_backend_t;
+
+/* A change a deferring backend reported as done and then failed to apply */
+typedef enum
+{
+  VLAN_HAL_BACKEND_ADD_BRIDGE = 1,
+  VLAN_HAL_BACKEND_DEL_BRIDGE,
+  VLAN_HAL_BACKEND_ADD_PORT,
+  VLAN_HAL_BACKEND_DEL_PORT
+} vlan_hal_backend_op_t;
+
+extern const vlan_hal_backend_t vlan_hal_backend_none;
+extern const vlan_hal_backend_t vlan_hal_backend_netlink;
+extern const vlan_hal_backend_t vlan_hal_backend_ip;
+
+/**
+ * @brief Return the active backend, selecting it from the environment on first call.
+ */
+const vlan_hal_backend_t *vlan_hal_backend_get(void);
+
+/**
+ * @brief Override the active backend, NULL restores selection from the environment.
+ */
+void vlan_hal_backend_set(const vlan_hal_backend_t *backend);
+
+/**
+ * @brief Make the netlink backend use @p fd instead of opening a NETLINK_ROUTE socket.
+ *
+ * Lets tests drive the backend against a fake peer on a socketpair. Ownership
+ * of @p fd passes to the backend; a negative value closes the current channel.
+ */
+void vlan_hal_backend_netlink_attach(int fd);
+
+/**
+ * @brief Make the existence checks of the netlink and ip backends take link notifications from @p fd.
+ *
+ * By default they subscribe a NETLINK_ROUTE socket to RTNLGRP_LINK on first
+ * use, see vlan_hal_link_cache.h. Lets tests simulate the notification
+ * stream over a SOCK_SEQPACKET socketpair; a negative value disables caching.
+ * Ownership of @p fd passes to the backend.
+ */
+void vlan_hal_backend_link_cache_attach(int fd);
+
+/**
+ * @brief Set the flush thresholds of the ip backend, 0 selects the default for either.
+ *
+ * Pending commands are flushed first.
+ *
+ * @return 0 on success, or the error of that flush.
+ */
+int vlan_hal_backend_ip_configure(unsigned int maxCommands, unsigned int maxDelayMs);
+
+/**
+ * @brief Undo the registry side of a change the backend failed to apply, implemented by vlan_hal.c.
+ *
+ * A failed bridge releases its group, a failed port leaves the index and a
+ * failed port removal puts the port back. The registry may have moved on
+ * since, so each undo only applies while the registry still matches.
+ *
+ * Takes the registry write lock: a backend calls it with none of its own
+ * locks held and never from inside one of its operations.
+ */
+void vlan_hal_backend_failed(vlan_hal_backend_op_t op, const char *brName, const char *ifName, uint16_t vlanID);
+
+/**
+ * @brief Build the VLAN sub-interface name "<ifName>.<vlanID>".
+ *
+ * @return 0 on success, -1 if the result does not fit in IFNAMSIZ.
+ */
+int vlan_hal_backend_port_name(const char *ifName, uint16_t vlanID, char *portName, size_t size);
+
+#endif /* __VLAN_HAL_BACKEND_H__ */
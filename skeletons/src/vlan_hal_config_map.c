@@ -0,0 +1,356 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "vlan_hal_group_table.h"
+#include "vlan_hal_config_map.h"
+
+#define VLAN_CONFIG_MAP_SIZE (sizeof(vlan_config_map_header_t) + (VLAN_CONFIG_MAP_SLOTS * sizeof(vlan_config_map_slot_t)))
+/* Attempts before a reader gives up on a writer that never finishes its update */
+#define VLAN_CONFIG_MAP_LOOKUP_RETRIES 1000
+
+static int vlan_config_map_attach(vlan_config_map_t *map, int fd, int writable)
+{
+  void *base = mmap(NULL, VLAN_CONFIG_MAP_SIZE, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+
+  if (base == MAP_FAILED)
+  {
+    return -errno;
+  }
+  map->header = base;
+  map->slots = (vlan_config_map_slot_t *)((uint8_t *)base + sizeof(vlan_config_map_header_t));
+  map->size = VLAN_CONFIG_MAP_SIZE;
+  map->writable = writable;
+  return 0;
+}
+
+int vlan_config_map_create(vlan_config_map_t *map, const char *path)
+{
+  char tmpPath[4096];
+  int fd;
+  int ret;
+
+  if ((map == NULL) || (path == NULL))
+  {
+    return -EINVAL;
+  }
+  if (snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path) >= (int)sizeof(tmpPath))
+  {
+    return -ENAMETOOLONG;
+  }
+  fd = open(tmpPath, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0)
+  {
+    return -errno;
+  }
+  /* A fresh file reads as zeroes: every slot empty, seq even */
+  if (ftruncate(fd, (off_t)VLAN_CONFIG_MAP_SIZE) != 0)
+  {
+    ret = -errno;
+  }
+  else
+  {
+    ret = vlan_config_map_attach(map, fd, 1);
+  }
+  close(fd);
+  if (ret == 0)
+  {
+    memcpy(map->header->magic, VLAN_CONFIG_MAP_MAGIC, sizeof(map->header->magic));
+    map->header->slots = VLAN_CONFIG_MAP_SLOTS;
+    if (rename(tmpPath, path) != 0)
+    {
+      ret = -errno;
+      vlan_config_map_close(map);
+    }
+  }
+  if (ret != 0)
+  {
+    unlink(tmpPath);
+  }
+  return ret;
+}
+
+int vlan_config_map_open(vlan_config_map_t *map, const char *path)
+{
+  struct stat st;
+  int fd;
+  int ret;
+
+  if ((map == NULL) || (path == NULL))
+  {
+    return -EINVAL;
+  }
+  fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    return -errno;
+  }
+  if (fstat(fd, &st) != 0)
+  {
+    ret = -errno;
+  }
+  else if ((size_t)st.st_size != VLAN_CONFIG_MAP_SIZE)
+  {
+    ret = -EINVAL;
+  }
+  else
+  {
+    ret = vlan_config_map_attach(map, fd, 0);
+  }
+  close(fd);
+  if ((ret == 0) &&
+      ((memcmp(map->header->magic, VLAN_CONFIG_MAP_MAGIC, sizeof(map->header->magic)) != 0) ||
+       (map->header->slots != VLAN_CONFIG_MAP_SLOTS)))
+  {
+    vlan_config_map_close(map);
+    ret = -EINVAL;
+  }
+  return ret;
+}
+
+void vlan_config_map_close(vlan_config_map_t *map)
+{
+  if ((map == NULL) || (map->header == NULL))
+  {
+    return;
+  }
+  munmap(map->header, map->size);
+  map->header = NULL;
+  map->slots = NULL;
+  map->size = 0;
+}
+
+/* Writer side of the sequence counter: odd from begin to end */
+static void vlan_config_map_begin(vlan_config_map_header_t *header)
+{
+  __atomic_store_n(&header->seq, header->seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void vlan_config_map_end(vlan_config_map_header_t *header)
+{
+  __atomic_store_n(&header->seq, header->seq + 1, __ATOMIC_RELEASE);
+}
+
+/* Same probing scheme as the group table: match, else first reusable slot */
+static vlan_config_map_slot_t *vlan_config_map_probe(const vlan_config_map_t *map, const char *name, uint32_t hash)
+{
+  uint32_t mask = VLAN_CONFIG_MAP_SLOTS - 1;
+  uint32_t index = hash & mask;
+  vlan_config_map_slot_t *reuse = NULL;
+  vlan_config_map_slot_t *slot;
+  uint32_t probes;
+
+  for (probes = 0; probes < VLAN_CONFIG_MAP_SLOTS; probes++)
+  {
+    slot = &map->slots[index];
+    if (slot->state == VLAN_GROUP_SLOT_EMPTY)
+    {
+      return (reuse != NULL) ? reuse : slot;
+    }
+    if (slot->state == VLAN_GROUP_SLOT_DELETED)
+    {
+      if (reuse == NULL)
+      {
+        reuse = slot;
+      }
+    }
+    else if ((slot->hash == hash) && (strncmp(slot->name, name, IFNAMSIZ) == 0))
+    {
+      return slot;
+    }
+    index = (index + 1) & mask;
+  }
+  return reuse;
+}
+
+/* Reinserts live slots so tombstones stop lengthening probes, called inside a write section */
+static int vlan_config_map_sweep(vlan_config_map_t *map)
+{
+  vlan_config_map_slot_t *live = malloc(map->header->count * sizeof(*live));
+  uint32_t used = 0;
+  uint32_t i;
+
+  if ((live == NULL) && (map->header->count > 0))
+  {
+    return -1;
+  }
+  for (i = 0; i < VLAN_CONFIG_MAP_SLOTS; i++)
+  {
+    if (map->slots[i].state == VLAN_GROUP_SLOT_USED)
+    {
+      live[used++] = map->slots[i];
+    }
+  }
+  memset(map->slots, 0, VLAN_CONFIG_MAP_SLOTS * sizeof(*map->slots));
+  for (i = 0; i < used; i++)
+  {
+    *vlan_config_map_probe(map, live[i].name, live[i].hash) = live[i];
+  }
+  map->header->tombstones = 0;
+  free(live);
+  return 0;
+}
+
+int vlan_config_map_put(vlan_config_map_t *map, const char *name, uint16_t vlanID)
+{
+  vlan_config_map_slot_t *slot;
+  uint32_t hash;
+  size_t length;
+  int ret = 0;
+
+  if ((map == NULL) || (map->header == NULL) || !map->writable || (name == NULL))
+  {
+    return -1;
+  }
+  length = strlen(name);
+  if ((length == 0) || (length >= IFNAMSIZ))
+  {
+    return -1;
+  }
+  hash = vlan_group_table_hash(name);
+
+  vlan_config_map_begin(map->header);
+  slot = vlan_config_map_probe(map, name, hash);
+  if ((slot != NULL) && (slot->state != VLAN_GROUP_SLOT_USED) &&
+      ((map->header->count + map->header->tombstones + 1) > (VLAN_CONFIG_MAP_SLOTS / 4) * 3))
+  {
+    /* Sweep tombstones, but never let live entries pass 3/4 of the fixed slots */
+    if (((map->header->count + 1) > (VLAN_CONFIG_MAP_SLOTS / 4) * 3) || (vlan_config_map_sweep(map) != 0))
+    {
+      slot = NULL;
+    }
+    else
+    {
+      slot = vlan_config_map_probe(map, name, hash);
+    }
+  }
+  if (slot == NULL)
+  {
+    ret = -1;
+  }
+  else if (slot->state == VLAN_GROUP_SLOT_USED)
+  {
+    slot->vlanID = vlanID;
+  }
+  else
+  {
+    if (slot->state == VLAN_GROUP_SLOT_DELETED)
+    {
+      map->header->tombstones--;
+    }
+    memset(slot->name, 0, sizeof(slot->name));
+    memcpy(slot->name, name, length);
+    slot->hash = hash;
+    slot->vlanID = vlanID;
+    slot->state = VLAN_GROUP_SLOT_USED;
+    map->header->count++;
+  }
+  vlan_config_map_end(map->header);
+  return ret;
+}
+
+int vlan_config_map_del(vlan_config_map_t *map, const char *name)
+{
+  vlan_config_map_slot_t *slot;
+  int ret = -1;
+
+  if ((map == NULL) || (map->header == NULL) || !map->writable || (name == NULL))
+  {
+    return -1;
+  }
+  vlan_config_map_begin(map->header);
+  slot = vlan_config_map_probe(map, name, vlan_group_table_hash(name));
+  if ((slot != NULL) && (slot->state == VLAN_GROUP_SLOT_USED))
+  {
+    slot->state = VLAN_GROUP_SLOT_DELETED;
+    map->header->count--;
+    map->header->tombstones++;
+    ret = 0;
+  }
+  vlan_config_map_end(map->header);
+  return ret;
+}
+
+int vlan_config_map_lookup(const vlan_config_map_t *map, const char *name, uint16_t *vlanID)
+{
+  uint32_t hash;
+  uint32_t before;
+  uint32_t mask = VLAN_CONFIG_MAP_SLOTS - 1;
+  int attempt;
+
+  if ((map == NULL) || (map->header == NULL) || (name == NULL) || (vlanID == NULL))
+  {
+    return -1;
+  }
+  hash = vlan_group_table_hash(name);
+
+  for (attempt = 0; attempt < VLAN_CONFIG_MAP_LOOKUP_RETRIES; attempt++)
+  {
+    uint32_t index = hash & mask;
+    uint32_t probes;
+    int found = -1;
+    uint16_t value = 0;
+
+    if (attempt > 0)
+    {
+      /* Let the writer finish instead of spinning against it */
+      sched_yield();
+    }
+    before = __atomic_load_n(&map->header->seq, __ATOMIC_ACQUIRE);
+    if (before & 1)
+    {
+      continue;
+    }
+    /* Slots may change under us; the sequence check below discards such reads */
+    for (probes = 0; probes < VLAN_CONFIG_MAP_SLOTS; probes++)
+    {
+      const vlan_config_map_slot_t *slot = &map->slots[index];
+      uint8_t state = slot->state;
+
+      if (state == VLAN_GROUP_SLOT_EMPTY)
+      {
+        break;
+      }
+      if ((state == VLAN_GROUP_SLOT_USED) && (slot->hash == hash) && (strncmp(slot->name, name, IFNAMSIZ) == 0))
+      {
+        value = slot->vlanID;
+        found = 0;
+        break;
+      }
+      index = (index + 1) & mask;
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&map->header->seq, __ATOMIC_RELAXED) == before)
+    {
+      if (found == 0)
+      {
+        *vlanID = value;
+      }
+      return found;
+    }
+  }
+  return -EAGAIN;
+}
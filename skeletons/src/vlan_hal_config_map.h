@@ -0,0 +1,113 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_config_map.h
+ *
+ * Fixed-layout, memory-mapped copy of the group to VLAN table, so processes
+ * other than the HAL can resolve a group's VLAN without IPC or parsing.
+ *
+ * The file is a header followed by VLAN_CONFIG_MAP_SLOTS open-addressing
+ * slots, probed linearly from the name hash (vlan_group_table_hash()). A
+ * single writer (the HAL) updates it in place under a sequence counter:
+ * the counter is odd while an update is in progress, and readers retry a
+ * lookup whenever it was odd or changed while they read, up to a bound.
+ *
+ * The writer creates the file under a temporary name and renames it into
+ * place, so readers never map a partially initialised file. A reader that
+ * mapped a previous file keeps seeing it until it reopens.
+ */
+#ifndef __VLAN_HAL_CONFIG_MAP_H__
+#define __VLAN_HAL_CONFIG_MAP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <net/if.h>
+
+#define VLAN_CONFIG_MAP_MAGIC "VLANMAP1"
+/* Twice the 4094 groups the VLAN ID space allows, keeping probes short */
+#define VLAN_CONFIG_MAP_SLOTS 8192
+
+typedef struct
+{
+  char magic[8];
+  uint32_t slots;
+  uint32_t seq;                 /*!< Odd while the writer is updating */
+  uint32_t count;
+  uint32_t tombstones;
+} vlan_config_map_header_t;
+
+typedef struct
+{
+  uint32_t hash;
+  uint16_t vlanID;
+  uint8_t state;                /*!< vlan_group_slot_state_t */
+  uint8_t reserved;
+  char name[IFNAMSIZ];
+} vlan_config_map_slot_t;
+
+typedef struct
+{
+  vlan_config_map_header_t *header;
+  vlan_config_map_slot_t *slots;
+  size_t size;
+  int writable;
+} vlan_config_map_t;
+
+/**
+ * @brief Create an empty map at @p path and map it for writing.
+ *
+ * @return 0 on success, negative errno on failure.
+ */
+int vlan_config_map_create(vlan_config_map_t *map, const char *path);
+
+/**
+ * @brief Map an existing file at @p path read-only.
+ *
+ * @return 0 on success, -EINVAL if the file is not a map, negative errno otherwise.
+ */
+int vlan_config_map_open(vlan_config_map_t *map, const char *path);
+
+void vlan_config_map_close(vlan_config_map_t *map);
+
+/**
+ * @brief Writer: set @p name to @p vlanID.
+ *
+ * @return 0 on success, -1 on an invalid name, a read-only map or a full map.
+ */
+int vlan_config_map_put(vlan_config_map_t *map, const char *name, uint16_t vlanID);
+
+/**
+ * @brief Writer: remove @p name.
+ *
+ * @return 0 if removed, -1 if not present or the map is read-only.
+ */
+int vlan_config_map_del(vlan_config_map_t *map, const char *name);
+
+/**
+ * @brief Look up @p name, consistent with respect to concurrent writer updates.
+ *
+ * A read that overlaps an update is retried a bounded number of times, so a
+ * writer that stalls or dies mid-update cannot hang the reader.
+ *
+ * @return 0 and @p vlanID set if found, -1 if not present, -EAGAIN if no
+ *         consistent read could be made.
+ */
+int vlan_config_map_lookup(const vlan_config_map_t *map, const char *name, uint16_t *vlanID);
+
+#endif /* __VLAN_HAL_CONFIG_MAP_H__ */
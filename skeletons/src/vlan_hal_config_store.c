@@ -0,0 +1,410 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <libgen.h>
+#include <sys/stat.h>
+#include "vlan_hal_config_store.h"
+
+#define VLAN_CONFIG_MAGIC "VLANLOG1"
+#define VLAN_CONFIG_MAGIC_SIZE 8
+
+/*
+ * On-disk record, native byte order:
+ *   crc32 (4) | op (1) | name length (1) | vlanID (2) | name, NUL padded (IFNAMSIZ)
+ * The CRC covers everything after it.
+ */
+#define VLAN_CONFIG_RECORD_SIZE (8 + IFNAMSIZ)
+#define VLAN_CONFIG_READ_RECORDS 64
+
+static uint32_t vlan_config_crc32(const uint8_t *data, size_t length)
+{
+  uint32_t crc = 0xFFFFFFFFu;
+  int bit;
+
+  while (length-- > 0)
+  {
+    crc ^= *data++;
+    for (bit = 0; bit < 8; bit++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+static void vlan_config_encode(uint8_t *record, vlan_config_op_t op, const char *name, size_t length, uint16_t vlanID)
+{
+  uint32_t crc;
+
+  memset(record, 0, VLAN_CONFIG_RECORD_SIZE);
+  record[4] = (uint8_t)op;
+  record[5] = (uint8_t)length;
+  memcpy(&record[6], &vlanID, sizeof(vlanID));
+  memcpy(&record[8], name, length);
+  crc = vlan_config_crc32(&record[4], VLAN_CONFIG_RECORD_SIZE - 4);
+  memcpy(record, &crc, sizeof(crc));
+}
+
+/* Returns 0 and fills the outputs for a well-formed record, -1 otherwise */
+static int vlan_config_decode(const uint8_t *record, vlan_config_op_t *op, const char **name, uint16_t *vlanID)
+{
+  uint32_t crc;
+
+  memcpy(&crc, record, sizeof(crc));
+  if (crc != vlan_config_crc32(&record[4], VLAN_CONFIG_RECORD_SIZE - 4))
+  {
+    return -1;
+  }
+  if (((record[4] != VLAN_CONFIG_OP_PUT) && (record[4] != VLAN_CONFIG_OP_DEL)) ||
+      (record[5] == 0) || (record[5] >= IFNAMSIZ) || (record[8 + record[5]] != '\0'))
+  {
+    return -1;
+  }
+  *op = (vlan_config_op_t)record[4];
+  memcpy(vlanID, &record[6], sizeof(*vlanID));
+  *name = (const char *)&record[8];
+  return 0;
+}
+
+static int vlan_config_write_all(int fd, const void *buffer, size_t length)
+{
+  const uint8_t *p = buffer;
+  ssize_t written;
+
+  while (length > 0)
+  {
+    written = write(fd, p, length);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return -errno;
+    }
+    p += written;
+    length -= (size_t)written;
+  }
+  return 0;
+}
+
+/* Replays records from the log, truncating it after the last good one */
+static int vlan_config_replay(vlan_config_store_t *store, off_t size, vlan_config_replay_fn replay, void *ctx)
+{
+  uint8_t buffer[VLAN_CONFIG_READ_RECORDS * VLAN_CONFIG_RECORD_SIZE];
+  off_t offset = VLAN_CONFIG_MAGIC_SIZE;
+  ssize_t got;
+  ssize_t i;
+
+  while (offset < size)
+  {
+    got = pread(store->fd, buffer, sizeof(buffer), offset);
+    if (got < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return -errno;
+    }
+    for (i = 0; i + VLAN_CONFIG_RECORD_SIZE <= got; i += VLAN_CONFIG_RECORD_SIZE)
+    {
+      vlan_config_op_t op;
+      const char *name;
+      uint16_t vlanID;
+
+      if (vlan_config_decode(&buffer[i], &op, &name, &vlanID) != 0)
+      {
+        goto done;
+      }
+      if (replay != NULL)
+      {
+        replay(ctx, op, name, (op == VLAN_CONFIG_OP_PUT) ? vlanID : 0);
+      }
+      store->records++;
+      offset += VLAN_CONFIG_RECORD_SIZE;
+    }
+    if (got < (ssize_t)sizeof(buffer))
+    {
+      break;
+    }
+  }
+
+done:
+  /* Whatever follows the last good record is a torn or corrupt append */
+  if (offset < size)
+  {
+    if ((ftruncate(store->fd, offset) != 0) || (fdatasync(store->fd) != 0))
+    {
+      return -errno;
+    }
+  }
+  return 0;
+}
+
+int vlan_config_store_open(vlan_config_store_t *store, const char *path, vlan_config_replay_fn replay, void *ctx)
+{
+  char magic[VLAN_CONFIG_MAGIC_SIZE];
+  struct stat st;
+  int ret;
+
+  if ((store == NULL) || (path == NULL))
+  {
+    return -EINVAL;
+  }
+  store->records = 0;
+  store->pending = 0;
+  store->path = strdup(path);
+  if (store->path == NULL)
+  {
+    return -ENOMEM;
+  }
+  store->fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if ((store->fd < 0) || (fstat(store->fd, &st) != 0))
+  {
+    ret = -errno;
+    goto fail;
+  }
+
+  if (st.st_size < VLAN_CONFIG_MAGIC_SIZE)
+  {
+    /* New file, or one that crashed before its header was complete */
+    if (ftruncate(store->fd, 0) != 0)
+    {
+      ret = -errno;
+      goto fail;
+    }
+    if ((ret = vlan_config_write_all(store->fd, VLAN_CONFIG_MAGIC, VLAN_CONFIG_MAGIC_SIZE)) != 0)
+    {
+      goto fail;
+    }
+    if (fdatasync(store->fd) != 0)
+    {
+      ret = -errno;
+      goto fail;
+    }
+    return 0;
+  }
+  if ((pread(store->fd, magic, sizeof(magic), 0) != (ssize_t)sizeof(magic)) ||
+      (memcmp(magic, VLAN_CONFIG_MAGIC, VLAN_CONFIG_MAGIC_SIZE) != 0))
+  {
+    ret = -EINVAL;
+    goto fail;
+  }
+  if ((ret = vlan_config_replay(store, st.st_size, replay, ctx)) != 0)
+  {
+    goto fail;
+  }
+  return 0;
+
+fail:
+  if (store->fd >= 0)
+  {
+    close(store->fd);
+  }
+  store->fd = -1;
+  free(store->path);
+  store->path = NULL;
+  return ret;
+}
+
+int vlan_config_store_sync(vlan_config_store_t *store)
+{
+  if ((store == NULL) || (store->fd < 0))
+  {
+    return -EBADF;
+  }
+  if (store->pending == 0)
+  {
+    return 0;
+  }
+  if (fdatasync(store->fd) != 0)
+  {
+    return -errno;
+  }
+  store->pending = 0;
+  return 0;
+}
+
+void vlan_config_store_close(vlan_config_store_t *store)
+{
+  if ((store == NULL) || (store->fd < 0))
+  {
+    return;
+  }
+  vlan_config_store_sync(store);
+  close(store->fd);
+  store->fd = -1;
+  free(store->path);
+  store->path = NULL;
+}
+
+static int vlan_config_store_append(vlan_config_store_t *store, vlan_config_op_t op, const char *name, uint16_t vlanID)
+{
+  uint8_t record[VLAN_CONFIG_RECORD_SIZE];
+  size_t length;
+  int ret;
+
+  if ((store == NULL) || (store->fd < 0))
+  {
+    return -EBADF;
+  }
+  if (name == NULL)
+  {
+    return -EINVAL;
+  }
+  length = strlen(name);
+  if ((length == 0) || (length >= IFNAMSIZ))
+  {
+    return -EINVAL;
+  }
+  vlan_config_encode(record, op, name, length, vlanID);
+  if ((ret = vlan_config_write_all(store->fd, record, sizeof(record))) != 0)
+  {
+    return ret;
+  }
+  store->records++;
+  if (++store->pending >= VLAN_CONFIG_STORE_SYNC_BATCH)
+  {
+    return vlan_config_store_sync(store);
+  }
+  return 0;
+}
+
+int vlan_config_store_put(vlan_config_store_t *store, const char *name, uint16_t vlanID)
+{
+  return vlan_config_store_append(store, VLAN_CONFIG_OP_PUT, name, vlanID);
+}
+
+int vlan_config_store_del(vlan_config_store_t *store, const char *name)
+{
+  return vlan_config_store_append(store, VLAN_CONFIG_OP_DEL, name, 0);
+}
+
+int vlan_config_store_needs_compaction(const vlan_config_store_t *store, uint32_t live)
+{
+  if ((store == NULL) || (store->fd < 0))
+  {
+    return 0;
+  }
+  return (store->records >= VLAN_CONFIG_STORE_COMPACT_MIN) && (store->records > 2 * live);
+}
+
+/* Makes a completed rename durable */
+static int vlan_config_sync_dir(const char *path)
+{
+  char *copy = strdup(path);
+  int fd;
+  int ret = 0;
+
+  if (copy == NULL)
+  {
+    return -ENOMEM;
+  }
+  fd = open(dirname(copy), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if ((fd < 0) || (fsync(fd) != 0))
+  {
+    ret = -errno;
+  }
+  if (fd >= 0)
+  {
+    close(fd);
+  }
+  free(copy);
+  return ret;
+}
+
+int vlan_config_store_compact(vlan_config_store_t *store, const vlan_group_table_t *const *tables, uint32_t count)
+{
+  uint8_t buffer[VLAN_CONFIG_READ_RECORDS * VLAN_CONFIG_RECORD_SIZE];
+  char tmpPath[4096];
+  vlan_group_entry_t *entry;
+  const char *name;
+  uint32_t cursor = 0;
+  uint32_t records = 0;
+  uint32_t t = 0;
+  size_t used = 0;
+  int fd;
+  int ret;
+
+  if ((store == NULL) || (store->fd < 0) || ((tables == NULL) && (count != 0)))
+  {
+    return -EINVAL;
+  }
+  if (snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", store->path) >= (int)sizeof(tmpPath))
+  {
+    return -ENAMETOOLONG;
+  }
+  /* Opened as the log will be used, so once renamed it simply replaces store->fd */
+  fd = open(tmpPath, O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+  if (fd < 0)
+  {
+    return -errno;
+  }
+
+  ret = vlan_config_write_all(fd, VLAN_CONFIG_MAGIC, VLAN_CONFIG_MAGIC_SIZE);
+  while ((ret == 0) && (t < count))
+  {
+    entry = vlan_group_table_next(tables[t], &cursor);
+    if (entry == NULL)
+    {
+      t++;
+      cursor = 0;
+      continue;
+    }
+    name = vlan_name_str(entry->name);
+    vlan_config_encode(&buffer[used], VLAN_CONFIG_OP_PUT, name, strlen(name), entry->vlanID);
+    used += VLAN_CONFIG_RECORD_SIZE;
+    records++;
+    if (used == sizeof(buffer))
+    {
+      ret = vlan_config_write_all(fd, buffer, used);
+      used = 0;
+    }
+  }
+  if ((ret == 0) && (used > 0))
+  {
+    ret = vlan_config_write_all(fd, buffer, used);
+  }
+  if ((ret == 0) && (fdatasync(fd) != 0))
+  {
+    ret = -errno;
+  }
+  if ((ret == 0) && (rename(tmpPath, store->path) != 0))
+  {
+    ret = -errno;
+  }
+  if (ret != 0)
+  {
+    close(fd);
+    unlink(tmpPath);
+    return ret;
+  }
+
+  /* The old descriptor now refers to the unlinked log, nothing may fail before it is replaced */
+  close(store->fd);
+  store->fd = fd;
+  store->records = records;
+  store->pending = 0;
+  return vlan_config_sync_dir(store->path);
+}
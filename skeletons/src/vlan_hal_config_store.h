@@ -0,0 +1,117 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_config_store.h
+ *
+ * Persistent group to VLAN table behind insert_VLAN_ConfigEntry() and
+ * delete_VLAN_ConfigEntry(), kept as an append-only log.
+ *
+ * Each change appends one fixed-size, CRC protected record, so an update
+ * costs a single small write instead of rewriting the file. Records are
+ * flushed with fdatasync() every VLAN_CONFIG_STORE_SYNC_BATCH appends and on
+ * vlan_config_store_sync() / close. A crash can lose at most the unsynced
+ * tail, never corrupt earlier records: on open, replay stops at the first
+ * torn or corrupt record and the file is truncated there.
+ *
+ * Once the log holds many more records than live groups it is compacted:
+ * the live set is written to "<path>.tmp", synced and renamed over the log.
+ */
+#ifndef __VLAN_HAL_CONFIG_STORE_H__
+#define __VLAN_HAL_CONFIG_STORE_H__
+
+#include <stdint.h>
+#include <net/if.h>
+#include "vlan_hal_group_table.h"
+
+#define VLAN_CONFIG_STORE_SYNC_BATCH 16
+/* Compact when the log has at least this many records and more than twice the live count */
+#define VLAN_CONFIG_STORE_COMPACT_MIN 64
+
+typedef enum
+{
+  VLAN_CONFIG_OP_PUT = 1,
+  VLAN_CONFIG_OP_DEL = 2
+} vlan_config_op_t;
+
+/**
+ * @brief Called for each valid record during replay, in log order.
+ *
+ * @p vlanID is 0 for VLAN_CONFIG_OP_DEL.
+ */
+typedef void (*vlan_config_replay_fn)(void *ctx, vlan_config_op_t op, const char *name, uint16_t vlanID);
+
+typedef struct
+{
+  int fd;
+  char *path;
+  uint32_t records;             /*!< Records currently in the log */
+  uint32_t pending;             /*!< Records appended since the last fdatasync() */
+} vlan_config_store_t;
+
+/**
+ * @brief Open (creating if needed) the log at @p path and replay it through @p replay.
+ *
+ * @return 0 on success, negative errno on failure. A torn tail is not a failure.
+ */
+int vlan_config_store_open(vlan_config_store_t *store, const char *path, vlan_config_replay_fn replay, void *ctx);
+
+/**
+ * @brief Sync pending records and close the log.
+ */
+void vlan_config_store_close(vlan_config_store_t *store);
+
+/**
+ * @brief Append a record setting @p name to @p vlanID.
+ *
+ * @return 0 on success, negative errno on failure.
+ */
+int vlan_config_store_put(vlan_config_store_t *store, const char *name, uint16_t vlanID);
+
+/**
+ * @brief Append a record removing @p name.
+ *
+ * @return 0 on success, negative errno on failure.
+ */
+int vlan_config_store_del(vlan_config_store_t *store, const char *name);
+
+/**
+ * @brief fdatasync() the log if records were appended since the last sync.
+ *
+ * @return 0 on success, negative errno on failure.
+ */
+int vlan_config_store_sync(vlan_config_store_t *store);
+
+/**
+ * @brief True when the log is worth compacting given @p live current entries.
+ */
+int vlan_config_store_needs_compaction(const vlan_config_store_t *store, uint32_t live);
+
+/**
+ * @brief Replace the log with one PUT record per entry of the @p count tables in @p tables.
+ *
+ * NULL tables are skipped, so a sharded registry can pass its shards as they are.
+ *
+ * The new log is fully synced before it replaces the old one, so a crash at
+ * any point leaves either the old or the new log in place.
+ *
+ * @return 0 on success, negative errno on failure (the old log stays in use).
+ */
+int vlan_config_store_compact(vlan_config_store_t *store, const vlan_group_table_t *const *tables, uint32_t count);
+
+#endif /* __VLAN_HAL_CONFIG_STORE_H__ */
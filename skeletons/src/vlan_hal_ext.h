@@ -0,0 +1,355 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_ext.h
+ *
+ * Extensions to the vlan_hal.h API implemented by the skeleton. They are
+ * candidates for the HAL specification and are not provided by vendor
+ * libraries, so only skeleton builds (VLAN_HAL_SKELETON) may call them.
+ */
+#ifndef __VLAN_HAL_EXT_H__
+#define __VLAN_HAL_EXT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <net/if.h>
+
+/**
+ * @brief One entry of a vlan_hal_addInterfaces() batch.
+ */
+typedef struct
+{
+  const char *ifName;           /*!< Interface to attach */
+  const char *vlanID;           /*!< VLAN ID, "1" to "4094" */
+  int status;                   /*!< Out: RETURN_OK or RETURN_ERR for this entry */
+} vlan_hal_interface_t;
+
+/**
+ * @brief Add several interfaces to a group in one call.
+ *
+ * Equivalent to calling vlan_hal_addInterface() for every entry, but the
+ * backend applies the whole batch at once (with the netlink backend, a fixed
+ * number of kernel round trips regardless of @p count). Entries are
+ * independent: a failing entry does not stop the others.
+ *
+ * @param[in] groupName - Existing group (bridge) name
+ * @param[in,out] interfaces - Entries to add, status is filled in for each
+ * @param[in] count - Number of entries
+ *
+ * @return RETURN_OK if every entry succeeded, RETURN_ERR otherwise
+ */
+int vlan_hal_addInterfaces(const char *groupName, vlan_hal_interface_t *interfaces, int count);
+
+/**
+ * @brief Create a group on the lowest VLAN ID not assigned to any other group.
+ *
+ * @param[in] groupName - Group (bridge) name, must not exist yet
+ * @param[out] vlanID - Receives the allocated VLAN ID, at least 5 bytes
+ *
+ * @return RETURN_OK on success, RETURN_ERR if the group exists or all of 1..4094 are taken
+ */
+int vlan_hal_addDynamicGroup(const char *groupName, char *vlanID);
+
+/**
+ * @brief Report how many distinct VLAN IDs are assigned to groups.
+ *
+ * Groups may share a VLAN ID, which then counts once.
+ *
+ * @param[out] inUse - VLAN IDs assigned, may be NULL
+ * @param[out] available - VLAN IDs still free out of 4094, may be NULL
+ *
+ * @return RETURN_OK on success, RETURN_ERR if both pointers are NULL
+ */
+int vlan_hal_getVlanUsage(unsigned int *inUse, unsigned int *available);
+
+/**
+ * @brief Persist the group to VLAN table in the append-only log at @p path.
+ *
+ * Intended to be called once at boot: the log is replayed into the registry,
+ * restoring every group recorded by insert_VLAN_ConfigEntry(),
+ * vlan_hal_addGroup() and friends, and from then on each change is appended.
+ * Appends are synced in batches; call vlan_hal_config_sync() where a change
+ * must be durable before continuing.
+ *
+ * @param[in] path - Log file, created if missing
+ *
+ * @return RETURN_OK on success, RETURN_ERR if a log is already open or @p path cannot be used
+ */
+int vlan_hal_config_open(const char *path);
+
+/**
+ * @brief Flush appended changes to storage.
+ *
+ * @return RETURN_OK on success, RETURN_ERR if no log is open or the sync failed
+ */
+int vlan_hal_config_sync(void);
+
+/**
+ * @brief Sync and close the log. The registry keeps its contents.
+ */
+void vlan_hal_config_close(void);
+
+/**
+ * @brief Publish the group to VLAN table as a memory-mapped file at @p path.
+ *
+ * The file is kept in step with every change, and other processes can query
+ * it with vlan_config_map_open() and vlan_config_map_lookup() instead of
+ * calling get_vlanId_for_GroupName() through the HAL.
+ *
+ * @param[in] path - File to create, replaced if it exists
+ *
+ * @return RETURN_OK on success, RETURN_ERR if already published or the file cannot be created
+ */
+int vlan_hal_config_publish(const char *path);
+
+/**
+ * @brief Stop updating the published file. The file itself is left in place.
+ */
+void vlan_hal_config_unpublish(void);
+
+typedef enum
+{
+  VLAN_HAL_RECORD_GROUP = 0,    /*!< A group (bridge) and its VLAN ID */
+  VLAN_HAL_RECORD_MEMBER        /*!< A port enslaved to groupName */
+} vlan_hal_record_type_t;
+
+/**
+ * @brief One record of a vlan_hal_walkGroups() / vlan_hal_readGroups() stream.
+ */
+typedef struct
+{
+  vlan_hal_record_type_t type;
+  unsigned int vlanID;          /*!< Group VLAN, or the member port's VLAN */
+  char groupName[IFNAMSIZ];     /*!< Group, or the group the member belongs to */
+  char ifName[IFNAMSIZ];        /*!< Member only: parent interface, "" for groups */
+  char portName[IFNAMSIZ];      /*!< Member only: "<ifName>.<vlanID>", "" for groups */
+} vlan_hal_record_t;
+
+typedef enum
+{
+  VLAN_HAL_CURSOR_GROUPS = 0,
+  VLAN_HAL_CURSOR_MEMBERS,
+  VLAN_HAL_CURSOR_DONE
+} vlan_hal_cursor_phase_t;
+
+/**
+ * @brief Position in a record stream, initialise with VLAN_HAL_CURSOR_INIT.
+ */
+typedef struct
+{
+  uint32_t phase;               /*!< vlan_hal_cursor_phase_t */
+  uint32_t shard;               /*!< Registry shard the walk is in */
+  uint32_t slot;                /*!< Next slot to visit in that shard */
+  uint32_t generation;          /*!< Registry version the walk started on */
+  int changed;                  /*!< Out: set if the registry changed since the walk started */
+} vlan_hal_cursor_t;
+
+#define VLAN_HAL_CURSOR_INIT { VLAN_HAL_CURSOR_GROUPS, 0, 0, 0, 0 }
+
+/* Returned by vlan_hal_walkGroups() / vlan_hal_readGroups() while records remain */
+#define VLAN_HAL_WALK_MORE 1
+
+/**
+ * @brief Receives one record. Return 0 to continue, non-zero to pause the walk after this record.
+ *
+ * @p record is only valid for the duration of the call. The callback runs
+ * outside the registry's read section, so it may call any HAL function,
+ * including ones that change the registry. The walk then carries on over
+ * the new contents with @p cursor->changed set.
+ */
+typedef int (*vlan_hal_record_fn)(void *ctx, const vlan_hal_record_t *record);
+
+/**
+ * @brief Stream the registry as structured records without allocating.
+ *
+ * Every group is reported first, then every member port. Each call resumes
+ * from @p cursor and delivers at most @p maxRecords records (0 for no
+ * limit), so a large registry can be dumped in bounded chunks. Calls never
+ * block writers. If the registry changes between calls the walk continues
+ * on the new contents and @p cursor->changed is set; restart from
+ * VLAN_HAL_CURSOR_INIT when an exact point-in-time view is required.
+ *
+ * @param[in,out] cursor - Stream position
+ * @param[in] maxRecords - Records to deliver in this call, 0 for all
+ * @param[in] fn - Record callback
+ * @param[in] ctx - Passed to @p fn
+ *
+ * @return RETURN_OK when the stream is complete, VLAN_HAL_WALK_MORE if records remain, RETURN_ERR on invalid arguments
+ */
+int vlan_hal_walkGroups(vlan_hal_cursor_t *cursor, unsigned int maxRecords, vlan_hal_record_fn fn, void *ctx);
+
+/**
+ * @brief vlan_hal_walkGroups() into a caller-supplied array.
+ *
+ * @param[in,out] cursor - Stream position
+ * @param[out] records - Receives up to @p capacity records
+ * @param[in] capacity - Size of @p records
+ * @param[out] count - Records written
+ *
+ * @return As vlan_hal_walkGroups()
+ */
+int vlan_hal_readGroups(vlan_hal_cursor_t *cursor, vlan_hal_record_t *records, unsigned int capacity, unsigned int *count);
+
+/**
+ * @brief Receives one line of command output, without its '\n' and NUL-terminated.
+ *
+ * @p line is only valid for the duration of the call and may be modified in place.
+ * Return 0 to continue, a positive value to stop reading.
+ */
+typedef int (*vlan_hal_line_fn)(void *ctx, char *line, size_t length);
+
+/**
+ * @brief Stream the output of a popen()ed command line by line.
+ *
+ * Unlike _get_shell_outputbuffer_res() the output is never truncated: it is
+ * read from the pipe in large chunks and each line is passed to @p fn
+ * straight from the read buffer. Lines longer than 4095 bytes arrive in pieces.
+ * @p fp must not have been read through stdio; the caller still pclose()s it.
+ *
+ * @param[in] fp - Command output, as returned by popen(cmd, "r")
+ * @param[in] fn - Line callback
+ * @param[in] ctx - Passed to @p fn
+ *
+ * @return RETURN_OK at end of output or when @p fn stopped the read, RETURN_ERR on invalid arguments or a read error
+ */
+int vlan_hal_read_lines(FILE *fp, vlan_hal_line_fn fn, void *ctx);
+
+/**
+ * @brief Read the whole output of a popen()ed command into one allocation.
+ *
+ * @param[in] fp - Command output, as returned by popen(cmd, "r"), not read through stdio
+ * @param[out] length - Receives the output length, may be NULL
+ *
+ * @return NUL-terminated output to release with free(), NULL on invalid arguments or failure
+ */
+char *vlan_hal_read_all(FILE *fp, size_t *length);
+
+/**
+ * @brief Run a command without a shell and stream its output line by line.
+ *
+ * A cheaper replacement for _get_shell_outputbuffer() when the command
+ * needs no shell features: @p argv[0] is searched on PATH and started with
+ * posix_spawn(), and filtering a pipeline would do (such as grep) is left
+ * to @p fn.
+ *
+ * @param[in] argv - NULL-terminated argument vector, e.g. { "brctl", "show", NULL }
+ * @param[in] fn - Line callback as for vlan_hal_read_lines(), NULL to discard the output
+ * @param[in] ctx - Passed to @p fn
+ *
+ * @return The command's exit status (128 + signal number if it was killed), RETURN_ERR if it could not be run
+ */
+int vlan_hal_run(const char *const argv[], vlan_hal_line_fn fn, void *ctx);
+
+/**
+ * @brief Apply every change the backend has deferred.
+ *
+ * With a batching backend (VLAN_HAL_BACKEND=ip) group and interface calls
+ * return once their commands are queued, and the system catches up when a
+ * batch threshold is reached or on this call. Call it after a sequence of
+ * changes, such as bringing a group up, to apply them and learn whether
+ * they all succeeded. Other backends apply each change immediately.
+ *
+ * @return RETURN_OK if everything pending was applied, RETURN_ERR if any change since the last commit failed
+ */
+int vlan_hal_commit(void);
+
+/**
+ * @brief Completion of an asynchronous operation.
+ *
+ * @p result is what the synchronous call would have returned. Called on the
+ * worker thread: it must not block for long, and must not call
+ * vlan_hal_async_drain() or vlan_hal_async_stop().
+ */
+typedef void (*vlan_hal_async_fn)(void *ctx, int result);
+
+/**
+ * @brief A completion collected with vlan_hal_async_reap().
+ */
+typedef struct
+{
+  void *ctx;                    /*!< As passed when the operation was submitted */
+  int result;                   /*!< RETURN_OK or RETURN_ERR */
+} vlan_hal_completion_t;
+
+/**
+ * @brief Asynchronous variants of the mutating calls, through a serial offload queue.
+ *
+ * Each copies its arguments, queues the operation and returns at once.
+ * Operations run one at a time on a single worker thread, in submission
+ * order, through the synchronous call of the same name. This frees the
+ * caller's thread but does not run operations in parallel: throughput and
+ * the time each operation takes are those of the synchronous calls, which
+ * serialise on the registry anyway.
+ *
+ * On completion @p done is called with the result, or, when @p done is
+ * NULL, a completion carrying @p ctx is queued for vlan_hal_async_reap()
+ * and vlan_hal_async_fd() becomes readable. The worker starts on first use.
+ * If it can no longer wait for submissions it completes everything queued
+ * with RETURN_ERR and exits, and submissions fail until vlan_hal_async_stop().
+ *
+ * @return RETURN_OK if queued, RETURN_ERR on invalid arguments or if the worker cannot run
+ */
+int vlan_hal_addGroup_async(const char *groupName, const char *vlanID, vlan_hal_async_fn done, void *ctx);
+int vlan_hal_delGroup_async(const char *groupName, vlan_hal_async_fn done, void *ctx);
+int vlan_hal_addInterface_async(const char *groupName, const char *ifName, const char *vlanID,
+                                vlan_hal_async_fn done, void *ctx);
+int vlan_hal_delInterface_async(const char *groupName, const char *ifName, const char *vlanID,
+                                vlan_hal_async_fn done, void *ctx);
+int vlan_hal_delete_all_Interfaces_async(const char *groupName, vlan_hal_async_fn done, void *ctx);
+
+/**
+ * @brief Start the worker thread ahead of the first submission.
+ *
+ * @return RETURN_OK if running, RETURN_ERR if it could not be started
+ */
+int vlan_hal_async_start(void);
+
+/**
+ * @brief Descriptor that polls readable while completions wait to be reaped.
+ *
+ * Add it to the caller's own epoll/poll set. It stays valid until vlan_hal_async_stop().
+ *
+ * @return Non-blocking eventfd, or -1 if the worker cannot be started
+ */
+int vlan_hal_async_fd(void);
+
+/**
+ * @brief Collect completions of operations submitted without a callback.
+ *
+ * @param[out] completions - Receives up to @p capacity completions, oldest first
+ * @param[in] capacity - Size of @p completions
+ *
+ * @return Number of completions written, 0 if none are waiting
+ */
+unsigned int vlan_hal_async_reap(vlan_hal_completion_t *completions, unsigned int capacity);
+
+/**
+ * @brief Wait until every submitted operation has completed.
+ */
+void vlan_hal_async_drain(void);
+
+/**
+ * @brief Drain, then stop the worker. Completions not yet reaped are discarded.
+ *
+ * The worker restarts on the next submission.
+ */
+void vlan_hal_async_stop(void);
+
+#endif /* __VLAN_HAL_EXT_H__ */
@@ -0,0 +1,252 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include <stdlib.h>
+#include "vlan_hal_group_table.h"
+
+/* FNV-1a, good enough spread for short interface names */
+uint32_t vlan_group_table_hash(const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+  {
+    hash ^= (uint8_t)*name++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static uint32_t vlan_group_round_capacity(uint32_t capacity)
+{
+  uint32_t rounded = VLAN_GROUP_TABLE_MIN_CAPACITY;
+
+  /* Keep the load factor below 3/4 for the requested number of groups */
+  while ((rounded / 4) * 3 < capacity)
+  {
+    rounded <<= 1;
+  }
+  return rounded;
+}
+
+int vlan_group_table_init(vlan_group_table_t *table, uint32_t capacity)
+{
+  if (table == NULL)
+  {
+    return -1;
+  }
+  table->capacity = vlan_group_round_capacity(capacity);
+  table->count = 0;
+  table->tombstones = 0;
+  table->slots = calloc(table->capacity, sizeof(vlan_group_entry_t));
+  if (table->slots == NULL)
+  {
+    table->capacity = 0;
+    return -1;
+  }
+  return 0;
+}
+
+void vlan_group_table_deinit(vlan_group_table_t *table)
+{
+  if (table == NULL)
+  {
+    return;
+  }
+  free(table->slots);
+  table->slots = NULL;
+  table->capacity = 0;
+  table->count = 0;
+  table->tombstones = 0;
+}
+
+int vlan_group_table_copy(vlan_group_table_t *copy, const vlan_group_table_t *table)
+{
+  if ((copy == NULL) || (table == NULL))
+  {
+    return -1;
+  }
+  *copy = *table;
+  if (table->slots == NULL)
+  {
+    return 0;
+  }
+  copy->slots = malloc(table->capacity * sizeof(vlan_group_entry_t));
+  if (copy->slots == NULL)
+  {
+    copy->capacity = 0;
+    copy->count = 0;
+    copy->tombstones = 0;
+    return -1;
+  }
+  memcpy(copy->slots, table->slots, table->capacity * sizeof(vlan_group_entry_t));
+  return 0;
+}
+
+/*
+ * Returns the slot holding @name, or if absent the slot an insert should use
+ * (the first tombstone on the probe path, otherwise the terminating empty slot).
+ */
+static vlan_group_entry_t *vlan_group_probe(const vlan_group_table_t *table, const char *name, uint32_t hash)
+{
+  uint32_t mask = table->capacity - 1;
+  uint32_t index = hash & mask;
+  vlan_group_entry_t *reuse = NULL;
+  vlan_group_entry_t *slot;
+
+  for (;;)
+  {
+    slot = &table->slots[index];
+    if (slot->state == VLAN_GROUP_SLOT_EMPTY)
+    {
+      return (reuse != NULL) ? reuse : slot;
+    }
+    if (slot->state == VLAN_GROUP_SLOT_DELETED)
+    {
+      if (reuse == NULL)
+      {
+        reuse = slot;
+      }
+    }
+    else if ((slot->hash == hash) && (strcmp(vlan_name_str(slot->name), name) == 0))
+    {
+      return slot;
+    }
+    index = (index + 1) & mask;
+  }
+}
+
+static int vlan_group_table_rehash(vlan_group_table_t *table, uint32_t capacity)
+{
+  vlan_group_table_t resized;
+  vlan_group_entry_t *slot;
+  uint32_t i;
+
+  if (vlan_group_table_init(&resized, capacity) != 0)
+  {
+    return -1;
+  }
+  for (i = 0; i < table->capacity; i++)
+  {
+    if (table->slots[i].state != VLAN_GROUP_SLOT_USED)
+    {
+      continue;
+    }
+    slot = vlan_group_probe(&resized, vlan_name_str(table->slots[i].name), table->slots[i].hash);
+    *slot = table->slots[i];
+    resized.count++;
+  }
+  free(table->slots);
+  *table = resized;
+  return 0;
+}
+
+vlan_group_entry_t *vlan_group_table_find(const vlan_group_table_t *table, const char *name)
+{
+  vlan_group_entry_t *slot;
+
+  if ((table == NULL) || (table->slots == NULL) || (name == NULL))
+  {
+    return NULL;
+  }
+  slot = vlan_group_probe(table, name, vlan_group_table_hash(name));
+  return (slot->state == VLAN_GROUP_SLOT_USED) ? slot : NULL;
+}
+
+int vlan_group_table_insert(vlan_group_table_t *table, const char *name, uint16_t vlanID)
+{
+  vlan_group_entry_t *slot;
+  vlan_name_t interned;
+  uint32_t hash;
+
+  if (table == NULL)
+  {
+    return -1;
+  }
+  /* Rejects NULL, empty and overlong names */
+  interned = vlan_name_intern(name);
+  if (interned == VLAN_NAME_NONE)
+  {
+    return -1;
+  }
+  if ((table->slots == NULL) && (vlan_group_table_init(table, 0) != 0))
+  {
+    return -1;
+  }
+
+  hash = vlan_group_table_hash(name);
+  slot = vlan_group_probe(table, name, hash);
+  if (slot->state == VLAN_GROUP_SLOT_USED)
+  {
+    slot->vlanID = vlanID;
+    return 0;
+  }
+
+  /* Grow (or just sweep tombstones) before the table passes 3/4 occupancy */
+  if ((table->count + table->tombstones + 1) > (table->capacity / 4) * 3)
+  {
+    if (vlan_group_table_rehash(table, table->count + 1) != 0)
+    {
+      return -1;
+    }
+    slot = vlan_group_probe(table, name, hash);
+  }
+
+  if (slot->state == VLAN_GROUP_SLOT_DELETED)
+  {
+    table->tombstones--;
+  }
+  slot->hash = hash;
+  slot->vlanID = vlanID;
+  slot->state = VLAN_GROUP_SLOT_USED;
+  slot->name = interned;
+  table->count++;
+  return 0;
+}
+
+int vlan_group_table_remove(vlan_group_table_t *table, const char *name)
+{
+  vlan_group_entry_t *slot = vlan_group_table_find(table, name);
+
+  if (slot == NULL)
+  {
+    return -1;
+  }
+  slot->state = VLAN_GROUP_SLOT_DELETED;
+  table->count--;
+  table->tombstones++;
+  return 0;
+}
+
+vlan_group_entry_t *vlan_group_table_next(const vlan_group_table_t *table, uint32_t *cursor)
+{
+  if ((table == NULL) || (cursor == NULL))
+  {
+    return NULL;
+  }
+  while (*cursor < table->capacity)
+  {
+    vlan_group_entry_t *slot = &table->slots[(*cursor)++];
+
+    if (slot->state == VLAN_GROUP_SLOT_USED)
+    {
+      return slot;
+    }
+  }
+  return NULL;
+}
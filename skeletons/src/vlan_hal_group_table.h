@@ -0,0 +1,113 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_group_table.h
+ *
+ * Open-addressing hash table mapping a group (bridge) name to its VLAN ID.
+ * Used by the skeleton HAL as the in-memory registry behind vlan_hal_addGroup(),
+ * insert_VLAN_ConfigEntry() and get_vlanId_for_GroupName().
+ */
+#ifndef __VLAN_HAL_GROUP_TABLE_H__
+#define __VLAN_HAL_GROUP_TABLE_H__
+
+#include <stdint.h>
+#include <net/if.h>
+#include "vlan_hal_name_pool.h"
+
+#define VLAN_GROUP_TABLE_MIN_CAPACITY 16
+
+typedef enum
+{
+  VLAN_GROUP_SLOT_EMPTY = 0,
+  VLAN_GROUP_SLOT_USED,
+  VLAN_GROUP_SLOT_DELETED
+} vlan_group_slot_state_t;
+
+typedef struct
+{
+  uint32_t hash;
+  uint16_t vlanID;
+  uint8_t state;                /*!< vlan_group_slot_state_t */
+  vlan_name_t name;             /*!< Interned, see vlan_hal_name_pool.h */
+} vlan_group_entry_t;
+
+typedef struct
+{
+  vlan_group_entry_t *slots;
+  uint32_t capacity;            /*!< Always a power of two */
+  uint32_t count;               /*!< Slots in VLAN_GROUP_SLOT_USED state */
+  uint32_t tombstones;          /*!< Slots in VLAN_GROUP_SLOT_DELETED state */
+} vlan_group_table_t;
+
+/**
+ * @brief Hash used for interface and bridge names by the skeleton's tables.
+ */
+uint32_t vlan_group_table_hash(const char *name);
+
+/**
+ * @brief Initialise a table able to hold at least @p capacity groups without growing.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int vlan_group_table_init(vlan_group_table_t *table, uint32_t capacity);
+
+/**
+ * @brief Release the slot array. The table may be re-initialised afterwards.
+ */
+void vlan_group_table_deinit(vlan_group_table_t *table);
+
+/**
+ * @brief Initialise @p copy as an independent duplicate of @p table.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int vlan_group_table_copy(vlan_group_table_t *copy, const vlan_group_table_t *table);
+
+/**
+ * @brief Look up a group by name.
+ *
+ * @return Pointer to the live entry, or NULL if the group is not present.
+ *         The pointer is invalidated by the next insert or remove.
+ */
+vlan_group_entry_t *vlan_group_table_find(const vlan_group_table_t *table, const char *name);
+
+/**
+ * @brief Insert a group or update the VLAN ID of an existing one.
+ *
+ * @p name must be shorter than IFNAMSIZ and is interned in the name pool.
+ *
+ * @return 0 on success, -1 on invalid name or allocation failure.
+ */
+int vlan_group_table_insert(vlan_group_table_t *table, const char *name, uint16_t vlanID);
+
+/**
+ * @brief Remove a group.
+ *
+ * @return 0 if the group was removed, -1 if it was not present.
+ */
+int vlan_group_table_remove(vlan_group_table_t *table, const char *name);
+
+/**
+ * @brief Iterate over live entries in slot order.
+ *
+ * Start with @p *cursor set to 0 and call until NULL is returned.
+ */
+vlan_group_entry_t *vlan_group_table_next(const vlan_group_table_t *table, uint32_t *cursor);
+
+#endif /* __VLAN_HAL_GROUP_TABLE_H__ */
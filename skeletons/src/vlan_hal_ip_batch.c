@@ -0,0 +1,334 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "vlan_hal_ip_batch.h"
+#include "vlan_hal_spawn.h"
+
+/* Initial buffer, room for a group with a handful of ports */
+#define VLAN_IP_BATCH_MIN_CAPACITY 1024
+/* What "ip -batch" prints on stderr for a failing line of its input */
+#define VLAN_IP_BATCH_FAILED_LINE "Command failed -:%u"
+
+static uint64_t vlan_ip_batch_now_ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+void vlan_ip_batch_init(vlan_ip_batch_t *batch, unsigned int maxCommands, unsigned int maxDelayMs)
+{
+  if (batch == NULL)
+  {
+    return;
+  }
+  batch->commands = NULL;
+  batch->length = 0;
+  batch->capacity = 0;
+  batch->count = 0;
+  batch->firstNs = 0;
+  batch->maxCommands = (maxCommands != 0) ? maxCommands : VLAN_IP_BATCH_MAX_COMMANDS;
+  batch->maxDelayMs = (maxDelayMs != 0) ? maxDelayMs : VLAN_IP_BATCH_MAX_DELAY_MS;
+  batch->error = 0;
+  batch->owners = NULL;
+  batch->ownersCapacity = 0;
+  batch->failed = NULL;
+  batch->failedCount = 0;
+  batch->failedCapacity = 0;
+}
+
+void vlan_ip_batch_deinit(vlan_ip_batch_t *batch)
+{
+  if (batch == NULL)
+  {
+    return;
+  }
+  free(batch->commands);
+  free(batch->owners);
+  free(batch->failed);
+  vlan_ip_batch_init(batch, batch->maxCommands, batch->maxDelayMs);
+}
+
+static int vlan_ip_batch_same_owner(const vlan_ip_batch_owner_t *a, const vlan_ip_batch_owner_t *b)
+{
+  return (a->op == b->op) && (a->vlanID == b->vlanID) &&
+         (strcmp(a->brName, b->brName) == 0) && (strcmp(a->ifName, b->ifName) == 0);
+}
+
+/* Lists the owner of pending command @index as failed, once per run of its commands */
+static void vlan_ip_batch_fail(vlan_ip_batch_t *batch, unsigned int index)
+{
+  const vlan_ip_batch_owner_t *owner = &batch->owners[index];
+  vlan_ip_batch_owner_t *failed;
+  unsigned int capacity;
+
+  if ((batch->failedCount > 0) && vlan_ip_batch_same_owner(&batch->failed[batch->failedCount - 1], owner))
+  {
+    return;
+  }
+  if (batch->failedCount == batch->failedCapacity)
+  {
+    capacity = (batch->failedCapacity == 0) ? 8 : batch->failedCapacity * 2;
+    failed = realloc(batch->failed, sizeof(*failed) * capacity);
+    if (failed == NULL)
+    {
+      /* The flush still reports the failure, only the undo is lost */
+      return;
+    }
+    batch->failed = failed;
+    batch->failedCapacity = capacity;
+  }
+  batch->failed[batch->failedCount++] = *owner;
+}
+
+typedef struct
+{
+  vlan_ip_batch_t *batch;
+  unsigned int named;           /*!< Failures ip attributed to a line */
+} vlan_ip_batch_errors_t;
+
+/* Passes each line of ip's stderr on and marks the commands it names as failed */
+static int vlan_ip_batch_error_line(void *ctx, char *line, size_t length)
+{
+  vlan_ip_batch_errors_t *errors = ctx;
+  unsigned int number;
+
+  (void)length;
+  fprintf(stderr, "%s\n", line);
+  if ((sscanf(line, VLAN_IP_BATCH_FAILED_LINE, &number) == 1) && (number >= 1) && (number <= errors->batch->count))
+  {
+    vlan_ip_batch_fail(errors->batch, number - 1);
+    errors->named++;
+  }
+  return 0;
+}
+
+int vlan_ip_batch_run(vlan_ip_batch_t *batch)
+{
+  static const char *const argv[] = { VLAN_IP_BATCH_PROGRAM, "-force", "-batch", "-", NULL };
+  vlan_ip_batch_errors_t errors = { batch, 0 };
+  unsigned int i;
+  int errFd;
+  int ret;
+
+  if (batch == NULL)
+  {
+    return -EINVAL;
+  }
+  if (batch->count == 0)
+  {
+    return 0;
+  }
+  /* Without the file ip's messages go straight to stderr and a failure is blamed on every command */
+  errFd = memfd_create("vlan_ip_batch", MFD_CLOEXEC);
+  ret = vlan_spawn_feed_errors(argv, batch->commands, batch->length, errFd);
+  if (errFd >= 0)
+  {
+    if (lseek(errFd, 0, SEEK_SET) == 0)
+    {
+      vlan_reader_lines(errFd, NULL, 0, vlan_ip_batch_error_line, &errors);
+    }
+    close(errFd);
+  }
+  if ((ret != 0) && (errors.named == 0))
+  {
+    for (i = 0; i < batch->count; i++)
+    {
+      vlan_ip_batch_fail(batch, i);
+    }
+  }
+  batch->length = 0;
+  batch->count = 0;
+  if (ret > 0)
+  {
+    return -EIO;
+  }
+  return ret;
+}
+
+int vlan_ip_batch_queue(vlan_ip_batch_t *batch, const vlan_ip_batch_owner_t *owner, const char *format, ...)
+{
+  vlan_ip_batch_owner_t *owners;
+  va_list args;
+  size_t capacity;
+  char *commands;
+  int written;
+  int ret;
+
+  if ((batch == NULL) || (owner == NULL) || (format == NULL))
+  {
+    return -EINVAL;
+  }
+  if (batch->count == batch->ownersCapacity)
+  {
+    capacity = (batch->ownersCapacity == 0) ? 16 : batch->ownersCapacity * 2;
+    owners = realloc(batch->owners, sizeof(*owners) * capacity);
+    if (owners == NULL)
+    {
+      return -ENOMEM;
+    }
+    batch->owners = owners;
+    batch->ownersCapacity = (unsigned int)capacity;
+  }
+  for (;;)
+  {
+    /* The formatted line plus its '\n' must fit before the terminator vsnprintf adds */
+    va_start(args, format);
+    written = (batch->capacity > batch->length)
+              ? vsnprintf(batch->commands + batch->length, batch->capacity - batch->length, format, args)
+              : vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if (written < 0)
+    {
+      return -EINVAL;
+    }
+    if (batch->length + (size_t)written + 2 <= batch->capacity)
+    {
+      break;
+    }
+    capacity = (batch->capacity < VLAN_IP_BATCH_MIN_CAPACITY) ? VLAN_IP_BATCH_MIN_CAPACITY : batch->capacity * 2;
+    while (capacity < batch->length + (size_t)written + 2)
+    {
+      capacity *= 2;
+    }
+    commands = realloc(batch->commands, capacity);
+    if (commands == NULL)
+    {
+      return -ENOMEM;
+    }
+    batch->commands = commands;
+    batch->capacity = capacity;
+  }
+  batch->length += (size_t)written;
+  batch->commands[batch->length++] = '\n';
+  batch->owners[batch->count] = *owner;
+  if (batch->count++ == 0)
+  {
+    batch->firstNs = vlan_ip_batch_now_ns();
+  }
+
+  if (batch->count >= batch->maxCommands)
+  {
+    ret = vlan_ip_batch_run(batch);
+    if ((ret != 0) && (batch->error == 0))
+    {
+      batch->error = ret;
+    }
+  }
+  return 0;
+}
+
+int vlan_ip_batch_pending(const vlan_ip_batch_t *batch, const char *name)
+{
+  size_t length;
+  size_t i;
+
+  if ((batch == NULL) || (name == NULL) || (batch->count == 0))
+  {
+    return 0;
+  }
+  length = strlen(name);
+  /* Link names are whole words of a command, never a part of one */
+  for (i = 0; i + length <= batch->length; i++)
+  {
+    if (((i == 0) || (batch->commands[i - 1] == ' ') || (batch->commands[i - 1] == '\n')) &&
+        (memcmp(batch->commands + i, name, length) == 0) &&
+        ((i + length == batch->length) || (batch->commands[i + length] == ' ') || (batch->commands[i + length] == '\n')))
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+uint64_t vlan_ip_batch_deadline_ns(const vlan_ip_batch_t *batch)
+{
+  if ((batch == NULL) || (batch->count == 0))
+  {
+    return 0;
+  }
+  return batch->firstNs + (uint64_t)batch->maxDelayMs * 1000000u;
+}
+
+int vlan_ip_batch_flush(vlan_ip_batch_t *batch)
+{
+  int ret;
+
+  if (batch == NULL)
+  {
+    return -EINVAL;
+  }
+  ret = vlan_ip_batch_run(batch);
+  if (batch->error != 0)
+  {
+    ret = batch->error;
+    batch->error = 0;
+  }
+  return ret;
+}
+
+unsigned int vlan_ip_batch_take_failed(vlan_ip_batch_t *batch, vlan_ip_batch_owner_t **owners)
+{
+  unsigned int count;
+
+  if (owners == NULL)
+  {
+    return 0;
+  }
+  *owners = NULL;
+  if ((batch == NULL) || (batch->failedCount == 0))
+  {
+    return 0;
+  }
+  *owners = batch->failed;
+  count = batch->failedCount;
+  batch->failed = NULL;
+  batch->failedCount = 0;
+  batch->failedCapacity = 0;
+  return count;
+}
+
+int vlan_ip_batch_claim_failed(vlan_ip_batch_t *batch, const vlan_ip_batch_owner_t *owner)
+{
+  unsigned int kept = 0;
+  unsigned int i;
+
+  if ((batch == NULL) || (owner == NULL))
+  {
+    return 0;
+  }
+  for (i = 0; i < batch->failedCount; i++)
+  {
+    if (!vlan_ip_batch_same_owner(&batch->failed[i], owner))
+    {
+      batch->failed[kept++] = batch->failed[i];
+    }
+  }
+  i = batch->failedCount - kept;
+  batch->failedCount = kept;
+  return i != 0;
+}
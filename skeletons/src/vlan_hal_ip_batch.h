@@ -0,0 +1,144 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_ip_batch.h
+ *
+ * Queues iproute2 commands and runs them through a single "ip -batch -"
+ * process, so bringing up a group with several ports costs one fork/exec
+ * instead of one per bridge, VLAN link and enslave.
+ *
+ * Commands are flushed when asked to or when @c maxCommands are queued.
+ * The owner of the batch also flushes it by vlan_ip_batch_deadline_ns(),
+ * @c maxDelayMs after the oldest command still pending, from a timer of
+ * its own; the batch itself never waits for the next call.
+ *
+ * The batch runs with -force so one failing command does not stop the
+ * rest. Each command carries the change it belongs to, its owner; ip's
+ * "Command failed -:<line>" messages are matched back to those owners so
+ * the caller can undo exactly the changes that did not happen, see
+ * vlan_ip_batch_take_failed().
+ */
+#ifndef __VLAN_HAL_IP_BATCH_H__
+#define __VLAN_HAL_IP_BATCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <net/if.h>
+
+/* Found on PATH like a shell would */
+#define VLAN_IP_BATCH_PROGRAM "ip"
+#define VLAN_IP_BATCH_MAX_COMMANDS 64
+#define VLAN_IP_BATCH_MAX_DELAY_MS 100
+
+/* The change a queued command is part of, handed back if the command fails */
+typedef struct
+{
+  int op;                       /*!< Defined by the caller, never 0 */
+  uint16_t vlanID;
+  char brName[IFNAMSIZ];
+  char ifName[IFNAMSIZ];
+} vlan_ip_batch_owner_t;
+
+typedef struct
+{
+  char *commands;               /*!< Pending commands, one per line */
+  size_t length;
+  size_t capacity;
+  unsigned int count;           /*!< Commands pending */
+  uint64_t firstNs;             /*!< When the oldest pending command was queued */
+  unsigned int maxCommands;
+  unsigned int maxDelayMs;
+  int error;                    /*!< Failure of an automatic flush, reported by the next vlan_ip_batch_flush() */
+  vlan_ip_batch_owner_t *owners; /*!< Owner of each pending command */
+  unsigned int ownersCapacity;
+  vlan_ip_batch_owner_t *failed; /*!< Owners of commands that failed, see vlan_ip_batch_take_failed() */
+  unsigned int failedCount;
+  unsigned int failedCapacity;
+} vlan_ip_batch_t;
+
+/**
+ * @brief Initialise an empty batch. 0 selects the default for either threshold.
+ */
+void vlan_ip_batch_init(vlan_ip_batch_t *batch, unsigned int maxCommands, unsigned int maxDelayMs);
+
+/**
+ * @brief Discard pending commands and failures and free the buffers.
+ */
+void vlan_ip_batch_deinit(vlan_ip_batch_t *batch);
+
+/**
+ * @brief Queue one command of @p owner, given without the leading "ip" (e.g. "link del br0").
+ *
+ * May flush the batch if @c maxCommands is reached; a failure of that flush
+ * is kept and reported by the next vlan_ip_batch_flush().
+ *
+ * @return 0 if queued, negative errno on invalid arguments or allocation failure.
+ */
+int vlan_ip_batch_queue(vlan_ip_batch_t *batch, const vlan_ip_batch_owner_t *owner, const char *format, ...)
+  __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief Non-zero if a pending command names the link @p name.
+ *
+ * Lets a query that is not about any pending change skip the flush.
+ */
+int vlan_ip_batch_pending(const vlan_ip_batch_t *batch, const char *name);
+
+/**
+ * @brief CLOCK_MONOTONIC time in ns by which the pending commands should be flushed, 0 if none are.
+ */
+uint64_t vlan_ip_batch_deadline_ns(const vlan_ip_batch_t *batch);
+
+/**
+ * @brief Run every pending command in one ip process and wait for it.
+ *
+ * The owners of failed commands are added to @c failed. Unlike
+ * vlan_ip_batch_flush(), failures of earlier automatic flushes stay kept.
+ *
+ * @return 0 if nothing was pending or every command succeeded, -EIO if ip
+ *         reported a failure, other negative errno if ip could not be run.
+ */
+int vlan_ip_batch_run(vlan_ip_batch_t *batch);
+
+/**
+ * @brief As vlan_ip_batch_run(), also reporting and clearing a failure of an earlier automatic flush.
+ */
+int vlan_ip_batch_flush(vlan_ip_batch_t *batch);
+
+/**
+ * @brief Hand over the owners of every command that failed since the last call.
+ *
+ * A change that queued several consecutive commands is listed once. When ip
+ * fails without naming the line, or cannot be run, every command of the
+ * batch counts as failed.
+ *
+ * @param[out] owners  Array to free(), NULL when the result is 0.
+ *
+ * @return Number of owners in @p owners.
+ */
+unsigned int vlan_ip_batch_take_failed(vlan_ip_batch_t *batch, vlan_ip_batch_owner_t **owners);
+
+/**
+ * @brief Remove @p owner from the failed owners, so only its caller hears about it.
+ *
+ * @return Non-zero if @p owner was listed.
+ */
+int vlan_ip_batch_claim_failed(vlan_ip_batch_t *batch, const vlan_ip_batch_owner_t *owner);
+
+#endif /* __VLAN_HAL_IP_BATCH_H__ */
@@ -0,0 +1,329 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include "vlan_hal_group_table.h"
+#include "vlan_hal_link_cache.h"
+
+/* Enough for a burst of link notifications, each a few hundred bytes */
+#define VLAN_LINK_CACHE_RECV_SIZE 16384
+
+int vlan_link_cache_open(vlan_link_cache_t *cache)
+{
+  struct sockaddr_nl local;
+  int fd;
+
+  if (cache == NULL)
+  {
+    return -EINVAL;
+  }
+  cache->fd = -1;
+  fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+  if (fd < 0)
+  {
+    return -errno;
+  }
+  memset(&local, 0, sizeof(local));
+  local.nl_family = AF_NETLINK;
+  local.nl_groups = RTMGRP_LINK;
+  if (bind(fd, (struct sockaddr *)&local, sizeof(local)) < 0)
+  {
+    int err = -errno;
+
+    close(fd);
+    return err;
+  }
+  vlan_link_cache_attach(cache, fd);
+  return 0;
+}
+
+void vlan_link_cache_attach(vlan_link_cache_t *cache, int fd)
+{
+  int flags;
+
+  if (cache == NULL)
+  {
+    return;
+  }
+  if (fd >= 0)
+  {
+    flags = fcntl(fd, F_GETFL);
+    if (flags >= 0)
+    {
+      fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+  }
+  /* Starts the cache from scratch, no lock-free reader may be using it yet */
+  memset(cache->slots, 0, sizeof(cache->slots));
+  cache->generation = 0;
+  cache->hits = 0;
+  cache->misses = 0;
+  cache->invalidations = 0;
+  __atomic_store_n(&cache->fd, fd, __ATOMIC_RELEASE);
+}
+
+void vlan_link_cache_close(vlan_link_cache_t *cache)
+{
+  if ((cache == NULL) || (cache->fd < 0))
+  {
+    return;
+  }
+  close(cache->fd);
+  __atomic_store_n(&cache->fd, -1, __ATOMIC_RELEASE);
+}
+
+/* Seqlock around rewriting an entry, so lock-free readers can tell they saw a torn one */
+static void vlan_link_cache_write_begin(vlan_link_cache_entry_t *entry)
+{
+  __atomic_store_n(&entry->sequence, entry->sequence + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void vlan_link_cache_write_end(vlan_link_cache_entry_t *entry)
+{
+  __atomic_store_n(&entry->sequence, entry->sequence + 1, __ATOMIC_RELEASE);
+}
+
+static void vlan_link_cache_changed(vlan_link_cache_t *cache)
+{
+  __atomic_store_n(&cache->generation, cache->generation + 1, __ATOMIC_RELEASE);
+}
+
+void vlan_link_cache_flush(vlan_link_cache_t *cache)
+{
+  unsigned int i;
+
+  if (cache == NULL)
+  {
+    return;
+  }
+  for (i = 0; i < VLAN_LINK_CACHE_SLOTS; i++)
+  {
+    if (cache->slots[i].valid)
+    {
+      vlan_link_cache_write_begin(&cache->slots[i]);
+      cache->slots[i].valid = 0;
+      vlan_link_cache_write_end(&cache->slots[i]);
+    }
+  }
+  vlan_link_cache_changed(cache);
+}
+
+/* Any change to link @name may alter answers about it as a bridge or as a port */
+static void vlan_link_cache_invalidate(vlan_link_cache_t *cache, const char *name)
+{
+  vlan_link_cache_entry_t *entry;
+  unsigned int i;
+
+  for (i = 0; i < VLAN_LINK_CACHE_SLOTS; i++)
+  {
+    entry = &cache->slots[i];
+    if (entry->valid && ((strcmp(entry->bridge, name) == 0) || (strcmp(entry->port, name) == 0)))
+    {
+      vlan_link_cache_write_begin(entry);
+      entry->valid = 0;
+      vlan_link_cache_write_end(entry);
+      cache->invalidations++;
+    }
+  }
+}
+
+static void vlan_link_cache_apply(vlan_link_cache_t *cache, struct nlmsghdr *hdr)
+{
+  struct ifinfomsg *ifi;
+  struct rtattr *attr;
+  char name[IFNAMSIZ];
+  int remaining;
+
+  if ((hdr->nlmsg_type != RTM_NEWLINK) && (hdr->nlmsg_type != RTM_DELLINK))
+  {
+    return;
+  }
+  if (hdr->nlmsg_len < NLMSG_LENGTH(sizeof(struct ifinfomsg)))
+  {
+    return;
+  }
+  ifi = NLMSG_DATA(hdr);
+  attr = IFLA_RTA(ifi);
+  remaining = (int)IFLA_PAYLOAD(hdr);
+  for (; RTA_OK(attr, remaining); attr = RTA_NEXT(attr, remaining))
+  {
+    if ((attr->rta_type == IFLA_IFNAME) && (RTA_PAYLOAD(attr) > 0))
+    {
+      size_t length = strnlen(RTA_DATA(attr), RTA_PAYLOAD(attr));
+
+      if (length >= IFNAMSIZ)
+      {
+        break;
+      }
+      memcpy(name, RTA_DATA(attr), length);
+      name[length] = '\0';
+      vlan_link_cache_invalidate(cache, name);
+      return;
+    }
+  }
+  /* A link notification we cannot attribute, be safe */
+  vlan_link_cache_flush(cache);
+}
+
+int vlan_link_cache_pending(const vlan_link_cache_t *cache)
+{
+  struct pollfd pfd;
+
+  if (cache == NULL)
+  {
+    return 0;
+  }
+  pfd.fd = __atomic_load_n(&cache->fd, __ATOMIC_ACQUIRE);
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  if (pfd.fd < 0)
+  {
+    return 0;
+  }
+  /* POLLHUP and POLLERR are left for the sync to report */
+  return (poll(&pfd, 1, 0) != 0);
+}
+
+uint32_t vlan_link_cache_generation(const vlan_link_cache_t *cache)
+{
+  return (cache != NULL) ? __atomic_load_n(&cache->generation, __ATOMIC_ACQUIRE) : 0;
+}
+
+int vlan_link_cache_sync(vlan_link_cache_t *cache)
+{
+  char buffer[VLAN_LINK_CACHE_RECV_SIZE] __attribute__((aligned(NLMSG_ALIGNTO)));
+  struct nlmsghdr *hdr;
+  ssize_t got;
+  int remaining;
+  int err;
+
+  if ((cache == NULL) || (cache->fd < 0))
+  {
+    return 0;
+  }
+  for (;;)
+  {
+    got = recv(cache->fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (got < 0)
+    {
+      if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+      {
+        return 0;
+      }
+      err = errno;
+      if (err == EINTR)
+      {
+        continue;
+      }
+      /* ENOBUFS: notifications were dropped, nothing cached can be trusted */
+      vlan_link_cache_flush(cache);
+      if (err == ENOBUFS)
+      {
+        continue;
+      }
+      return -err;
+    }
+    if (got == 0)
+    {
+      /* Peer gone, stop caching rather than serve answers nobody invalidates */
+      vlan_link_cache_flush(cache);
+      vlan_link_cache_close(cache);
+      return -EPIPE;
+    }
+    vlan_link_cache_changed(cache);
+    remaining = (int)got;
+    for (hdr = (struct nlmsghdr *)buffer; NLMSG_OK(hdr, remaining); hdr = NLMSG_NEXT(hdr, remaining))
+    {
+      vlan_link_cache_apply(cache, hdr);
+    }
+  }
+}
+
+static vlan_link_cache_entry_t *vlan_link_cache_slot(vlan_link_cache_t *cache, const char *bridge, const char *port,
+                                                     uint32_t *hash)
+{
+  *hash = vlan_group_table_hash(bridge) ^ (vlan_group_table_hash(port) * 31u);
+  return &cache->slots[*hash & (VLAN_LINK_CACHE_SLOTS - 1)];
+}
+
+int vlan_link_cache_get(vlan_link_cache_t *cache, const char *bridge, const char *port)
+{
+  vlan_link_cache_entry_t *entry;
+  vlan_link_cache_entry_t copy;
+  uint32_t sequence;
+  uint32_t hash;
+
+  if ((cache == NULL) || (__atomic_load_n(&cache->fd, __ATOMIC_ACQUIRE) < 0) || (bridge == NULL))
+  {
+    return -1;
+  }
+  if (port == NULL)
+  {
+    port = "";
+  }
+  entry = vlan_link_cache_slot(cache, bridge, port, &hash);
+  do
+  {
+    sequence = __atomic_load_n(&entry->sequence, __ATOMIC_ACQUIRE);
+    memcpy(&copy, entry, sizeof(copy));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  } while ((sequence & 1) || (__atomic_load_n(&entry->sequence, __ATOMIC_RELAXED) != sequence));
+
+  if (copy.valid && (copy.hash == hash) && (strncmp(copy.bridge, bridge, IFNAMSIZ) == 0) &&
+      (strncmp(copy.port, port, IFNAMSIZ) == 0))
+  {
+    __atomic_fetch_add(&cache->hits, 1, __ATOMIC_RELAXED);
+    return copy.answer;
+  }
+  __atomic_fetch_add(&cache->misses, 1, __ATOMIC_RELAXED);
+  return -1;
+}
+
+void vlan_link_cache_put(vlan_link_cache_t *cache, const char *bridge, const char *port, int answer)
+{
+  vlan_link_cache_entry_t *entry;
+  uint32_t hash;
+
+  if ((cache == NULL) || (cache->fd < 0) || (bridge == NULL) || ((answer != 0) && (answer != 1)))
+  {
+    return;
+  }
+  if (port == NULL)
+  {
+    port = "";
+  }
+  if ((strlen(bridge) >= IFNAMSIZ) || (strlen(port) >= IFNAMSIZ))
+  {
+    return;
+  }
+  entry = vlan_link_cache_slot(cache, bridge, port, &hash);
+  vlan_link_cache_write_begin(entry);
+  entry->hash = hash;
+  entry->answer = (int8_t)answer;
+  strcpy(entry->bridge, bridge);
+  strcpy(entry->port, port);
+  entry->valid = 1;
+  vlan_link_cache_write_end(entry);
+}
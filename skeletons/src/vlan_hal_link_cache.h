@@ -0,0 +1,134 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_link_cache.h
+ *
+ * Cache of bridge and bridge port existence answers, invalidated by
+ * rtnetlink link notifications (RTNLGRP_LINK).
+ *
+ * The kernel queues an RTM_NEWLINK or RTM_DELLINK on the subscribed socket
+ * before the change that caused it returns to user space. A query that finds
+ * the socket readable drains it first, so it sees every change made before
+ * it started, and an answer stays cached until a notification names the
+ * bridge or the port it is about. If notifications were lost (the socket
+ * overflowed) the whole cache is dropped.
+ *
+ * vlan_link_cache_pending(), vlan_link_cache_get() and
+ * vlan_link_cache_generation() take no lock and may run alongside each other
+ * and one updating call. Callers serialise the calls that update the cache:
+ * put, sync, flush and close. open and attach start the cache afresh and
+ * must not run alongside any other call.
+ */
+#ifndef __VLAN_HAL_LINK_CACHE_H__
+#define __VLAN_HAL_LINK_CACHE_H__
+
+#include <stdint.h>
+#include <net/if.h>
+
+/* Direct-mapped, a colliding query replaces the older answer */
+#define VLAN_LINK_CACHE_SLOTS 256
+
+typedef struct
+{
+  uint32_t sequence;            /*!< Odd while the entry is being rewritten */
+  uint32_t hash;
+  uint8_t valid;
+  int8_t answer;                /*!< 1 present, 0 absent */
+  char bridge[IFNAMSIZ];
+  char port[IFNAMSIZ];          /*!< "" for a bridge query */
+} vlan_link_cache_entry_t;
+
+typedef struct
+{
+  int fd;                       /*!< Subscribed socket, -1 disables caching */
+  uint32_t generation;          /*!< Bumped whenever notifications are applied or the cache is flushed */
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t invalidations;       /*!< Entries dropped by notifications */
+  vlan_link_cache_entry_t slots[VLAN_LINK_CACHE_SLOTS];
+} vlan_link_cache_t;
+
+/**
+ * @brief Subscribe a new NETLINK_ROUTE socket to RTNLGRP_LINK and start with an empty cache.
+ *
+ * @return 0 on success, negative errno on failure (the cache stays disabled).
+ */
+int vlan_link_cache_open(vlan_link_cache_t *cache);
+
+/**
+ * @brief Take notifications from @p fd instead, e.g. a socketpair fed by a test.
+ *
+ * @p fd must preserve message boundaries and is made non-blocking. Ownership
+ * passes to @p cache.
+ */
+void vlan_link_cache_attach(vlan_link_cache_t *cache, int fd);
+
+/**
+ * @brief Close the socket and disable the cache.
+ */
+void vlan_link_cache_close(vlan_link_cache_t *cache);
+
+/**
+ * @brief Drop every cached answer.
+ */
+void vlan_link_cache_flush(vlan_link_cache_t *cache);
+
+/**
+ * @brief Non-zero if notifications are waiting on the socket, or it failed.
+ *
+ * One poll() with no timeout, vlan_link_cache_sync() only needs to run when this is set.
+ */
+int vlan_link_cache_pending(const vlan_link_cache_t *cache);
+
+/**
+ * @brief Current generation, see vlan_link_cache_put().
+ */
+uint32_t vlan_link_cache_generation(const vlan_link_cache_t *cache);
+
+/**
+ * @brief Apply every notification queued on the socket, without blocking.
+ *
+ * @return 0 on success, negative errno if the socket failed (the cache is
+ *         flushed and stays usable unless the error persists).
+ */
+int vlan_link_cache_sync(vlan_link_cache_t *cache);
+
+/**
+ * @brief Look up a cached answer, after vlan_link_cache_sync() if notifications were pending.
+ *
+ * Lock-free, an entry rewritten during the probe is read again.
+ *
+ * @param[in] bridge - Bridge name
+ * @param[in] port - Port name, NULL for the bridge itself
+ *
+ * @return 1 or 0 when cached, -1 when the answer is not known (or caching is disabled).
+ */
+int vlan_link_cache_get(vlan_link_cache_t *cache, const char *bridge, const char *port);
+
+/**
+ * @brief Remember @p answer (1 or 0) for a query. Ignored while caching is disabled.
+ *
+ * An answer read from the system while the cache was unlocked may predate a
+ * notification applied meanwhile. Callers compare vlan_link_cache_generation()
+ * from before the read with the current one, after a sync, and only put the
+ * answer if they match.
+ */
+void vlan_link_cache_put(vlan_link_cache_t *cache, const char *bridge, const char *port, int answer);
+
+#endif /* __VLAN_HAL_LINK_CACHE_H__ */
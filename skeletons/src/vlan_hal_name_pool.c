@@ -0,0 +1,202 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <net/if.h>
+#include "vlan_hal_group_table.h"
+#include "vlan_hal_name_pool.h"
+
+#define VLAN_NAME_POOL_MIN_CAPACITY 64
+
+/*
+ * Chunk pointers are published with release stores and never change or get
+ * freed afterwards, which is all vlan_name_str() relies on. Offset 0 of
+ * chunk 0 holds the empty string so that VLAN_NAME_NONE resolves to "".
+ */
+static char *gChunks[VLAN_NAME_POOL_MAX_CHUNKS];
+static uint32_t gChunkCount;
+static uint32_t gChunkUsed = VLAN_NAME_POOL_CHUNK_SIZE;
+static size_t gBytes;
+
+/* Dedup index, only touched with gPoolLock held */
+static pthread_mutex_t gPoolLock = PTHREAD_MUTEX_INITIALIZER;
+static vlan_name_t *gHandles;
+static uint32_t *gHashes;
+static uint32_t gCapacity;
+static uint32_t gCount;
+
+const char *vlan_name_str(vlan_name_t name)
+{
+  const char *chunk;
+
+  if ((name >> 16) >= VLAN_NAME_POOL_MAX_CHUNKS)
+  {
+    return "";
+  }
+  chunk = __atomic_load_n(&gChunks[name >> 16], __ATOMIC_ACQUIRE);
+  return (chunk != NULL) ? &chunk[name & 0xffff] : "";
+}
+
+/* Returns the index slot holding @name, or the empty slot it belongs in */
+static uint32_t vlan_name_probe(const char *name, uint32_t hash)
+{
+  uint32_t mask = gCapacity - 1;
+  uint32_t i = hash & mask;
+
+  while ((gHandles[i] != VLAN_NAME_NONE) &&
+         ((gHashes[i] != hash) || (strcmp(vlan_name_str(gHandles[i]), name) != 0)))
+  {
+    i = (i + 1) & mask;
+  }
+  return i;
+}
+
+static int vlan_name_grow(void)
+{
+  uint32_t capacity = (gCapacity == 0) ? VLAN_NAME_POOL_MIN_CAPACITY : gCapacity * 2;
+  vlan_name_t *handles = calloc(capacity, sizeof(vlan_name_t));
+  uint32_t *hashes = calloc(capacity, sizeof(uint32_t));
+  vlan_name_t *oldHandles = gHandles;
+  uint32_t *oldHashes = gHashes;
+  uint32_t oldCapacity = gCapacity;
+  uint32_t i;
+  uint32_t slot;
+
+  if ((handles == NULL) || (hashes == NULL))
+  {
+    free(handles);
+    free(hashes);
+    return -1;
+  }
+  gHandles = handles;
+  gHashes = hashes;
+  gCapacity = capacity;
+  for (i = 0; i < oldCapacity; i++)
+  {
+    if (oldHandles[i] != VLAN_NAME_NONE)
+    {
+      slot = vlan_name_probe(vlan_name_str(oldHandles[i]), oldHashes[i]);
+      gHandles[slot] = oldHandles[i];
+      gHashes[slot] = oldHashes[i];
+    }
+  }
+  free(oldHandles);
+  free(oldHashes);
+  return 0;
+}
+
+/* Copies @length + 1 bytes of @name into the arena and returns their handle */
+static vlan_name_t vlan_name_store(const char *name, size_t length)
+{
+  char *chunk;
+
+  if (gChunkUsed + length + 1 > VLAN_NAME_POOL_CHUNK_SIZE)
+  {
+    if (gChunkCount == VLAN_NAME_POOL_MAX_CHUNKS)
+    {
+      return VLAN_NAME_NONE;
+    }
+    chunk = malloc(VLAN_NAME_POOL_CHUNK_SIZE);
+    if (chunk == NULL)
+    {
+      return VLAN_NAME_NONE;
+    }
+    gChunkUsed = 0;
+    if (gChunkCount == 0)
+    {
+      chunk[0] = '\0';
+      gChunkUsed = 1;
+    }
+    __atomic_store_n(&gChunks[gChunkCount++], chunk, __ATOMIC_RELEASE);
+  }
+  memcpy(&gChunks[gChunkCount - 1][gChunkUsed], name, length + 1);
+  gChunkUsed += length + 1;
+  gBytes += length + 1;
+  return ((gChunkCount - 1) << 16) | (gChunkUsed - length - 1);
+}
+
+vlan_name_t vlan_name_intern(const char *name)
+{
+  vlan_name_t handle = VLAN_NAME_NONE;
+  uint32_t hash;
+  uint32_t slot;
+  size_t length;
+
+  if (name == NULL)
+  {
+    return VLAN_NAME_NONE;
+  }
+  length = strnlen(name, IFNAMSIZ);
+  if ((length == 0) || (length >= IFNAMSIZ))
+  {
+    return VLAN_NAME_NONE;
+  }
+  hash = vlan_group_table_hash(name);
+
+  pthread_mutex_lock(&gPoolLock);
+  /* Keep the index at most half full so probes stay short */
+  if (((gCount + 1) * 2 <= gCapacity) || (vlan_name_grow() == 0))
+  {
+    slot = vlan_name_probe(name, hash);
+    handle = gHandles[slot];
+    if (handle == VLAN_NAME_NONE)
+    {
+      handle = vlan_name_store(name, length);
+      if (handle != VLAN_NAME_NONE)
+      {
+        gHandles[slot] = handle;
+        gHashes[slot] = hash;
+        gCount++;
+      }
+    }
+  }
+  pthread_mutex_unlock(&gPoolLock);
+  return handle;
+}
+
+vlan_name_t vlan_name_find(const char *name)
+{
+  vlan_name_t handle = VLAN_NAME_NONE;
+
+  if ((name == NULL) || (name[0] == '\0'))
+  {
+    return VLAN_NAME_NONE;
+  }
+  pthread_mutex_lock(&gPoolLock);
+  if (gCapacity != 0)
+  {
+    handle = gHandles[vlan_name_probe(name, vlan_group_table_hash(name))];
+  }
+  pthread_mutex_unlock(&gPoolLock);
+  return handle;
+}
+
+void vlan_name_pool_stats(uint32_t *count, size_t *bytes)
+{
+  pthread_mutex_lock(&gPoolLock);
+  if (count != NULL)
+  {
+    *count = gCount;
+  }
+  if (bytes != NULL)
+  {
+    *bytes = gBytes;
+  }
+  pthread_mutex_unlock(&gPoolLock);
+}
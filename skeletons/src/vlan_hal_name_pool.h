@@ -0,0 +1,78 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_name_pool.h
+ *
+ * Process-wide pool of interned interface and bridge names. Each distinct
+ * name is stored once in an append-only arena and referred to by a 32-bit
+ * handle, so the skeleton's tables hold handles instead of IFNAMSIZ buffers
+ * and two names are equal exactly when their handles are.
+ *
+ * Names are never freed: the pool grows with the number of distinct names
+ * ever interned, not with the number currently in use. For a HAL whose names
+ * come from a device's fixed set of bridges and ports that bound is small,
+ * and in exchange vlan_name_str() needs no lock and a handle stays valid for
+ * the lifetime of the process, including inside published RCU snapshots.
+ */
+#ifndef __VLAN_HAL_NAME_POOL_H__
+#define __VLAN_HAL_NAME_POOL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** Handle of an interned name, VLAN_NAME_NONE is the empty name */
+typedef uint32_t vlan_name_t;
+
+#define VLAN_NAME_NONE 0
+
+/** Arena chunk size, a handle is the chunk number above the 16-bit offset */
+#define VLAN_NAME_POOL_CHUNK_SIZE 65536
+#define VLAN_NAME_POOL_MAX_CHUNKS 1024
+
+/**
+ * @brief Intern @p name, returning the handle of its single copy.
+ *
+ * @p name must be non-empty and shorter than IFNAMSIZ. Safe to call from
+ * any thread, interning is serialised internally.
+ *
+ * @return The handle, or VLAN_NAME_NONE on an invalid name or when the pool is out of memory.
+ */
+vlan_name_t vlan_name_intern(const char *name);
+
+/**
+ * @brief Look up @p name without interning it.
+ *
+ * @return The handle, or VLAN_NAME_NONE if the name was never interned.
+ */
+vlan_name_t vlan_name_find(const char *name);
+
+/**
+ * @brief Resolve a handle to its NUL-terminated name.
+ *
+ * Lock-free, the returned string stays valid and unchanged for the lifetime
+ * of the process. VLAN_NAME_NONE resolves to "".
+ */
+const char *vlan_name_str(vlan_name_t name);
+
+/**
+ * @brief Report the number of interned names and the arena bytes they occupy.
+ */
+void vlan_name_pool_stats(uint32_t *count, size_t *bytes);
+
+#endif /* __VLAN_HAL_NAME_POOL_H__ */
@@ -0,0 +1,503 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include "vlan_hal_netlink.h"
+
+#define VLAN_NETLINK_REQUEST_SIZE 512
+#define VLAN_NETLINK_REPLY_SIZE 32768
+
+typedef struct
+{
+  struct nlmsghdr hdr;
+  struct ifinfomsg ifi;
+  char attrs[VLAN_NETLINK_REQUEST_SIZE];
+} vlan_netlink_request_t;
+
+static void vlan_netlink_init_request(vlan_netlink_request_t *req, uint16_t type, uint16_t flags)
+{
+  memset(req, 0, sizeof(*req));
+  req->hdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+  req->hdr.nlmsg_type = type;
+  req->hdr.nlmsg_flags = NLM_F_REQUEST | flags;
+  req->ifi.ifi_family = AF_UNSPEC;
+}
+
+static struct rtattr *vlan_netlink_put_attr(vlan_netlink_request_t *req, uint16_t type, const void *data, size_t len)
+{
+  struct rtattr *rta;
+  size_t offset = NLMSG_ALIGN(req->hdr.nlmsg_len);
+
+  if (offset + RTA_SPACE(len) > sizeof(*req))
+  {
+    return NULL;
+  }
+  rta = (struct rtattr *)((char *)req + offset);
+  rta->rta_type = type;
+  rta->rta_len = RTA_LENGTH(len);
+  if (len > 0)
+  {
+    memcpy(RTA_DATA(rta), data, len);
+  }
+  req->hdr.nlmsg_len = offset + RTA_SPACE(len);
+  return rta;
+}
+
+static int vlan_netlink_put_string(vlan_netlink_request_t *req, uint16_t type, const char *value)
+{
+  return (vlan_netlink_put_attr(req, type, value, strlen(value) + 1) != NULL) ? 0 : -EMSGSIZE;
+}
+
+static int vlan_netlink_put_ifname(vlan_netlink_request_t *req, const char *ifName)
+{
+  if ((ifName == NULL) || (ifName[0] == '\0') || (strlen(ifName) >= IFNAMSIZ))
+  {
+    return -EINVAL;
+  }
+  return vlan_netlink_put_string(req, IFLA_IFNAME, ifName);
+}
+
+static void vlan_netlink_end_nest(vlan_netlink_request_t *req, struct rtattr *nest)
+{
+  nest->rta_len = (unsigned short)(((char *)req + req->hdr.nlmsg_len) - (char *)nest);
+}
+
+/*
+ * Sends @count requests in a single sendmsg() and waits until every one of
+ * them has been answered. status[i] receives the NLMSG_ERROR code (0 or a
+ * negative errno); for an RTM_NEWLINK reply (to RTM_GETLINK) status[i] is 0
+ * and the link's index is stored in ifIndex[i] when @ifIndex is not NULL.
+ */
+static int vlan_netlink_exchange(vlan_netlink_t *nl, vlan_netlink_request_t *reqs, int count, int *status, int *ifIndex)
+{
+  struct iovec iov[VLAN_NETLINK_BATCH_MAX];
+  struct msghdr out;
+  char reply[VLAN_NETLINK_REPLY_SIZE];
+  struct nlmsghdr *msg;
+  uint32_t firstSeq;
+  uint32_t index;
+  ssize_t received;
+  ssize_t sent;
+  int remaining;
+  int pending;
+  int i;
+
+  if ((nl == NULL) || (nl->fd < 0))
+  {
+    return -EBADF;
+  }
+  if ((count <= 0) || (count > VLAN_NETLINK_BATCH_MAX))
+  {
+    return -EINVAL;
+  }
+
+  firstSeq = nl->seq + 1;
+  for (i = 0; i < count; i++)
+  {
+    reqs[i].hdr.nlmsg_seq = ++nl->seq;
+    iov[i].iov_base = &reqs[i];
+    iov[i].iov_len = reqs[i].hdr.nlmsg_len;
+    status[i] = 1;
+  }
+  memset(&out, 0, sizeof(out));
+  out.msg_iov = iov;
+  out.msg_iovlen = (size_t)count;
+
+  do
+  {
+    sent = sendmsg(nl->fd, &out, 0);
+  } while ((sent < 0) && (errno == EINTR));
+  if (sent < 0)
+  {
+    return -errno;
+  }
+
+  pending = count;
+  while (pending > 0)
+  {
+    received = recv(nl->fd, reply, sizeof(reply), 0);
+    if (received < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return -errno;
+    }
+    if (received == 0)
+    {
+      return -ECONNRESET;
+    }
+
+    remaining = (int)received;
+    for (msg = (struct nlmsghdr *)reply; NLMSG_OK(msg, remaining); msg = NLMSG_NEXT(msg, remaining))
+    {
+      index = msg->nlmsg_seq - firstSeq;
+      if ((index >= (uint32_t)count) || (status[index] <= 0))
+      {
+        continue;
+      }
+      if (msg->nlmsg_type == NLMSG_ERROR)
+      {
+        const struct nlmsgerr *err = (const struct nlmsgerr *)NLMSG_DATA(msg);
+
+        status[index] = (msg->nlmsg_len < NLMSG_LENGTH(sizeof(*err))) ? -EPROTO : err->error;
+      }
+      else if (msg->nlmsg_type == NLMSG_DONE)
+      {
+        status[index] = 0;
+      }
+      else if ((msg->nlmsg_type == RTM_NEWLINK) && (msg->nlmsg_len >= NLMSG_LENGTH(sizeof(struct ifinfomsg))))
+      {
+        if (ifIndex != NULL)
+        {
+          ifIndex[index] = ((const struct ifinfomsg *)NLMSG_DATA(msg))->ifi_index;
+        }
+        status[index] = 0;
+      }
+      else
+      {
+        continue;
+      }
+      pending--;
+    }
+  }
+  return 0;
+}
+
+/* Sends one request and waits for its answer, see vlan_netlink_exchange() */
+static int vlan_netlink_transact(vlan_netlink_t *nl, vlan_netlink_request_t *req, int *ifIndex)
+{
+  int status;
+  int ret;
+
+  ret = vlan_netlink_exchange(nl, req, 1, &status, ifIndex);
+  return (ret != 0) ? ret : status;
+}
+
+/* RTM_NEWLINK for an 802.1Q link, optionally enslaved to @master and brought up in the same request */
+static int vlan_netlink_build_vlan(vlan_netlink_request_t *req, const char *vlanIfName, uint32_t link, uint16_t vlanID, uint32_t master)
+{
+  struct rtattr *linkinfo;
+  struct rtattr *infodata;
+  int ret;
+
+  vlan_netlink_init_request(req, RTM_NEWLINK, NLM_F_ACK | NLM_F_CREATE | NLM_F_EXCL);
+  if ((ret = vlan_netlink_put_ifname(req, vlanIfName)) != 0)
+  {
+    return ret;
+  }
+  if (master != 0)
+  {
+    req->ifi.ifi_change = IFF_UP;
+    req->ifi.ifi_flags = IFF_UP;
+    if (vlan_netlink_put_attr(req, IFLA_MASTER, &master, sizeof(master)) == NULL)
+    {
+      return -EMSGSIZE;
+    }
+  }
+  if ((vlan_netlink_put_attr(req, IFLA_LINK, &link, sizeof(link)) == NULL) ||
+      ((linkinfo = vlan_netlink_put_attr(req, IFLA_LINKINFO, NULL, 0)) == NULL) ||
+      (vlan_netlink_put_string(req, IFLA_INFO_KIND, "vlan") != 0) ||
+      ((infodata = vlan_netlink_put_attr(req, IFLA_INFO_DATA, NULL, 0)) == NULL) ||
+      (vlan_netlink_put_attr(req, IFLA_VLAN_ID, &vlanID, sizeof(vlanID)) == NULL))
+  {
+    return -EMSGSIZE;
+  }
+  vlan_netlink_end_nest(req, infodata);
+  vlan_netlink_end_nest(req, linkinfo);
+  return 0;
+}
+
+int vlan_netlink_open(vlan_netlink_t *nl)
+{
+  struct sockaddr_nl local;
+
+  if (nl == NULL)
+  {
+    return -EINVAL;
+  }
+  nl->seq = 0;
+  nl->fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (nl->fd < 0)
+  {
+    return -errno;
+  }
+  memset(&local, 0, sizeof(local));
+  local.nl_family = AF_NETLINK;
+  if (bind(nl->fd, (struct sockaddr *)&local, sizeof(local)) < 0)
+  {
+    int err = -errno;
+
+    close(nl->fd);
+    nl->fd = -1;
+    return err;
+  }
+  return 0;
+}
+
+void vlan_netlink_attach(vlan_netlink_t *nl, int fd)
+{
+  if (nl == NULL)
+  {
+    return;
+  }
+  nl->fd = fd;
+  nl->seq = 0;
+}
+
+void vlan_netlink_close(vlan_netlink_t *nl)
+{
+  if ((nl == NULL) || (nl->fd < 0))
+  {
+    return;
+  }
+  close(nl->fd);
+  nl->fd = -1;
+}
+
+int vlan_netlink_get_ifindex(vlan_netlink_t *nl, const char *ifName, int *ifIndex)
+{
+  vlan_netlink_request_t req;
+  int ret;
+
+  if (ifIndex == NULL)
+  {
+    return -EINVAL;
+  }
+  vlan_netlink_init_request(&req, RTM_GETLINK, 0);
+  if ((ret = vlan_netlink_put_ifname(&req, ifName)) != 0)
+  {
+    return ret;
+  }
+  *ifIndex = 0;
+  ret = vlan_netlink_transact(nl, &req, ifIndex);
+  if ((ret == 0) && (*ifIndex <= 0))
+  {
+    return -ENODEV;
+  }
+  return ret;
+}
+
+int vlan_netlink_add_bridge(vlan_netlink_t *nl, const char *brName)
+{
+  vlan_netlink_request_t req;
+  struct rtattr *linkinfo;
+  int ret;
+
+  vlan_netlink_init_request(&req, RTM_NEWLINK, NLM_F_ACK | NLM_F_CREATE | NLM_F_EXCL);
+  if ((ret = vlan_netlink_put_ifname(&req, brName)) != 0)
+  {
+    return ret;
+  }
+  if ((linkinfo = vlan_netlink_put_attr(&req, IFLA_LINKINFO, NULL, 0)) == NULL)
+  {
+    return -EMSGSIZE;
+  }
+  if ((ret = vlan_netlink_put_string(&req, IFLA_INFO_KIND, "bridge")) != 0)
+  {
+    return ret;
+  }
+  vlan_netlink_end_nest(&req, linkinfo);
+  return vlan_netlink_transact(nl, &req, NULL);
+}
+
+int vlan_netlink_add_vlan(vlan_netlink_t *nl, const char *ifName, uint16_t vlanID, const char *vlanIfName)
+{
+  vlan_netlink_request_t req;
+  int parent;
+  int ret;
+
+  if ((ret = vlan_netlink_get_ifindex(nl, ifName, &parent)) != 0)
+  {
+    return ret;
+  }
+  if ((ret = vlan_netlink_build_vlan(&req, vlanIfName, (uint32_t)parent, vlanID, 0)) != 0)
+  {
+    return ret;
+  }
+  return vlan_netlink_transact(nl, &req, NULL);
+}
+
+int vlan_netlink_set_master(vlan_netlink_t *nl, const char *ifName, const char *brName)
+{
+  vlan_netlink_request_t req;
+  uint32_t master = 0;
+  int ret;
+
+  if (brName != NULL)
+  {
+    int brIndex;
+
+    if ((ret = vlan_netlink_get_ifindex(nl, brName, &brIndex)) != 0)
+    {
+      return ret;
+    }
+    master = (uint32_t)brIndex;
+  }
+
+  vlan_netlink_init_request(&req, RTM_SETLINK, NLM_F_ACK);
+  if ((ret = vlan_netlink_put_ifname(&req, ifName)) != 0)
+  {
+    return ret;
+  }
+  if (vlan_netlink_put_attr(&req, IFLA_MASTER, &master, sizeof(master)) == NULL)
+  {
+    return -EMSGSIZE;
+  }
+  return vlan_netlink_transact(nl, &req, NULL);
+}
+
+int vlan_netlink_set_up(vlan_netlink_t *nl, const char *ifName, int up)
+{
+  vlan_netlink_request_t req;
+  int ret;
+
+  vlan_netlink_init_request(&req, RTM_SETLINK, NLM_F_ACK);
+  req.ifi.ifi_change = IFF_UP;
+  req.ifi.ifi_flags = up ? IFF_UP : 0;
+  if ((ret = vlan_netlink_put_ifname(&req, ifName)) != 0)
+  {
+    return ret;
+  }
+  return vlan_netlink_transact(nl, &req, NULL);
+}
+
+int vlan_netlink_del_link(vlan_netlink_t *nl, const char *ifName)
+{
+  vlan_netlink_request_t req;
+  int ret;
+
+  vlan_netlink_init_request(&req, RTM_DELLINK, NLM_F_ACK);
+  if ((ret = vlan_netlink_put_ifname(&req, ifName)) != 0)
+  {
+    return ret;
+  }
+  return vlan_netlink_transact(nl, &req, NULL);
+}
+
+int vlan_netlink_add_vlan_ports(vlan_netlink_t *nl, const char *brName, vlan_netlink_port_t *ports, int count)
+{
+  vlan_netlink_request_t *reqs;
+  int status[VLAN_NETLINK_BATCH_MAX];
+  int ifIndex[VLAN_NETLINK_BATCH_MAX];
+  int slot[VLAN_NETLINK_BATCH_MAX];
+  uint32_t parent[VLAN_NETLINK_BATCH_MAX];
+  uint32_t master;
+  int used;
+  int ret;
+  int i;
+
+  if ((brName == NULL) || (ports == NULL) || (count <= 0) || (count >= VLAN_NETLINK_BATCH_MAX))
+  {
+    return -EINVAL;
+  }
+  reqs = malloc(sizeof(*reqs) * VLAN_NETLINK_BATCH_MAX);
+  if (reqs == NULL)
+  {
+    return -ENOMEM;
+  }
+
+  /* Round trip 1: resolve the bridge and every parent link */
+  vlan_netlink_init_request(&reqs[0], RTM_GETLINK, 0);
+  ret = vlan_netlink_put_ifname(&reqs[0], brName);
+  used = 1;
+  for (i = 0; (ret == 0) && (i < count); i++)
+  {
+    vlan_netlink_init_request(&reqs[used], RTM_GETLINK, 0);
+    ports[i].status = vlan_netlink_put_ifname(&reqs[used], ports[i].ifName);
+    if (ports[i].status == 0)
+    {
+      slot[used++] = i;
+    }
+  }
+  if ((ret == 0) && ((ret = vlan_netlink_exchange(nl, reqs, used, status, ifIndex)) == 0))
+  {
+    ret = status[0];
+  }
+  if (ret != 0)
+  {
+    free(reqs);
+    return ret;
+  }
+  master = (uint32_t)ifIndex[0];
+  for (i = 1; i < used; i++)
+  {
+    ports[slot[i]].status = status[i];
+    parent[slot[i]] = (uint32_t)ifIndex[i];
+  }
+
+  /* Round trip 2: create, enslave and bring up every resolvable port at once */
+  used = 0;
+  for (i = 0; i < count; i++)
+  {
+    if ((ports[i].status == 0) &&
+        ((ports[i].status = vlan_netlink_build_vlan(&reqs[used], ports[i].vlanIfName, parent[i], ports[i].vlanID, master)) == 0))
+    {
+      slot[used++] = i;
+    }
+  }
+  if ((used > 0) && ((ret = vlan_netlink_exchange(nl, reqs, used, status, NULL)) != 0))
+  {
+    free(reqs);
+    return ret;
+  }
+  for (i = 0; i < used; i++)
+  {
+    ports[slot[i]].status = status[i];
+  }
+
+  /* Round trip 3: ports that already existed only need enslaving and bringing up */
+  used = 0;
+  for (i = 0; i < count; i++)
+  {
+    if (ports[i].status != -EEXIST)
+    {
+      continue;
+    }
+    vlan_netlink_init_request(&reqs[used], RTM_SETLINK, NLM_F_ACK);
+    reqs[used].ifi.ifi_change = IFF_UP;
+    reqs[used].ifi.ifi_flags = IFF_UP;
+    if ((vlan_netlink_put_ifname(&reqs[used], ports[i].vlanIfName) != 0) ||
+        (vlan_netlink_put_attr(&reqs[used], IFLA_MASTER, &master, sizeof(master)) == NULL))
+    {
+      continue;
+    }
+    slot[used++] = i;
+  }
+  if ((used > 0) && ((ret = vlan_netlink_exchange(nl, reqs, used, status, NULL)) != 0))
+  {
+    free(reqs);
+    return ret;
+  }
+  for (i = 0; i < used; i++)
+  {
+    ports[slot[i]].status = status[i];
+  }
+
+  free(reqs);
+  return 0;
+}
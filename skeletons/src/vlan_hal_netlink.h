@@ -0,0 +1,111 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_netlink.h
+ *
+ * Minimal rtnetlink client used by the skeleton to create bridges and VLAN
+ * sub-interfaces and to enslave ports without forking a shell.
+ *
+ * Every request carries NLM_F_ACK and is answered synchronously, so the
+ * functions below return 0 on success or a negative errno reported by the
+ * peer (normally the kernel, or a fake peer on a socketpair in tests).
+ */
+#ifndef __VLAN_HAL_NETLINK_H__
+#define __VLAN_HAL_NETLINK_H__
+
+#include <stdint.h>
+
+/* Most requests sent in a single sendmsg(), bounded so replies fit the socket buffer */
+#define VLAN_NETLINK_BATCH_MAX 32
+
+typedef struct
+{
+  int fd;
+  uint32_t seq;
+} vlan_netlink_t;
+
+typedef struct
+{
+  const char *ifName;           /*!< Parent link */
+  const char *vlanIfName;       /*!< 802.1Q link to create on @ifName */
+  uint16_t vlanID;
+  int status;                   /*!< Out: 0 or negative errno for this port */
+} vlan_netlink_port_t;
+
+/**
+ * @brief Open a NETLINK_ROUTE socket.
+ *
+ * @return 0 on success, negative errno on failure.
+ */
+int vlan_netlink_open(vlan_netlink_t *nl);
+
+/**
+ * @brief Use an already connected, message-oriented socket as the netlink channel.
+ *
+ * Intended for tests that play the kernel side over a SOCK_SEQPACKET socketpair.
+ * Ownership of @p fd passes to @p nl.
+ */
+void vlan_netlink_attach(vlan_netlink_t *nl, int fd);
+
+void vlan_netlink_close(vlan_netlink_t *nl);
+
+/**
+ * @brief Resolve an interface name to its ifindex with RTM_GETLINK.
+ */
+int vlan_netlink_get_ifindex(vlan_netlink_t *nl, const char *ifName, int *ifIndex);
+
+/**
+ * @brief Create a bridge device (RTM_NEWLINK, kind "bridge").
+ */
+int vlan_netlink_add_bridge(vlan_netlink_t *nl, const char *brName);
+
+/**
+ * @brief Create the 802.1Q sub-interface @p vlanIfName on top of @p ifName (RTM_NEWLINK, kind "vlan").
+ */
+int vlan_netlink_add_vlan(vlan_netlink_t *nl, const char *ifName, uint16_t vlanID, const char *vlanIfName);
+
+/**
+ * @brief Enslave @p ifName to @p brName, or release it when @p brName is NULL (RTM_SETLINK, IFLA_MASTER).
+ */
+int vlan_netlink_set_master(vlan_netlink_t *nl, const char *ifName, const char *brName);
+
+/**
+ * @brief Set or clear IFF_UP on @p ifName (RTM_SETLINK).
+ */
+int vlan_netlink_set_up(vlan_netlink_t *nl, const char *ifName, int up);
+
+/**
+ * @brief Create up to VLAN_NETLINK_BATCH_MAX - 1 VLAN ports, enslave them to @p brName and bring them up.
+ *
+ * All parent links and the bridge are resolved in one round trip and all
+ * ports are created (RTM_NEWLINK carrying IFLA_MASTER and IFF_UP) in a
+ * second one. Ports that already exist are enslaved with a third batched
+ * RTM_SETLINK. Each port's outcome is reported in its status field.
+ *
+ * @return 0 when the batch was exchanged (check per-port status), negative
+ *         errno if the bridge could not be resolved or the channel failed.
+ */
+int vlan_netlink_add_vlan_ports(vlan_netlink_t *nl, const char *brName, vlan_netlink_port_t *ports, int count);
+
+/**
+ * @brief Delete a link by name (RTM_DELLINK).
+ */
+int vlan_netlink_del_link(vlan_netlink_t *nl, const char *ifName);
+
+#endif /* __VLAN_HAL_NETLINK_H__ */
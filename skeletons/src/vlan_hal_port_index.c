@@ -0,0 +1,230 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include <stdlib.h>
+#include "vlan_hal_group_table.h"
+#include "vlan_hal_port_index.h"
+
+static int vlan_port_index_alloc(vlan_port_index_t *index, uint32_t count)
+{
+  uint32_t capacity = VLAN_PORT_INDEX_MIN_CAPACITY;
+
+  /* Keep the load factor below 3/4 for the requested number of ports */
+  while ((capacity / 4) * 3 < count)
+  {
+    capacity <<= 1;
+  }
+  index->slots = calloc(capacity, sizeof(vlan_port_entry_t));
+  if (index->slots == NULL)
+  {
+    index->capacity = 0;
+    return -1;
+  }
+  index->capacity = capacity;
+  index->count = 0;
+  index->tombstones = 0;
+  return 0;
+}
+
+void vlan_port_index_deinit(vlan_port_index_t *index)
+{
+  if (index == NULL)
+  {
+    return;
+  }
+  free(index->slots);
+  index->slots = NULL;
+  index->capacity = 0;
+  index->count = 0;
+  index->tombstones = 0;
+}
+
+int vlan_port_index_copy(vlan_port_index_t *copy, const vlan_port_index_t *index)
+{
+  if ((copy == NULL) || (index == NULL))
+  {
+    return -1;
+  }
+  *copy = *index;
+  if (index->slots == NULL)
+  {
+    return 0;
+  }
+  copy->slots = malloc(index->capacity * sizeof(vlan_port_entry_t));
+  if (copy->slots == NULL)
+  {
+    copy->capacity = 0;
+    copy->count = 0;
+    copy->tombstones = 0;
+    return -1;
+  }
+  memcpy(copy->slots, index->slots, index->capacity * sizeof(vlan_port_entry_t));
+  return 0;
+}
+
+/* Same probing scheme as vlan_group_probe(): match, else first reusable slot */
+static vlan_port_entry_t *vlan_port_probe(const vlan_port_index_t *index, const char *port, uint32_t hash)
+{
+  uint32_t mask = index->capacity - 1;
+  uint32_t i = hash & mask;
+  vlan_port_entry_t *reuse = NULL;
+  vlan_port_entry_t *slot;
+
+  for (;;)
+  {
+    slot = &index->slots[i];
+    if (slot->state == VLAN_PORT_SLOT_EMPTY)
+    {
+      return (reuse != NULL) ? reuse : slot;
+    }
+    if (slot->state == VLAN_PORT_SLOT_DELETED)
+    {
+      if (reuse == NULL)
+      {
+        reuse = slot;
+      }
+    }
+    else if ((slot->hash == hash) && (strcmp(vlan_name_str(slot->port), port) == 0))
+    {
+      return slot;
+    }
+    i = (i + 1) & mask;
+  }
+}
+
+static int vlan_port_index_rehash(vlan_port_index_t *index, uint32_t count)
+{
+  vlan_port_index_t resized;
+  vlan_port_entry_t *slot;
+  uint32_t i;
+
+  if (vlan_port_index_alloc(&resized, count) != 0)
+  {
+    return -1;
+  }
+  for (i = 0; i < index->capacity; i++)
+  {
+    if (index->slots[i].state != VLAN_PORT_SLOT_USED)
+    {
+      continue;
+    }
+    slot = vlan_port_probe(&resized, vlan_name_str(index->slots[i].port), index->slots[i].hash);
+    *slot = index->slots[i];
+    resized.count++;
+  }
+  free(index->slots);
+  *index = resized;
+  return 0;
+}
+
+vlan_port_entry_t *vlan_port_index_find(const vlan_port_index_t *index, const char *port)
+{
+  vlan_port_entry_t *slot;
+
+  if ((index == NULL) || (index->slots == NULL) || (port == NULL))
+  {
+    return NULL;
+  }
+  slot = vlan_port_probe(index, port, vlan_group_table_hash(port));
+  return (slot->state == VLAN_PORT_SLOT_USED) ? slot : NULL;
+}
+
+int vlan_port_index_insert(vlan_port_index_t *index, const char *port, const char *ifName, uint16_t vlanID, const char *bridge)
+{
+  vlan_port_entry_t *slot;
+  vlan_name_t portHandle;
+  vlan_name_t ifHandle;
+  vlan_name_t bridgeHandle;
+  uint32_t hash;
+
+  if (index == NULL)
+  {
+    return -1;
+  }
+  /* Interning rejects NULL, empty and overlong names */
+  portHandle = vlan_name_intern(port);
+  ifHandle = vlan_name_intern(ifName);
+  bridgeHandle = vlan_name_intern(bridge);
+  if ((portHandle == VLAN_NAME_NONE) || (ifHandle == VLAN_NAME_NONE) || (bridgeHandle == VLAN_NAME_NONE))
+  {
+    return -1;
+  }
+  if ((index->slots == NULL) && (vlan_port_index_alloc(index, 0) != 0))
+  {
+    return -1;
+  }
+
+  hash = vlan_group_table_hash(port);
+  slot = vlan_port_probe(index, port, hash);
+  if (slot->state != VLAN_PORT_SLOT_USED)
+  {
+    /* Grow (or just sweep tombstones) before the index passes 3/4 occupancy */
+    if ((index->count + index->tombstones + 1) > (index->capacity / 4) * 3)
+    {
+      if (vlan_port_index_rehash(index, index->count + 1) != 0)
+      {
+        return -1;
+      }
+      slot = vlan_port_probe(index, port, hash);
+    }
+    if (slot->state == VLAN_PORT_SLOT_DELETED)
+    {
+      index->tombstones--;
+    }
+    slot->hash = hash;
+    slot->state = VLAN_PORT_SLOT_USED;
+    slot->port = portHandle;
+    index->count++;
+  }
+  slot->vlanID = vlanID;
+  slot->ifName = ifHandle;
+  slot->bridge = bridgeHandle;
+  return 0;
+}
+
+int vlan_port_index_remove(vlan_port_index_t *index, const char *port)
+{
+  vlan_port_entry_t *slot = vlan_port_index_find(index, port);
+
+  if (slot == NULL)
+  {
+    return -1;
+  }
+  slot->state = VLAN_PORT_SLOT_DELETED;
+  index->count--;
+  index->tombstones++;
+  return 0;
+}
+
+vlan_port_entry_t *vlan_port_index_next(const vlan_port_index_t *index, uint32_t *cursor)
+{
+  if ((index == NULL) || (cursor == NULL))
+  {
+    return NULL;
+  }
+  while (*cursor < index->capacity)
+  {
+    vlan_port_entry_t *slot = &index->slots[(*cursor)++];
+
+    if (slot->state == VLAN_PORT_SLOT_USED)
+    {
+      return slot;
+    }
+  }
+  return NULL;
+}
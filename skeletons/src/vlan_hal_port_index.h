@@ -0,0 +1,108 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_port_index.h
+ *
+ * Reverse index from a VLAN port ("<ifName>.<vlanID>") to the bridge it is
+ * enslaved to. The skeleton HAL keeps it in step with addInterface(),
+ * delInterface() and friends so that the _is_this_interface_available_*()
+ * queries are a single hash probe instead of a scan over every bridge.
+ */
+#ifndef __VLAN_HAL_PORT_INDEX_H__
+#define __VLAN_HAL_PORT_INDEX_H__
+
+#include <stdint.h>
+#include <net/if.h>
+#include "vlan_hal_name_pool.h"
+
+#define VLAN_PORT_INDEX_MIN_CAPACITY 32
+
+typedef enum
+{
+  VLAN_PORT_SLOT_EMPTY = 0,
+  VLAN_PORT_SLOT_USED,
+  VLAN_PORT_SLOT_DELETED
+} vlan_port_slot_state_t;
+
+typedef struct
+{
+  uint32_t hash;
+  uint16_t vlanID;
+  uint8_t state;                /*!< vlan_port_slot_state_t */
+  vlan_name_t port;             /*!< Key, "<ifName>.<vlanID>" */
+  vlan_name_t ifName;
+  vlan_name_t bridge;           /*!< Equal to the name handle of the bridge's group entry */
+} vlan_port_entry_t;
+
+typedef struct
+{
+  vlan_port_entry_t *slots;
+  uint32_t capacity;            /*!< Always a power of two */
+  uint32_t count;               /*!< Slots in VLAN_PORT_SLOT_USED state */
+  uint32_t tombstones;          /*!< Slots in VLAN_PORT_SLOT_DELETED state */
+} vlan_port_index_t;
+
+/**
+ * @brief Release the slot array. The index may be used again afterwards.
+ */
+void vlan_port_index_deinit(vlan_port_index_t *index);
+
+/**
+ * @brief Initialise @p copy as an independent duplicate of @p index.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int vlan_port_index_copy(vlan_port_index_t *copy, const vlan_port_index_t *index);
+
+/**
+ * @brief Look up a port by its "<ifName>.<vlanID>" name.
+ *
+ * @return Pointer to the live entry, or NULL if the port is in no bridge.
+ *         The pointer is invalidated by the next insert or remove.
+ */
+vlan_port_entry_t *vlan_port_index_find(const vlan_port_index_t *index, const char *port);
+
+/**
+ * @brief Record that @p port (built from @p ifName and @p vlanID) belongs to @p bridge.
+ *
+ * A port already in the index is moved to @p bridge, as the kernel does when
+ * a link is enslaved to a different master.
+ *
+ * All three names are interned in the name pool.
+ *
+ * @return 0 on success, -1 on an empty name, one that does not fit IFNAMSIZ or allocation failure.
+ */
+int vlan_port_index_insert(vlan_port_index_t *index, const char *port, const char *ifName, uint16_t vlanID, const char *bridge);
+
+/**
+ * @brief Forget a port.
+ *
+ * @return 0 if the port was removed, -1 if it was not present.
+ */
+int vlan_port_index_remove(vlan_port_index_t *index, const char *port);
+
+/**
+ * @brief Iterate over live entries in slot order.
+ *
+ * Start with @p *cursor set to 0 and call until NULL is returned. Removing
+ * the entry just returned does not disturb the iteration.
+ */
+vlan_port_entry_t *vlan_port_index_next(const vlan_port_index_t *index, uint32_t *cursor);
+
+#endif /* __VLAN_HAL_PORT_INDEX_H__ */
@@ -0,0 +1,141 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <sched.h>
+#include "vlan_hal_rcu.h"
+
+/* One cache line per reader so readers do not contend on each other's stores */
+typedef struct
+{
+  uint64_t epoch;               /*!< Epoch observed at read_lock, 0 when outside a section */
+  uint32_t claimed;
+  char pad[64 - sizeof(uint64_t) - sizeof(uint32_t)];
+} vlan_rcu_slot_t;
+
+static vlan_rcu_slot_t gSlots[VLAN_RCU_MAX_READERS] __attribute__((aligned(64)));
+static uint64_t gEpoch = 1;
+/* Readers in a section that could not claim a slot */
+static uint32_t gOverflow = 0;
+
+static pthread_once_t gKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t gKey;
+
+#define VLAN_RCU_NO_SLOT -2
+#define VLAN_RCU_UNASSIGNED -1
+
+static __thread int tSlot = VLAN_RCU_UNASSIGNED;
+static __thread unsigned int tNesting = 0;
+
+static void vlan_rcu_thread_exit(void *value)
+{
+  vlan_rcu_slot_t *slot = value;
+
+  __atomic_store_n(&slot->claimed, 0, __ATOMIC_RELEASE);
+}
+
+static void vlan_rcu_make_key(void)
+{
+  pthread_key_create(&gKey, vlan_rcu_thread_exit);
+}
+
+static int vlan_rcu_claim_slot(void)
+{
+  uint32_t expected;
+  int i;
+
+  pthread_once(&gKeyOnce, vlan_rcu_make_key);
+  for (i = 0; i < VLAN_RCU_MAX_READERS; i++)
+  {
+    expected = 0;
+    if (__atomic_compare_exchange_n(&gSlots[i].claimed, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+      /* The destructor hands the slot back when this thread exits */
+      pthread_setspecific(gKey, &gSlots[i]);
+      return i;
+    }
+  }
+  return VLAN_RCU_NO_SLOT;
+}
+
+void vlan_rcu_read_lock(void)
+{
+  if (tNesting++ > 0)
+  {
+    return;
+  }
+  if (tSlot == VLAN_RCU_UNASSIGNED)
+  {
+    tSlot = vlan_rcu_claim_slot();
+  }
+  /* Sequentially consistent so the snapshot load that follows cannot move above it */
+  if (tSlot >= 0)
+  {
+    __atomic_store_n(&gSlots[tSlot].epoch, __atomic_load_n(&gEpoch, __ATOMIC_RELAXED), __ATOMIC_SEQ_CST);
+  }
+  else
+  {
+    __atomic_add_fetch(&gOverflow, 1, __ATOMIC_SEQ_CST);
+  }
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void vlan_rcu_read_unlock(void)
+{
+  if (--tNesting > 0)
+  {
+    return;
+  }
+  if (tSlot >= 0)
+  {
+    __atomic_store_n(&gSlots[tSlot].epoch, 0, __ATOMIC_RELEASE);
+  }
+  else
+  {
+    __atomic_sub_fetch(&gOverflow, 1, __ATOMIC_RELEASE);
+  }
+}
+
+int vlan_rcu_synchronize(void)
+{
+  uint64_t epoch;
+  uint64_t observed;
+  int i;
+
+  if (tNesting != 0)
+  {
+    return -EDEADLK;
+  }
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  epoch = __atomic_add_fetch(&gEpoch, 1, __ATOMIC_SEQ_CST);
+  for (i = 0; i < VLAN_RCU_MAX_READERS; i++)
+  {
+    /* A reader that entered after the increment can only see the new snapshot */
+    while (((observed = __atomic_load_n(&gSlots[i].epoch, __ATOMIC_SEQ_CST)) != 0) && (observed < epoch))
+    {
+      sched_yield();
+    }
+  }
+  while (__atomic_load_n(&gOverflow, __ATOMIC_ACQUIRE) != 0)
+  {
+    sched_yield();
+  }
+  return 0;
+}
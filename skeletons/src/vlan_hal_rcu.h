@@ -0,0 +1,59 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_rcu.h
+ *
+ * Minimal read-copy-update support for the skeleton HAL.
+ *
+ * Writers build a new immutable snapshot, publish it with an atomic pointer
+ * swap and call vlan_rcu_synchronize() before freeing the old one. Readers
+ * bracket their use of a snapshot with vlan_rcu_read_lock() / unlock(),
+ * which only store to a per-thread slot: readers never wait on writers or
+ * on each other.
+ *
+ * Each reading thread claims one of VLAN_RCU_MAX_READERS slots on first use
+ * and releases it when the thread exits. Threads beyond that share a single
+ * counter, which is still wait-free for them but may delay writers.
+ */
+#ifndef __VLAN_HAL_RCU_H__
+#define __VLAN_HAL_RCU_H__
+
+#define VLAN_RCU_MAX_READERS 64
+
+/**
+ * @brief Enter a read-side critical section. Sections may nest.
+ */
+void vlan_rcu_read_lock(void);
+
+/**
+ * @brief Leave a read-side critical section.
+ */
+void vlan_rcu_read_unlock(void);
+
+/**
+ * @brief Wait until every read-side section that started before the call has ended.
+ *
+ * Called from inside a read-side section it would wait for itself forever,
+ * so it fails instead.
+ *
+ * @return 0 once every earlier section has ended, -EDEADLK if the calling thread is in a section.
+ */
+int vlan_rcu_synchronize(void);
+
+#endif /* __VLAN_HAL_RCU_H__ */
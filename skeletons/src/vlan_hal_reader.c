@@ -0,0 +1,192 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "vlan_hal_reader.h"
+
+/* Smallest arena allocation, enough for typical brctl/ip output */
+#define VLAN_READER_ARENA_MIN 1024
+
+static long vlan_reader_read(int fd, char *buffer, size_t size)
+{
+  ssize_t got;
+
+  do
+  {
+    got = read(fd, buffer, size);
+  } while ((got < 0) && (errno == EINTR));
+  return (got < 0) ? -errno : (long)got;
+}
+
+int vlan_reader_lines(int fd, char *buffer, size_t size, vlan_reader_line_fn fn, void *ctx)
+{
+  char chunk[VLAN_READER_CHUNK];
+  size_t used = 0;
+  char *line;
+  char *newline;
+  long got;
+  int ret;
+
+  if (buffer == NULL)
+  {
+    buffer = chunk;
+    size = sizeof(chunk);
+  }
+  if ((fd < 0) || (size < 2))
+  {
+    return -EINVAL;
+  }
+
+  for (;;)
+  {
+    /* Keep one byte spare to terminate a line that ends the buffer */
+    got = vlan_reader_read(fd, buffer + used, size - 1 - used);
+    if (got < 0)
+    {
+      return (int)got;
+    }
+    if (got == 0)
+    {
+      break;
+    }
+    if (fn == NULL)
+    {
+      continue;
+    }
+    used += (size_t)got;
+
+    line = buffer;
+    while ((newline = memchr(line, '\n', used - (size_t)(line - buffer))) != NULL)
+    {
+      *newline = '\0';
+      ret = fn(ctx, line, (size_t)(newline - line));
+      if (ret != 0)
+      {
+        return ret;
+      }
+      line = newline + 1;
+    }
+    used -= (size_t)(line - buffer);
+    if (used == size - 1)
+    {
+      /* Overlong line, hand over what fits */
+      buffer[used] = '\0';
+      ret = fn(ctx, buffer, used);
+      if (ret != 0)
+      {
+        return ret;
+      }
+      used = 0;
+    }
+    else if ((used != 0) && (line != buffer))
+    {
+      /* Only the unfinished tail of the chunk moves */
+      memmove(buffer, line, used);
+    }
+  }
+
+  if ((fn != NULL) && (used != 0))
+  {
+    buffer[used] = '\0';
+    return fn(ctx, buffer, used);
+  }
+  return 0;
+}
+
+long vlan_reader_fill(int fd, char *buffer, size_t size)
+{
+  size_t used = 0;
+  long got;
+
+  if ((fd < 0) || (buffer == NULL))
+  {
+    return -EINVAL;
+  }
+  while (used < size)
+  {
+    got = vlan_reader_read(fd, buffer + used, size - used);
+    if (got < 0)
+    {
+      return got;
+    }
+    if (got == 0)
+    {
+      break;
+    }
+    used += (size_t)got;
+  }
+  return (long)used;
+}
+
+int vlan_reader_slurp(int fd, vlan_reader_arena_t *arena)
+{
+  size_t capacity;
+  char *data;
+  long got;
+
+  if ((fd < 0) || (arena == NULL))
+  {
+    return -EINVAL;
+  }
+  arena->length = 0;
+  for (;;)
+  {
+    if (arena->capacity - arena->length < 2)
+    {
+      capacity = (arena->capacity < VLAN_READER_ARENA_MIN) ? VLAN_READER_ARENA_MIN : arena->capacity * 2;
+      data = realloc(arena->data, capacity);
+      if (data == NULL)
+      {
+        if (arena->data != NULL)
+        {
+          arena->data[arena->length] = '\0';
+        }
+        return -ENOMEM;
+      }
+      arena->data = data;
+      arena->capacity = capacity;
+    }
+    got = vlan_reader_read(fd, arena->data + arena->length, arena->capacity - arena->length - 1);
+    if (got < 0)
+    {
+      arena->data[arena->length] = '\0';
+      return (int)got;
+    }
+    if (got == 0)
+    {
+      break;
+    }
+    arena->length += (size_t)got;
+  }
+  arena->data[arena->length] = '\0';
+  return 0;
+}
+
+void vlan_reader_arena_release(vlan_reader_arena_t *arena)
+{
+  if (arena == NULL)
+  {
+    return;
+  }
+  free(arena->data);
+  arena->data = NULL;
+  arena->length = 0;
+  arena->capacity = 0;
+}
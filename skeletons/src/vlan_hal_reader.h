@@ -0,0 +1,97 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_reader.h
+ *
+ * Reads command output from a pipe descriptor without the size limit of
+ * _get_shell_outputbuffer_res().
+ *
+ * vlan_reader_lines() read()s large chunks into one buffer and hands each
+ * line to a callback as a slice of that buffer, so nothing is copied per
+ * line. vlan_reader_slurp() collects the whole output into a single
+ * growable allocation that can be reused across commands.
+ */
+#ifndef __VLAN_HAL_READER_H__
+#define __VLAN_HAL_READER_H__
+
+#include <stddef.h>
+
+/* Buffer used by vlan_reader_lines() when the caller does not supply one */
+#define VLAN_READER_CHUNK 4096
+
+/**
+ * @brief Receives one line, without its '\n' and NUL-terminated.
+ *
+ * @p line points into the reader's buffer and is only valid for the call,
+ * the callback may modify it in place.
+ *
+ * @return 0 to continue, a positive value to stop reading.
+ */
+typedef int (*vlan_reader_line_fn)(void *ctx, char *line, size_t length);
+
+typedef struct
+{
+  char *data;                   /*!< Output, NUL-terminated, owned by the arena */
+  size_t length;                /*!< Bytes of output, excluding the terminator */
+  size_t capacity;              /*!< Allocated size of data */
+} vlan_reader_arena_t;
+
+#define VLAN_READER_ARENA_INIT { NULL, 0, 0 }
+
+/**
+ * @brief Split everything readable from @p fd into lines.
+ *
+ * A final line without '\n' is delivered at end of input. A line that does
+ * not fit in @p size - 1 bytes is delivered in pieces of that length.
+ *
+ * @param[in] fd - Descriptor to read until end of input
+ * @param[in] buffer - Working buffer, NULL to use an internal VLAN_READER_CHUNK one
+ * @param[in] size - Size of @p buffer, at least 2
+ * @param[in] fn - Line callback, NULL to discard the input
+ * @param[in] ctx - Passed to @p fn
+ *
+ * @return 0 at end of input, the callback's value if it stopped the read,
+ *         negative errno on a read error or invalid arguments.
+ */
+int vlan_reader_lines(int fd, char *buffer, size_t size, vlan_reader_line_fn fn, void *ctx);
+
+/**
+ * @brief Read up to @p size bytes from @p fd into @p buffer, stopping early only at end of input.
+ *
+ * @return Bytes read, or negative errno.
+ */
+long vlan_reader_fill(int fd, char *buffer, size_t size);
+
+/**
+ * @brief Read everything from @p fd into @p arena, replacing its previous contents.
+ *
+ * The allocation grows geometrically and is kept between calls, so reusing
+ * an arena for repeated commands stops allocating once it is large enough.
+ *
+ * @return 0 on success, negative errno on a read or allocation failure
+ *         (the output read so far is kept).
+ */
+int vlan_reader_slurp(int fd, vlan_reader_arena_t *arena);
+
+/**
+ * @brief Free the arena's allocation. The arena may be reused afterwards.
+ */
+void vlan_reader_arena_release(vlan_reader_arena_t *arena);
+
+#endif /* __VLAN_HAL_READER_H__ */
@@ -0,0 +1,228 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "vlan_hal_spawn.h"
+
+extern char **environ;
+
+/*
+ * Start @argv with @childEnd as its descriptor @target and, unless negative,
+ * @errFd as its stderr. @childEnd is always closed, @errFd never is.
+ */
+static int vlan_spawn_connected(vlan_spawn_t *child, const char *const argv[], int childEnd, int target, int errFd)
+{
+  posix_spawn_file_actions_t actions;
+  posix_spawnattr_t attr;
+  int ret;
+
+  ret = posix_spawn_file_actions_init(&actions);
+  if (ret != 0)
+  {
+    goto close_end;
+  }
+  ret = posix_spawn_file_actions_adddup2(&actions, childEnd, target);
+  if ((ret == 0) && (errFd >= 0))
+  {
+    ret = posix_spawn_file_actions_adddup2(&actions, errFd, STDERR_FILENO);
+  }
+  if (ret != 0)
+  {
+    goto destroy_actions;
+  }
+  ret = posix_spawnattr_init(&attr);
+  if (ret != 0)
+  {
+    goto destroy_actions;
+  }
+#ifdef POSIX_SPAWN_USEVFORK
+  /* Implied by current glibc, which always spawns from a CLONE_VM child */
+  ret = posix_spawnattr_setflags(&attr, POSIX_SPAWN_USEVFORK);
+  if (ret != 0)
+  {
+    goto destroy_attr;
+  }
+#endif
+  ret = posix_spawnp(&child->pid, argv[0], &actions, &attr, (char *const *)argv, environ);
+
+#ifdef POSIX_SPAWN_USEVFORK
+destroy_attr:
+#endif
+  posix_spawnattr_destroy(&attr);
+destroy_actions:
+  posix_spawn_file_actions_destroy(&actions);
+close_end:
+  close(childEnd);
+  if (ret != 0)
+  {
+    child->pid = -1;
+    return -ret;
+  }
+  return 0;
+}
+
+int vlan_spawn_start(vlan_spawn_t *child, const char *const argv[])
+{
+  int pipeFd[2];
+  int ret;
+
+  if ((child == NULL) || (argv == NULL) || (argv[0] == NULL))
+  {
+    return -EINVAL;
+  }
+  /* Both ends close-on-exec, the dup2 onto stdout clears the flag for the child */
+  if (pipe2(pipeFd, O_CLOEXEC) != 0)
+  {
+    return -errno;
+  }
+  ret = vlan_spawn_connected(child, argv, pipeFd[1], STDOUT_FILENO, -1);
+  if (ret != 0)
+  {
+    close(pipeFd[0]);
+    child->fd = -1;
+    return ret;
+  }
+  child->fd = pipeFd[0];
+  return 0;
+}
+
+int vlan_spawn_feed(const char *const argv[], const char *data, size_t length)
+{
+  return vlan_spawn_feed_errors(argv, data, length, -1);
+}
+
+int vlan_spawn_feed_errors(const char *const argv[], const char *data, size_t length, int errFd)
+{
+  vlan_spawn_t child;
+  int channel[2];
+  size_t sent = 0;
+  ssize_t written;
+  int ret;
+
+  if ((argv == NULL) || (argv[0] == NULL) || ((data == NULL) && (length != 0)))
+  {
+    return -EINVAL;
+  }
+  /* A socket rather than a pipe, so MSG_NOSIGNAL spares us SIGPIPE if the command exits early */
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, channel) != 0)
+  {
+    return -errno;
+  }
+  ret = vlan_spawn_connected(&child, argv, channel[1], STDIN_FILENO, errFd);
+  if (ret != 0)
+  {
+    close(channel[0]);
+    return ret;
+  }
+  child.fd = channel[0];
+  while (sent < length)
+  {
+    written = send(child.fd, data + sent, length - sent, MSG_NOSIGNAL);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      /* The command stopped reading, its exit status tells why */
+      break;
+    }
+    sent += (size_t)written;
+  }
+  return vlan_spawn_wait(&child);
+}
+
+int vlan_spawn_wait(vlan_spawn_t *child)
+{
+  int status;
+
+  if ((child == NULL) || (child->pid <= 0))
+  {
+    return -EINVAL;
+  }
+  if (child->fd >= 0)
+  {
+    close(child->fd);
+    child->fd = -1;
+  }
+  while (waitpid(child->pid, &status, 0) < 0)
+  {
+    if (errno != EINTR)
+    {
+      return -errno;
+    }
+  }
+  child->pid = -1;
+  if (WIFSIGNALED(status))
+  {
+    return 128 + WTERMSIG(status);
+  }
+  return WEXITSTATUS(status);
+}
+
+int vlan_spawn_lines(const char *const argv[], vlan_reader_line_fn fn, void *ctx)
+{
+  vlan_spawn_t child;
+  int ret;
+
+  ret = vlan_spawn_start(&child, argv);
+  if (ret != 0)
+  {
+    return ret;
+  }
+  ret = vlan_reader_lines(child.fd, NULL, 0, fn, ctx);
+  if (ret > 0)
+  {
+    vlan_reader_lines(child.fd, NULL, 0, NULL, NULL);
+  }
+  else if (ret < 0)
+  {
+    vlan_spawn_wait(&child);
+    return ret;
+  }
+  return vlan_spawn_wait(&child);
+}
+
+int vlan_spawn_output(const char *const argv[], vlan_reader_arena_t *arena)
+{
+  vlan_spawn_t child;
+  int ret;
+
+  if (arena == NULL)
+  {
+    return -EINVAL;
+  }
+  ret = vlan_spawn_start(&child, argv);
+  if (ret != 0)
+  {
+    return ret;
+  }
+  ret = vlan_reader_slurp(child.fd, arena);
+  if (ret != 0)
+  {
+    /* Still reap the child, then report the read failure */
+    vlan_spawn_wait(&child);
+    return ret;
+  }
+  return vlan_spawn_wait(&child);
+}
@@ -0,0 +1,94 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_spawn.h
+ *
+ * Runs a command from an argv array with posix_spawnp(), without a shell.
+ *
+ * popen() costs a fork (or vfork), a /bin/sh startup and, for pipelines,
+ * one more process per stage. Here the command's stdout is connected to a
+ * pipe directly and the output is consumed with vlan_hal_reader.h, so
+ * filtering that a pipeline would hand to grep is done by the caller.
+ */
+#ifndef __VLAN_HAL_SPAWN_H__
+#define __VLAN_HAL_SPAWN_H__
+
+#include <stddef.h>
+#include <sys/types.h>
+#include "vlan_hal_reader.h"
+
+typedef struct
+{
+  pid_t pid;
+  int fd;                       /*!< Read end of the child's stdout */
+} vlan_spawn_t;
+
+/**
+ * @brief Start @p argv[0], searched on PATH, with stdout connected to @p child->fd.
+ *
+ * stdin and stderr are inherited. The child gets no other descriptors
+ * opened by this module.
+ *
+ * @return 0 on success, negative errno if the pipe or the process cannot be created.
+ */
+int vlan_spawn_start(vlan_spawn_t *child, const char *const argv[]);
+
+/**
+ * @brief Run @p argv with @p data as its standard input and wait for it.
+ *
+ * stdout and stderr are inherited.
+ *
+ * @return As vlan_spawn_wait(), or negative errno if the command could not be run.
+ */
+int vlan_spawn_feed(const char *const argv[], const char *data, size_t length);
+
+/**
+ * @brief As vlan_spawn_feed(), with the command's stderr written to @p errFd.
+ *
+ * @p errFd should be a file rather than a pipe, nothing reads it while the
+ * command runs. A negative @p errFd leaves stderr inherited.
+ */
+int vlan_spawn_feed_errors(const char *const argv[], const char *data, size_t length, int errFd);
+
+/**
+ * @brief Close @p child->fd and reap the child.
+ *
+ * @return Exit status 0..255, 128 + signal number if the child was killed
+ *         (as a shell reports it), or negative errno.
+ */
+int vlan_spawn_wait(vlan_spawn_t *child);
+
+/**
+ * @brief Run @p argv and pass each line of its output to @p fn, see vlan_reader_lines().
+ *
+ * If @p fn stops early, the rest of the output is discarded so the command
+ * can finish writing.
+ *
+ * @return As vlan_spawn_wait(), or negative errno if the command could not be run.
+ */
+int vlan_spawn_lines(const char *const argv[], vlan_reader_line_fn fn, void *ctx);
+
+/**
+ * @brief Run @p argv and collect its whole output in @p arena, see vlan_reader_slurp().
+ *
+ * @return As vlan_spawn_wait(), or negative errno if the command could not be run or read.
+ */
+int vlan_spawn_output(const char *const argv[], vlan_reader_arena_t *arena);
+
+#endif /* __VLAN_HAL_SPAWN_H__ */
@@ -0,0 +1,119 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <net/if.h>
+#include "vlan_hal_sysfs.h"
+#include "vlan_hal_validate.h"
+
+static char *gRoot = NULL;
+static int gNetDir = -1;
+
+void vlan_sysfs_set_root(const char *root)
+{
+  if (gNetDir >= 0)
+  {
+    close(gNetDir);
+    gNetDir = -1;
+  }
+  free(gRoot);
+  gRoot = (root != NULL) ? strdup(root) : NULL;
+}
+
+static int vlan_sysfs_net_dir(void)
+{
+  char path[256];
+  const char *root = gRoot;
+  int expected = -1;
+  int fd = __atomic_load_n(&gNetDir, __ATOMIC_ACQUIRE);
+
+  if (fd >= 0)
+  {
+    return fd;
+  }
+  if (root == NULL)
+  {
+    root = getenv(VLAN_HAL_SYSFS_ROOT_ENV);
+  }
+  if ((root == NULL) || (*root == '\0'))
+  {
+    root = VLAN_HAL_SYSFS_DEFAULT_ROOT;
+  }
+  if (snprintf(path, sizeof(path), "%s/class/net", root) >= (int)sizeof(path))
+  {
+    return -ENAMETOOLONG;
+  }
+  fd = open(path, O_PATH | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    return -errno;
+  }
+  /* Concurrent readers may race to open it, keep the first descriptor */
+  if (!__atomic_compare_exchange_n(&gNetDir, &expected, fd, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+  {
+    close(fd);
+    fd = expected;
+  }
+  return fd;
+}
+
+/* Also keeps every name a single path component below class/net */
+static int vlan_sysfs_is_link_name(const char *name)
+{
+  return vlan_validate_name(name) > 0;
+}
+
+static int vlan_sysfs_exists(const char *relative)
+{
+  int dirfd = vlan_sysfs_net_dir();
+
+  if (dirfd < 0)
+  {
+    return dirfd;
+  }
+  return (faccessat(dirfd, relative, F_OK, AT_EACCESS) == 0) ? 1 : 0;
+}
+
+int vlan_sysfs_has_bridge(const char *brName)
+{
+  char relative[IFNAMSIZ + sizeof("/bridge")];
+
+  if (!vlan_sysfs_is_link_name(brName))
+  {
+    return 0;
+  }
+  snprintf(relative, sizeof(relative), "%s/bridge", brName);
+  return vlan_sysfs_exists(relative);
+}
+
+int vlan_sysfs_has_port(const char *brName, const char *ifName)
+{
+  char relative[(IFNAMSIZ * 2) + sizeof("/brif/")];
+
+  if (!vlan_sysfs_is_link_name(brName) || !vlan_sysfs_is_link_name(ifName))
+  {
+    return 0;
+  }
+  snprintf(relative, sizeof(relative), "%s/brif/%s", brName, ifName);
+  return vlan_sysfs_exists(relative);
+}
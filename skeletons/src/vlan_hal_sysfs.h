@@ -0,0 +1,60 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_sysfs.h
+ *
+ * Bridge and bridge port existence checks answered from sysfs, so a yes/no
+ * question costs one faccessat() instead of running brctl through a shell.
+ *
+ * A bridge @c br exists when @c <root>/class/net/<br>/bridge does, and a link
+ * @c if is one of its ports when @c <root>/class/net/<br>/brif/<if> does. The
+ * @c class/net directory is opened once and its descriptor cached.
+ *
+ * @c <root> defaults to "/sys" and is taken from the VLAN_HAL_SYSFS_ROOT
+ * environment variable when set, so tests can point it at a fake tree.
+ */
+#ifndef __VLAN_HAL_SYSFS_H__
+#define __VLAN_HAL_SYSFS_H__
+
+#define VLAN_HAL_SYSFS_ROOT_ENV "VLAN_HAL_SYSFS_ROOT"
+#define VLAN_HAL_SYSFS_DEFAULT_ROOT "/sys"
+
+/**
+ * @brief Use @p root as the sysfs mount point, NULL restores selection from the environment.
+ *
+ * Closes the cached directory; the new root is opened on the next check.
+ */
+void vlan_sysfs_set_root(const char *root);
+
+/**
+ * @brief Check whether @p brName is a bridge.
+ *
+ * @return 1 if it is, 0 if not (or the name is not a valid link name),
+ *         negative errno if the sysfs root cannot be opened.
+ */
+int vlan_sysfs_has_bridge(const char *brName);
+
+/**
+ * @brief Check whether @p ifName is a port of bridge @p brName.
+ *
+ * @return 1 if it is, 0 if not, negative errno if the sysfs root cannot be opened.
+ */
+int vlan_sysfs_has_port(const char *brName, const char *ifName);
+
+#endif /* __VLAN_HAL_SYSFS_H__ */
@@ -0,0 +1,112 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_validate.h
+ *
+ * Input checks shared by every HAL entry point, kept cheap enough to run
+ * on each call.
+ *
+ * A VLAN ID string is at most 4 digits, so it is loaded into one 32-bit
+ * word and checked and converted with SWAR arithmetic on all digits at
+ * once. A link name is checked against a character class table, one load
+ * per character, and never read past IFNAMSIZ bytes.
+ */
+#ifndef __VLAN_HAL_VALIDATE_H__
+#define __VLAN_HAL_VALIDATE_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <net/if.h>
+#include "vlan_hal_vlan_bitmap.h"
+
+/* Non-zero for the characters allowed in a link name: [A-Za-z0-9._-] */
+extern const uint8_t vlan_validate_name_chars[256];
+
+/**
+ * @brief Check @p name is usable as a bridge or interface name.
+ *
+ * 1 to IFNAMSIZ - 1 characters from [A-Za-z0-9._-], and not "." or "..".
+ * This is stricter than the kernel, which also takes characters such as
+ * '@' that iproute2 output and the HAL's "<ifName>.<vlanID>" ports give a
+ * meaning to.
+ *
+ * @return Length of @p name, or -1 if it is not valid.
+ */
+static inline int vlan_validate_name(const char *name)
+{
+  unsigned int bad = 0;
+  int length = 0;
+
+  if (name == NULL)
+  {
+    return -1;
+  }
+  while ((length < IFNAMSIZ) && (name[length] != '\0'))
+  {
+    bad |= vlan_validate_name_chars[(uint8_t)name[length]] ^ 1u;
+    length++;
+  }
+  bad |= (length == 0) | (length == IFNAMSIZ);
+  /* "." and "..", name[1] is only read once name[0] is known to be there */
+  bad |= (length != 0) && (name[0] == '.') && ((length == 1) || ((length == 2) && (name[1] == '.')));
+  return bad ? -1 : length;
+}
+
+/**
+ * @brief Parse a VLAN ID: 1 to 4 decimal digits without sign, whitespace or leading zero, 1 to 4094.
+ *
+ * @return 0 and the value in @p value, or -1 if @p vlanID is not a valid VLAN ID.
+ */
+static inline int vlan_validate_vlan_id(const char *vlanID, uint16_t *value)
+{
+  uint32_t word = 0x30303030u;  /* "0000", the digits are right-aligned into it */
+  uint32_t parsed;
+  size_t length;
+
+  if (vlanID == NULL)
+  {
+    return -1;
+  }
+  length = strnlen(vlanID, 5);
+  if ((length == 0) || (length > 4) || (vlanID[0] == '0'))
+  {
+    return -1;
+  }
+  memcpy((char *)&word + (4 - length), vlanID, length);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  word = __builtin_bswap32(word);
+#endif
+  /* Every byte in '0'..'9': high nibble 3, and still 3 after adding 6 (no carry once the first test holds) */
+  if (((word & 0xf0f0f0f0u) != 0x30303030u) | (((word + 0x06060606u) & 0xf0f0f0f0u) != 0x30303030u))
+  {
+    return -1;
+  }
+  /* Bytes hold d0 d1 d2 d3 (d0 most significant): fold pairs, then the two halves */
+  word -= 0x30303030u;
+  word = (word * 10) + (word >> 8);
+  parsed = ((word & 0xffu) * 100) + ((word >> 16) & 0xffu);
+  if (parsed > VLAN_BITMAP_ID_MAX)
+  {
+    return -1;
+  }
+  *value = (uint16_t)parsed;
+  return 0;
+}
+
+#endif /* __VLAN_HAL_VALIDATE_H__ */
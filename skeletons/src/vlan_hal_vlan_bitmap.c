@@ -0,0 +1,121 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "vlan_hal_vlan_bitmap.h"
+
+void vlan_bitmap_reset(vlan_bitmap_t *bitmap)
+{
+  memset(bitmap, 0, sizeof(*bitmap));
+}
+
+int vlan_bitmap_set(vlan_bitmap_t *bitmap, unsigned int vlanID)
+{
+  uint64_t bit;
+
+  if (!vlan_bitmap_is_valid_id(vlanID))
+  {
+    return -1;
+  }
+  bit = (uint64_t)1 << (vlanID & 63);
+  if (bitmap->words[vlanID >> 6] & bit)
+  {
+    return -1;
+  }
+  bitmap->words[vlanID >> 6] |= bit;
+  return 0;
+}
+
+int vlan_bitmap_clear(vlan_bitmap_t *bitmap, unsigned int vlanID)
+{
+  uint64_t bit;
+
+  if (!vlan_bitmap_is_valid_id(vlanID))
+  {
+    return -1;
+  }
+  bit = (uint64_t)1 << (vlanID & 63);
+  if (!(bitmap->words[vlanID >> 6] & bit))
+  {
+    return -1;
+  }
+  bitmap->words[vlanID >> 6] &= ~bit;
+  return 0;
+}
+
+int vlan_bitmap_find_free(const vlan_bitmap_t *bitmap, unsigned int first, unsigned int last)
+{
+  unsigned int word;
+  unsigned int lastWord;
+  uint64_t freeBits;
+
+  if (first < VLAN_BITMAP_ID_MIN)
+  {
+    first = VLAN_BITMAP_ID_MIN;
+  }
+  if (last > VLAN_BITMAP_ID_MAX)
+  {
+    last = VLAN_BITMAP_ID_MAX;
+  }
+  if (first > last)
+  {
+    return -1;
+  }
+
+  /* Scan 64 IDs at a time, masking off bits outside [first, last] in the edge words */
+  lastWord = last >> 6;
+  for (word = first >> 6; word <= lastWord; word++)
+  {
+    freeBits = ~bitmap->words[word];
+    if (word == (first >> 6))
+    {
+      freeBits &= ~(uint64_t)0 << (first & 63);
+    }
+    if (word == lastWord)
+    {
+      freeBits &= ~(uint64_t)0 >> (63 - (last & 63));
+    }
+    if (freeBits != 0)
+    {
+      return (int)((word << 6) + (unsigned int)__builtin_ctzll(freeBits));
+    }
+  }
+  return -1;
+}
+
+int vlan_bitmap_alloc(vlan_bitmap_t *bitmap, unsigned int first, unsigned int last)
+{
+  int vlanID = vlan_bitmap_find_free(bitmap, first, last);
+
+  if (vlanID > 0)
+  {
+    bitmap->words[vlanID >> 6] |= (uint64_t)1 << (vlanID & 63);
+  }
+  return vlanID;
+}
+
+unsigned int vlan_bitmap_count(const vlan_bitmap_t *bitmap)
+{
+  unsigned int count = 0;
+  unsigned int word;
+
+  for (word = 0; word < VLAN_BITMAP_WORDS; word++)
+  {
+    count += (unsigned int)__builtin_popcountll(bitmap->words[word]);
+  }
+  return count;
+}
@@ -0,0 +1,87 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_hal_vlan_bitmap.h
+ *
+ * One bit per 802.1Q VLAN ID (512 bytes for the whole 12-bit space).
+ * IDs 0 and 4095 are reserved by the standard and can never be set.
+ */
+#ifndef __VLAN_HAL_VLAN_BITMAP_H__
+#define __VLAN_HAL_VLAN_BITMAP_H__
+
+#include <stdint.h>
+
+#define VLAN_BITMAP_ID_MIN 1
+#define VLAN_BITMAP_ID_MAX 4094
+#define VLAN_BITMAP_WORDS (4096 / 64)
+
+typedef struct
+{
+  uint64_t words[VLAN_BITMAP_WORDS];
+} vlan_bitmap_t;
+
+static inline int vlan_bitmap_is_valid_id(unsigned int vlanID)
+{
+  return (vlanID >= VLAN_BITMAP_ID_MIN) && (vlanID <= VLAN_BITMAP_ID_MAX);
+}
+
+/**
+ * @brief Non-zero if @p vlanID is marked in use. Reserved IDs are never in use.
+ */
+static inline int vlan_bitmap_test(const vlan_bitmap_t *bitmap, unsigned int vlanID)
+{
+  return vlan_bitmap_is_valid_id(vlanID) && ((bitmap->words[vlanID >> 6] >> (vlanID & 63)) & 1);
+}
+
+void vlan_bitmap_reset(vlan_bitmap_t *bitmap);
+
+/**
+ * @brief Mark @p vlanID in use.
+ *
+ * @return 0 on success, -1 if the ID is reserved or already in use.
+ */
+int vlan_bitmap_set(vlan_bitmap_t *bitmap, unsigned int vlanID);
+
+/**
+ * @brief Mark @p vlanID free.
+ *
+ * @return 0 on success, -1 if the ID is reserved or was not in use.
+ */
+int vlan_bitmap_clear(vlan_bitmap_t *bitmap, unsigned int vlanID);
+
+/**
+ * @brief Find the lowest free ID in [@p first, @p last] without marking it.
+ *
+ * @return The free ID, or -1 if the range is exhausted or invalid.
+ */
+int vlan_bitmap_find_free(const vlan_bitmap_t *bitmap, unsigned int first, unsigned int last);
+
+/**
+ * @brief Find the lowest free ID in [@p first, @p last] and mark it in use.
+ *
+ * @return The allocated ID, or -1 if the range is exhausted or invalid.
+ */
+int vlan_bitmap_alloc(vlan_bitmap_t *bitmap, unsigned int first, unsigned int last);
+
+/**
+ * @brief Number of IDs in use.
+ */
+unsigned int vlan_bitmap_count(const vlan_bitmap_t *bitmap);
+
+#endif /* __VLAN_HAL_VLAN_BITMAP_H__ */
@@ -0,0 +1,205 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_async.c
+ * @page vlan_hal_async Skeleton asynchronous offload queue tests
+ *
+ * ## Module's Role
+ * Verifies the asynchronous variants of the mutating calls: ordering,
+ * results delivered through callbacks, and completions collected through
+ * the eventfd and vlan_hal_async_reap().
+ *
+ * **Pre-Conditions:**  None@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 13;
+static int gTestID = 1;
+
+#define ASYNC_GROUPS 16
+
+typedef struct
+{
+  int ok;
+  int failed;
+} async_results_t;
+
+/* Runs on the worker thread, only one at a time */
+static void async_count(void *ctx, int result)
+{
+  async_results_t *results = ctx;
+
+  if (result == RETURN_OK)
+  {
+    results->ok++;
+  }
+  else
+  {
+    results->failed++;
+  }
+}
+
+/**
+ * @brief Verify operations complete in submission order with their results passed to the callback.
+ *
+ * **Test Group ID:** Skeleton: 13 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_async_callback(void)
+{
+  async_results_t groups = { 0, 0 };
+  async_results_t ports = { 0, 0 };
+  async_results_t missing = { 0, 0 };
+  async_results_t removed = { 0, 0 };
+  char groupName[IFNAMSIZ];
+  char vlanID[5];
+  int i;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL(vlan_hal_async_start(), RETURN_OK);
+  for (i = 0; i < ASYNC_GROUPS; i++)
+  {
+    snprintf(groupName, sizeof(groupName), "brasync%d", i);
+    snprintf(vlanID, sizeof(vlanID), "%d", 3800 + i);
+    /* Each interface depends on the group submitted just before it */
+    UT_ASSERT_EQUAL(vlan_hal_addGroup_async(groupName, vlanID, async_count, &groups), RETURN_OK);
+    UT_ASSERT_EQUAL(vlan_hal_addInterface_async(groupName, "as0", vlanID, async_count, &ports), RETURN_OK);
+    /* Accepted for queueing, fails when it runs */
+    snprintf(groupName, sizeof(groupName), "brasmiss%d", i);
+    UT_ASSERT_EQUAL(vlan_hal_delGroup_async(groupName, async_count, &missing), RETURN_OK);
+  }
+  vlan_hal_async_drain();
+  UT_ASSERT_EQUAL(groups.ok, ASYNC_GROUPS);
+  UT_ASSERT_EQUAL(ports.ok, ASYNC_GROUPS);
+  UT_ASSERT_EQUAL(missing.failed, ASYNC_GROUPS);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brasync3", vlanID), RETURN_OK);
+  UT_ASSERT_STRING_EQUAL(vlanID, "3803");
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("as0", "brasync3", "3803"), RETURN_OK);
+
+  /* Rejected before queueing */
+  UT_ASSERT_EQUAL(vlan_hal_addGroup_async("brasync_name_too_long", "3900", async_count, &groups), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_addGroup_async(NULL, "3900", async_count, &groups), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface_async("brasync0", NULL, "3800", async_count, &ports), RETURN_ERR);
+
+  for (i = 0; i < ASYNC_GROUPS; i++)
+  {
+    snprintf(groupName, sizeof(groupName), "brasync%d", i);
+    snprintf(vlanID, sizeof(vlanID), "%d", 3800 + i);
+    UT_ASSERT_EQUAL(vlan_hal_delInterface_async(groupName, "as0", vlanID, async_count, &removed), RETURN_OK);
+    UT_ASSERT_EQUAL(vlan_hal_delGroup_async(groupName, async_count, &removed), RETURN_OK);
+  }
+  vlan_hal_async_stop();
+  UT_ASSERT_EQUAL(removed.ok, 2 * ASYNC_GROUPS);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brasync3", vlanID), RETURN_ERR);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify completions without a callback are signalled on the eventfd and reaped in order.
+ *
+ * **Test Group ID:** Skeleton: 13 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_async_reap(void)
+{
+  vlan_hal_completion_t completions[3];
+  struct pollfd pfd;
+  char groupName[IFNAMSIZ];
+  char vlanID[5];
+  unsigned int got;
+  unsigned int i;
+  int reaped = 0;
+  int ordered = 1;
+  int ok = 0;
+  int n;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  pfd.fd = vlan_hal_async_fd();
+  pfd.events = POLLIN;
+  UT_ASSERT_TRUE(pfd.fd >= 0);
+  UT_ASSERT_EQUAL(vlan_hal_async_reap(completions, 3), 0);
+
+  for (n = 0; n < ASYNC_GROUPS; n++)
+  {
+    snprintf(groupName, sizeof(groupName), "brreap%d", n);
+    snprintf(vlanID, sizeof(vlanID), "%d", 3820 + n);
+    UT_ASSERT_EQUAL(vlan_hal_addGroup_async(groupName, vlanID, NULL, (void *)(intptr_t)n), RETURN_OK);
+  }
+
+  /* Reap in chunks smaller than the backlog, the fd must stay readable until all are taken */
+  while ((reaped < ASYNC_GROUPS) && (poll(&pfd, 1, 5000) == 1))
+  {
+    got = vlan_hal_async_reap(completions, 3);
+    for (i = 0; i < got; i++)
+    {
+      ordered &= ((intptr_t)completions[i].ctx == reaped);
+      ok += (completions[i].result == RETURN_OK);
+      reaped++;
+    }
+  }
+  UT_ASSERT_EQUAL(reaped, ASYNC_GROUPS);
+  UT_ASSERT_EQUAL(ok, ASYNC_GROUPS);
+  UT_ASSERT_TRUE(ordered);
+  UT_ASSERT_EQUAL(poll(&pfd, 1, 0), 0);
+
+  for (n = 0; n < ASYNC_GROUPS; n++)
+  {
+    snprintf(groupName, sizeof(groupName), "brreap%d", n);
+    UT_ASSERT_EQUAL(vlan_hal_delGroup_async(groupName, NULL, NULL), RETURN_OK);
+  }
+  vlan_hal_async_stop();
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brreap0", vlanID), RETURN_ERR);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton asynchronous offload queue tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_async_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_async]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_async_callback", test_vlan_hal_async_callback, "async");
+  vlan_hal_test_add(pSuite, "vlan_hal_async_reap", test_vlan_hal_async_reap, "async");
+
+  return 0;
+}
@@ -0,0 +1,245 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_concurrency.c
+ * @page vlan_hal_concurrency Skeleton concurrency stress tests
+ *
+ * ## Module's Role
+ * Drives the skeleton from several threads at once: writer threads churn
+ * groups and interfaces while reader threads resolve a stable set of groups.
+ * Readers must always see correct answers, and reader throughput is logged
+ * for one reader and for one reader per core to show it scales.
+ *
+ * **Pre-Conditions:**  None@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <net/if.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "vlan_hal_rcu.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 8;
+static int gTestID = 1;
+
+#define STRESS_STABLE_GROUPS 32
+#define STRESS_WRITERS 2
+#define STRESS_MAX_READERS 16
+#define STRESS_PHASE_MS 200
+
+typedef struct
+{
+  int *stop;
+  int id;
+  unsigned long operations;
+  unsigned long errors;
+} stress_worker_t;
+
+static char gStableNames[STRESS_STABLE_GROUPS][IFNAMSIZ];
+static char gStableVlans[STRESS_STABLE_GROUPS][5];
+
+static void *stress_reader(void *arg)
+{
+  stress_worker_t *worker = arg;
+  char vlanID[5];
+  int i = worker->id;
+
+  while (!__atomic_load_n(worker->stop, __ATOMIC_RELAXED))
+  {
+    i = (i + 1) % STRESS_STABLE_GROUPS;
+    if ((get_vlanId_for_GroupName(gStableNames[i], vlanID) != RETURN_OK) ||
+        (strcmp(vlanID, gStableVlans[i]) != 0) ||
+        (_is_this_group_available_in_linux_bridge(gStableNames[i]) != RETURN_OK))
+    {
+      worker->errors++;
+    }
+    worker->operations++;
+  }
+  return NULL;
+}
+
+/* Each writer owns VLAN IDs 3800 + 64 * id onwards and a port name, so writers never conflict */
+static void *stress_writer(void *arg)
+{
+  stress_worker_t *worker = arg;
+  char groupName[IFNAMSIZ];
+  char ifName[IFNAMSIZ];
+  char vlanID[5];
+  unsigned int k = 0;
+
+  snprintf(ifName, sizeof(ifName), "stw%d", worker->id);
+  while (!__atomic_load_n(worker->stop, __ATOMIC_RELAXED))
+  {
+    snprintf(groupName, sizeof(groupName), "brstw%d_%u", worker->id, k % 8);
+    snprintf(vlanID, sizeof(vlanID), "%u", 3800 + (64 * worker->id) + (k % 8));
+    if ((vlan_hal_addGroup(groupName, vlanID) != RETURN_OK) ||
+        (vlan_hal_addInterface(gStableNames[0], ifName, vlanID) != RETURN_OK) ||
+        (vlan_hal_delInterface(gStableNames[0], ifName, vlanID) != RETURN_OK) ||
+        (vlan_hal_delGroup(groupName) != RETURN_OK))
+    {
+      worker->errors++;
+    }
+    worker->operations++;
+    k++;
+  }
+  return NULL;
+}
+
+/* Runs @readers readers against STRESS_WRITERS writers for STRESS_PHASE_MS, returns reader lookups per second */
+static double stress_phase(int readers, unsigned long *errors, unsigned long *writes)
+{
+  stress_worker_t workers[STRESS_MAX_READERS + STRESS_WRITERS];
+  pthread_t threads[STRESS_MAX_READERS + STRESS_WRITERS];
+  struct timespec pause = { STRESS_PHASE_MS / 1000, (STRESS_PHASE_MS % 1000) * 1000000L };
+  int stop = 0;
+  unsigned long lookups = 0;
+  int started = 0;
+  int i;
+
+  *errors = 0;
+  *writes = 0;
+  memset(workers, 0, sizeof(workers));
+  for (i = 0; i < readers + STRESS_WRITERS; i++)
+  {
+    workers[i].stop = &stop;
+    workers[i].id = (i < readers) ? i : i - readers;
+    if (pthread_create(&threads[i], NULL, (i < readers) ? stress_reader : stress_writer, &workers[i]) != 0)
+    {
+      break;
+    }
+    started++;
+  }
+  nanosleep(&pause, NULL);
+  __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+  for (i = 0; i < started; i++)
+  {
+    pthread_join(threads[i], NULL);
+    *errors += workers[i].errors;
+    if (i < readers)
+    {
+      lookups += workers[i].operations;
+    }
+    else
+    {
+      *writes += workers[i].operations;
+    }
+  }
+  if (started != readers + STRESS_WRITERS)
+  {
+    (*errors)++;
+  }
+  return (double)lookups * 1000.0 / STRESS_PHASE_MS;
+}
+
+/**
+ * @brief Verify readers get consistent answers while writers churn, and log reader scaling.
+ *
+ * **Test Group ID:** Skeleton: 08 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_concurrency_readers_writers(void)
+{
+  long cores = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned long errors;
+  unsigned long writes;
+  double single;
+  double scaled;
+  int readers;
+  int i;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  for (i = 0; i < STRESS_STABLE_GROUPS; i++)
+  {
+    snprintf(gStableNames[i], IFNAMSIZ, "brst%d", i);
+    snprintf(gStableVlans[i], sizeof(gStableVlans[i]), "%d", 3700 + i);
+    UT_ASSERT_EQUAL(vlan_hal_addGroup(gStableNames[i], gStableVlans[i]), RETURN_OK);
+  }
+
+  single = stress_phase(1, &errors, &writes);
+  UT_LOG_INFO("1 reader: %.0f lookups/s, %lu write cycles\n", single, writes);
+  UT_ASSERT_EQUAL(errors, 0);
+  UT_ASSERT_TRUE(writes > 0);
+
+  readers = (cores > STRESS_MAX_READERS) ? STRESS_MAX_READERS : ((cores > 1) ? (int)cores : 2);
+  scaled = stress_phase(readers, &errors, &writes);
+  UT_LOG_INFO("%d readers: %.0f lookups/s (x%.2f), %lu write cycles\n", readers, scaled,
+              (single > 0) ? scaled / single : 0.0, writes);
+  UT_ASSERT_EQUAL(errors, 0);
+  UT_ASSERT_TRUE(scaled > 0);
+
+  for (i = 0; i < STRESS_STABLE_GROUPS; i++)
+  {
+    UT_ASSERT_EQUAL(vlan_hal_delGroup(gStableNames[i]), RETURN_OK);
+  }
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify waiting for readers fails instead of hanging inside a read section.
+ *
+ * **Test Group ID:** Skeleton: 08 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_concurrency_rcu_nesting(void)
+{
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  vlan_rcu_read_lock();
+  UT_ASSERT_EQUAL(vlan_rcu_synchronize(), -EDEADLK);
+  vlan_rcu_read_lock();
+  vlan_rcu_read_unlock();
+  UT_ASSERT_EQUAL(vlan_rcu_synchronize(), -EDEADLK);
+  vlan_rcu_read_unlock();
+  UT_ASSERT_EQUAL(vlan_rcu_synchronize(), 0);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton concurrency tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_concurrency_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_concurrency]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_concurrency_readers_writers", test_vlan_hal_concurrency_readers_writers, "concurrency");
+  vlan_hal_test_add(pSuite, "vlan_hal_concurrency_rcu_nesting", test_vlan_hal_concurrency_rcu_nesting, NULL);
+
+  return 0;
+}
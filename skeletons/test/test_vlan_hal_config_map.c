@@ -0,0 +1,282 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_config_map.c
+ * @page vlan_hal_config_map Skeleton memory-mapped config tests
+ *
+ * ## Module's Role
+ * Verifies the memory-mapped group to VLAN file: writer updates, read-only
+ * lookups, consistency of lookups racing the writer, and the HAL keeping
+ * a published file in step with the registry.
+ *
+ * **Pre-Conditions:**  A writable /tmp@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "vlan_hal_config_map.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 7;
+static int gTestID = 1;
+
+static char gMapPath[64];
+
+static void make_map_path(void)
+{
+  snprintf(gMapPath, sizeof(gMapPath), "/tmp/vlan_hal_map_%d", (int)getpid());
+}
+
+/**
+ * @brief Verify put, delete and lookup through writer and read-only mappings.
+ *
+ * **Test Group ID:** Skeleton: 07 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_config_map_basic(void)
+{
+  vlan_config_map_t writer;
+  vlan_config_map_t reader;
+  char name[IFNAMSIZ];
+  uint16_t vlanID = 0;
+  int i;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  make_map_path();
+  UT_ASSERT_EQUAL(vlan_config_map_open(&reader, gMapPath), -ENOENT);
+  UT_ASSERT_EQUAL_FATAL(vlan_config_map_create(&writer, gMapPath), 0);
+  UT_ASSERT_EQUAL_FATAL(vlan_config_map_open(&reader, gMapPath), 0);
+
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&reader, "brlan0", &vlanID), -1);
+  UT_ASSERT_EQUAL(vlan_config_map_put(&writer, "brlan0", 10), 0);
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&reader, "brlan0", &vlanID), 0);
+  UT_ASSERT_EQUAL(vlanID, 10);
+  UT_ASSERT_EQUAL(vlan_config_map_put(&writer, "brlan0", 4094), 0);
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&reader, "brlan0", &vlanID), 0);
+  UT_ASSERT_EQUAL(vlanID, 4094);
+  UT_ASSERT_EQUAL(vlan_config_map_put(&reader, "brlan1", 20), -1);
+  UT_ASSERT_EQUAL(vlan_config_map_put(&writer, "", 20), -1);
+  UT_ASSERT_EQUAL(vlan_config_map_put(&writer, "bridge-name-too-long", 20), -1);
+
+  /* Enough churn to force tombstone sweeps */
+  for (i = 0; i < 3 * VLAN_CONFIG_MAP_SLOTS; i++)
+  {
+    snprintf(name, sizeof(name), "brc%d", i);
+    UT_ASSERT_EQUAL(vlan_config_map_put(&writer, name, (uint16_t)((i % 4094) + 1)), 0);
+    UT_ASSERT_EQUAL(vlan_config_map_del(&writer, name), 0);
+  }
+  UT_ASSERT_EQUAL(vlan_config_map_del(&writer, "brc0"), -1);
+  UT_ASSERT_EQUAL(reader.header->count, 1);
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&reader, "brlan0", &vlanID), 0);
+  UT_ASSERT_EQUAL(vlanID, 4094);
+
+  vlan_config_map_close(&reader);
+  vlan_config_map_close(&writer);
+  unlink(gMapPath);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+typedef struct
+{
+  vlan_config_map_t *map;
+  volatile int stop;
+  int lookups;
+  int inconsistent;
+} map_reader_t;
+
+/* The writer only ever stores 100 or 200 for brrace0, anything else is a torn read */
+static void *map_reader_thread(void *arg)
+{
+  map_reader_t *reader = arg;
+  uint16_t vlanID;
+
+  while (!reader->stop)
+  {
+    if ((vlan_config_map_lookup(reader->map, "brrace0", &vlanID) != 0) || ((vlanID != 100) && (vlanID != 200)))
+    {
+      reader->inconsistent++;
+    }
+    __atomic_fetch_add(&reader->lookups, 1, __ATOMIC_RELEASE);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Verify lookups racing the writer never observe a partial update.
+ *
+ * **Test Group ID:** Skeleton: 07 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_config_map_concurrent(void)
+{
+  vlan_config_map_t writer;
+  vlan_config_map_t map;
+  map_reader_t reader;
+  pthread_t thread;
+  char name[IFNAMSIZ];
+  int i;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  make_map_path();
+  UT_ASSERT_EQUAL_FATAL(vlan_config_map_create(&writer, gMapPath), 0);
+  UT_ASSERT_EQUAL_FATAL(vlan_config_map_open(&map, gMapPath), 0);
+  UT_ASSERT_EQUAL(vlan_config_map_put(&writer, "brrace0", 100), 0);
+
+  memset(&reader, 0, sizeof(reader));
+  reader.map = &map;
+  UT_ASSERT_EQUAL_FATAL(pthread_create(&thread, NULL, map_reader_thread, &reader), 0);
+  /* Do not let the writes finish before the reader has been scheduled */
+  while (__atomic_load_n(&reader.lookups, __ATOMIC_ACQUIRE) == 0)
+  {
+    sched_yield();
+  }
+  /* Sweeps move brrace0 between slots while the reader probes for it */
+  for (i = 0; i < 4 * VLAN_CONFIG_MAP_SLOTS; i++)
+  {
+    snprintf(name, sizeof(name), "brr%d", i);
+    vlan_config_map_put(&writer, "brrace0", (i & 1) ? 200 : 100);
+    vlan_config_map_put(&writer, name, 1);
+    vlan_config_map_del(&writer, name);
+  }
+  reader.stop = 1;
+  pthread_join(thread, NULL);
+
+  UT_LOG_DEBUG("%d lookups during writes", reader.lookups);
+  UT_ASSERT_TRUE(reader.lookups > 0);
+  UT_ASSERT_EQUAL(reader.inconsistent, 0);
+
+  vlan_config_map_close(&map);
+  vlan_config_map_close(&writer);
+  unlink(gMapPath);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify a published file follows the HAL registry.
+ *
+ * **Test Group ID:** Skeleton: 07 @n
+ * **Test Case ID:** 003 @n
+ */
+void test_vlan_hal_config_map_publish(void)
+{
+  vlan_config_map_t map;
+  uint16_t vlanID = 0;
+
+  gTestID = 3;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  make_map_path();
+  UT_ASSERT_EQUAL(insert_VLAN_ConfigEntry("brmap0", "3400"), RETURN_OK);
+  UT_ASSERT_EQUAL_FATAL(vlan_hal_config_publish(gMapPath), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_config_publish(gMapPath), RETURN_ERR);
+  UT_ASSERT_EQUAL_FATAL(vlan_config_map_open(&map, gMapPath), 0);
+
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&map, "brmap0", &vlanID), 0);
+  UT_ASSERT_EQUAL(vlanID, 3400);
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brmap1", "3401"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&map, "brmap1", &vlanID), 0);
+  UT_ASSERT_EQUAL(vlanID, 3401);
+  UT_ASSERT_EQUAL(insert_VLAN_ConfigEntry("brmap0", "3402"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&map, "brmap0", &vlanID), 0);
+  UT_ASSERT_EQUAL(vlanID, 3402);
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brmap1"), RETURN_OK);
+  UT_ASSERT_EQUAL(delete_VLAN_ConfigEntry("brmap0"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&map, "brmap0", &vlanID), -1);
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&map, "brmap1", &vlanID), -1);
+
+  vlan_config_map_close(&map);
+  vlan_hal_config_unpublish();
+  unlink(gMapPath);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify a reader gives up on a writer stuck mid-update instead of spinning.
+ *
+ * **Test Group ID:** Skeleton: 07 @n
+ * **Test Case ID:** 004 @n
+ */
+void test_vlan_hal_config_map_stalled_writer(void)
+{
+  vlan_config_map_t writer;
+  vlan_config_map_t reader;
+  uint16_t vlanID = 0;
+
+  gTestID = 4;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  make_map_path();
+  UT_ASSERT_EQUAL_FATAL(vlan_config_map_create(&writer, gMapPath), 0);
+  UT_ASSERT_EQUAL_FATAL(vlan_config_map_open(&reader, gMapPath), 0);
+  UT_ASSERT_EQUAL(vlan_config_map_put(&writer, "brstall0", 30), 0);
+
+  /* Leave the counter odd, as a writer that died during an update would */
+  __atomic_add_fetch(&writer.header->seq, 1, __ATOMIC_RELEASE);
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&reader, "brstall0", &vlanID), -EAGAIN);
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&reader, "brmissing", &vlanID), -EAGAIN);
+
+  __atomic_add_fetch(&writer.header->seq, 1, __ATOMIC_RELEASE);
+  UT_ASSERT_EQUAL(vlan_config_map_lookup(&reader, "brstall0", &vlanID), 0);
+  UT_ASSERT_EQUAL(vlanID, 30);
+
+  vlan_config_map_close(&reader);
+  vlan_config_map_close(&writer);
+  unlink(gMapPath);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton memory-mapped config tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_config_map_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_config_map]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_config_map_basic", test_vlan_hal_config_map_basic, "config_map");
+  vlan_hal_test_add(pSuite, "vlan_hal_config_map_concurrent", test_vlan_hal_config_map_concurrent, "config_map");
+  vlan_hal_test_add(pSuite, "vlan_hal_config_map_publish", test_vlan_hal_config_map_publish, "config_map");
+  vlan_hal_test_add(pSuite, "vlan_hal_config_map_stalled_writer", test_vlan_hal_config_map_stalled_writer, "config_map");
+
+  return 0;
+}
@@ -0,0 +1,335 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_config_store.c
+ * @page vlan_hal_config_store Skeleton persistent config store tests
+ *
+ * ## Module's Role
+ * Verifies the append-only group to VLAN log: replay, recovery from a torn
+ * tail, compaction, and that the HAL restores its registry from it.
+ *
+ * **Pre-Conditions:**  A writable temporary directory@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "vlan_hal_backend.h"
+#include "vlan_hal_config_store.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 6;
+static int gTestID = 1;
+
+typedef struct
+{
+  int puts;
+  int dels;
+  char last[IFNAMSIZ];
+  uint16_t lastVlan;
+} replay_count_t;
+
+static void replay_count(void *ctx, vlan_config_op_t op, const char *name, uint16_t vlanID)
+{
+  replay_count_t *count = ctx;
+
+  if (op == VLAN_CONFIG_OP_PUT)
+  {
+    count->puts++;
+  }
+  else
+  {
+    count->dels++;
+  }
+  strcpy(count->last, name);
+  count->lastVlan = vlanID;
+}
+
+static off_t file_size(const char *path)
+{
+  struct stat st;
+
+  return (stat(path, &st) == 0) ? st.st_size : -1;
+}
+
+static int make_log_path(char *path, size_t size)
+{
+  char dir[] = "/tmp/vlan_hal_config_XXXXXX";
+
+  if (mkdtemp(dir) == NULL)
+  {
+    return -1;
+  }
+  snprintf(path, size, "%s/vlan.log", dir);
+  return 0;
+}
+
+static void remove_log_path(const char *path)
+{
+  char dir[256];
+  char *slash;
+
+  unlink(path);
+  snprintf(dir, sizeof(dir), "%s", path);
+  slash = strrchr(dir, '/');
+  if (slash != NULL)
+  {
+    *slash = '\0';
+    rmdir(dir);
+  }
+}
+
+/**
+ * @brief Verify appended records replay in order and a torn tail is dropped.
+ *
+ * **Test Group ID:** Skeleton: 06 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_config_store_replay(void)
+{
+  vlan_config_store_t store;
+  replay_count_t count;
+  char path[256];
+  off_t size;
+  int fd;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(make_log_path(path, sizeof(path)), 0);
+
+  memset(&count, 0, sizeof(count));
+  UT_ASSERT_EQUAL_FATAL(vlan_config_store_open(&store, path, replay_count, &count), 0);
+  UT_ASSERT_EQUAL(count.puts + count.dels, 0);
+  UT_ASSERT_EQUAL(vlan_config_store_put(&store, "brlan0", 10), 0);
+  UT_ASSERT_EQUAL(vlan_config_store_put(&store, "brlan1", 20), 0);
+  UT_ASSERT_EQUAL(vlan_config_store_del(&store, "brlan0"), 0);
+  UT_ASSERT_EQUAL(vlan_config_store_put(&store, "", 30), -EINVAL);
+  UT_ASSERT_EQUAL(vlan_config_store_put(&store, "bridge-name-too-long", 30), -EINVAL);
+  UT_ASSERT_EQUAL(store.records, 3);
+  UT_ASSERT_EQUAL(store.pending, 3);
+  UT_ASSERT_EQUAL(vlan_config_store_sync(&store), 0);
+  UT_ASSERT_EQUAL(store.pending, 0);
+  vlan_config_store_close(&store);
+  size = file_size(path);
+
+  /* Simulate a crash halfway through an append */
+  fd = open(path, O_WRONLY | O_APPEND);
+  UT_ASSERT_FATAL(fd >= 0);
+  UT_ASSERT_EQUAL(write(fd, "\x01\x02\x03\x04\x01\x05", 6), 6);
+  close(fd);
+
+  memset(&count, 0, sizeof(count));
+  UT_ASSERT_EQUAL_FATAL(vlan_config_store_open(&store, path, replay_count, &count), 0);
+  UT_ASSERT_EQUAL(count.puts, 2);
+  UT_ASSERT_EQUAL(count.dels, 1);
+  UT_ASSERT_STRING_EQUAL(count.last, "brlan0");
+  UT_ASSERT_EQUAL(file_size(path), size);
+  UT_ASSERT_EQUAL(vlan_config_store_put(&store, "brlan2", 4094), 0);
+  vlan_config_store_close(&store);
+
+  memset(&count, 0, sizeof(count));
+  UT_ASSERT_EQUAL_FATAL(vlan_config_store_open(&store, path, replay_count, &count), 0);
+  UT_ASSERT_EQUAL(count.puts, 3);
+  UT_ASSERT_STRING_EQUAL(count.last, "brlan2");
+  UT_ASSERT_EQUAL(count.lastVlan, 4094);
+  vlan_config_store_close(&store);
+
+  remove_log_path(path);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify the HAL restores groups from the log and compacts a log of mostly stale records.
+ *
+ * **Test Group ID:** Skeleton: 06 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_config_store_hal(void)
+{
+  char vlanID[5] = {"\0"};
+  char value[5];
+  char path[256];
+  int i;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(make_log_path(path, sizeof(path)), 0);
+  UT_ASSERT_EQUAL(vlan_hal_config_sync(), RETURN_ERR);
+  UT_ASSERT_EQUAL_FATAL(vlan_hal_config_open(path), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_config_open(path), RETURN_ERR);
+
+  UT_ASSERT_EQUAL(insert_VLAN_ConfigEntry("brcfg0", "3200"), RETURN_OK);
+  UT_ASSERT_EQUAL(insert_VLAN_ConfigEntry("brcfg1", "3201"), RETURN_OK);
+  /* Churn one entry well past the compaction threshold */
+  for (i = 0; i < 3 * VLAN_CONFIG_STORE_COMPACT_MIN; i++)
+  {
+    snprintf(value, sizeof(value), "%d", 3300 + (i % 50));
+    UT_ASSERT_EQUAL(insert_VLAN_ConfigEntry("brcfg2", value), RETURN_OK);
+  }
+  UT_ASSERT_EQUAL(delete_VLAN_ConfigEntry("brcfg1"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_config_sync(), RETURN_OK);
+  UT_ASSERT_TRUE(file_size(path) < (off_t)(2 * VLAN_CONFIG_STORE_COMPACT_MIN * (8 + IFNAMSIZ)));
+  vlan_hal_config_close();
+
+  /* Forget the groups without logging it, as if the device had rebooted */
+  UT_ASSERT_EQUAL(delete_VLAN_ConfigEntry("brcfg0"), RETURN_OK);
+  UT_ASSERT_EQUAL(delete_VLAN_ConfigEntry("brcfg2"), RETURN_OK);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brcfg0", vlanID), RETURN_ERR);
+
+  UT_ASSERT_EQUAL_FATAL(vlan_hal_config_open(path), RETURN_OK);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brcfg0", vlanID), RETURN_OK);
+  UT_ASSERT_STRING_EQUAL(vlanID, "3200");
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brcfg1", vlanID), RETURN_ERR);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brcfg2", vlanID), RETURN_OK);
+  snprintf(value, sizeof(value), "%d", 3300 + ((3 * VLAN_CONFIG_STORE_COMPACT_MIN - 1) % 50));
+  UT_ASSERT_STRING_EQUAL(vlanID, value);
+
+  UT_ASSERT_EQUAL(delete_VLAN_ConfigEntry("brcfg0"), RETURN_OK);
+  UT_ASSERT_EQUAL(delete_VLAN_ConfigEntry("brcfg2"), RETURN_OK);
+  vlan_hal_config_close();
+  remove_log_path(path);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static int gDelBridgeCalls = 0;
+static int gDelBridgeResult = 0;
+
+static int count_del_bridge(const char *brName)
+{
+  (void)brName;
+  gDelBridgeCalls++;
+  return gDelBridgeResult;
+}
+
+/* Makes appends to the open log at @path fail, by putting a read-only descriptor in its place */
+static int break_log_fd(const char *path)
+{
+  char link[64];
+  char target[256];
+  ssize_t length;
+  int readOnly;
+  int fd;
+
+  for (fd = 3; fd < 1024; fd++)
+  {
+    snprintf(link, sizeof(link), "/proc/self/fd/%d", fd);
+    length = readlink(link, target, sizeof(target) - 1);
+    if (length <= 0)
+    {
+      continue;
+    }
+    target[length] = '\0';
+    if (strcmp(target, path) == 0)
+    {
+      readOnly = open("/dev/null", O_RDONLY);
+      if ((readOnly < 0) || (dup2(readOnly, fd) < 0))
+      {
+        return -1;
+      }
+      close(readOnly);
+      return 0;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Verify a group is only removed once both its bridge and its log record are gone.
+ *
+ * **Test Group ID:** Skeleton: 06 @n
+ * **Test Case ID:** 003 @n
+ */
+void test_vlan_hal_config_store_del_failure(void)
+{
+  vlan_hal_backend_t backend = vlan_hal_backend_none;
+  char vlanID[5] = {"\0"};
+  char path[256];
+
+  gTestID = 3;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(make_log_path(path, sizeof(path)), 0);
+  UT_ASSERT_EQUAL_FATAL(vlan_hal_config_open(path), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brcfg3", "3203"), RETURN_OK);
+  backend.del_bridge = count_del_bridge;
+  vlan_hal_backend_set(&backend);
+
+  /* The bridge cannot be removed: the group stays, in the registry and the log */
+  gDelBridgeCalls = 0;
+  gDelBridgeResult = -EIO;
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brcfg3"), RETURN_ERR);
+  UT_ASSERT_EQUAL(gDelBridgeCalls, 1);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brcfg3", vlanID), RETURN_OK);
+  vlan_hal_config_close();
+  /* Forget it without logging, the log must still have it */
+  UT_ASSERT_EQUAL(delete_VLAN_ConfigEntry("brcfg3"), RETURN_OK);
+  UT_ASSERT_EQUAL_FATAL(vlan_hal_config_open(path), RETURN_OK);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brcfg3", vlanID), RETURN_OK);
+  UT_ASSERT_STRING_EQUAL(vlanID, "3203");
+
+  /* The removal cannot be logged: the bridge is left alone */
+  gDelBridgeCalls = 0;
+  gDelBridgeResult = 0;
+  UT_ASSERT_EQUAL_FATAL(break_log_fd(path), 0);
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brcfg3"), RETURN_ERR);
+  UT_ASSERT_EQUAL(gDelBridgeCalls, 0);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brcfg3", vlanID), RETURN_OK);
+  vlan_hal_config_close();
+
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brcfg3"), RETURN_OK);
+  UT_ASSERT_EQUAL(gDelBridgeCalls, 1);
+  vlan_hal_backend_set(&vlan_hal_backend_none);
+  remove_log_path(path);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton config store tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_config_store_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_config_store]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_config_store_replay", test_vlan_hal_config_store_replay, "config_store");
+  vlan_hal_test_add(pSuite, "vlan_hal_config_store_hal", test_vlan_hal_config_store_hal, "config_store");
+  vlan_hal_test_add(pSuite, "vlan_hal_config_store_del_failure", test_vlan_hal_config_store_del_failure, "config_store");
+
+  return 0;
+}
@@ -0,0 +1,327 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_group_table.c
+ * @page vlan_hal_group_table Skeleton group table tests
+ *
+ * ## Module's Role
+ * Verifies the open-addressing group name to VLAN table behind the skeleton
+ * registry: lookups, updates and removal, reuse of deleted slots, growth
+ * across resizes and names that probe from the same slot.
+ *
+ * **Pre-Conditions:**  None@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <string.h>
+#include "vlan_hal_group_table.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 17;
+static int gTestID = 1;
+
+/* Fills @names with @count names whose probe starts at the same slot of a @capacity table */
+static void colliding_names(char names[][IFNAMSIZ], int count, uint32_t capacity)
+{
+  char name[IFNAMSIZ];
+  uint32_t slot = 0;
+  int found = 0;
+  int i;
+
+  for (i = 0; found < count; i++)
+  {
+    snprintf(name, sizeof(name), "gtc%d", i);
+    if (found == 0)
+    {
+      slot = vlan_group_table_hash(name) & (capacity - 1);
+    }
+    else if ((vlan_group_table_hash(name) & (capacity - 1)) != slot)
+    {
+      continue;
+    }
+    strcpy(names[found++], name);
+  }
+}
+
+/**
+ * @brief Verify insert, lookup, update, copy and remove.
+ *
+ * **Test Group ID:** Skeleton: 17 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_group_table_basic(void)
+{
+  vlan_group_table_t table = {0};
+  vlan_group_table_t copy;
+  vlan_group_entry_t *entry;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  /* An uninitialised table is empty and created on first insert */
+  UT_ASSERT_PTR_NULL(vlan_group_table_find(&table, "brgt0"));
+  UT_ASSERT_EQUAL(vlan_group_table_remove(&table, "brgt0"), -1);
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&table, "brgt0", 100), 0);
+  UT_ASSERT_EQUAL(table.capacity, VLAN_GROUP_TABLE_MIN_CAPACITY);
+  entry = vlan_group_table_find(&table, "brgt0");
+  UT_ASSERT_PTR_NOT_NULL(entry);
+  if (entry != NULL)
+  {
+    UT_ASSERT_STRING_EQUAL(vlan_name_str(entry->name), "brgt0");
+    UT_ASSERT_EQUAL(entry->vlanID, 100);
+  }
+  UT_ASSERT_PTR_NULL(vlan_group_table_find(&table, "brgt"));
+  UT_ASSERT_PTR_NULL(vlan_group_table_find(&table, "brgt00"));
+  UT_ASSERT_PTR_NULL(vlan_group_table_find(&table, NULL));
+
+  /* Inserting an existing name updates it in place */
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&table, "brgt0", 200), 0);
+  UT_ASSERT_EQUAL(table.count, 1);
+  UT_ASSERT_TRUE(vlan_group_table_find(&table, "brgt0") == entry);
+  UT_ASSERT_EQUAL(entry->vlanID, 200);
+
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&table, "", 300), -1);
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&table, NULL, 300), -1);
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&table, "bridge-name-too-long", 300), -1);
+  UT_ASSERT_EQUAL(vlan_group_table_insert(NULL, "brgt1", 300), -1);
+  UT_ASSERT_EQUAL(table.count, 1);
+
+  /* A copy is independent of the original */
+  UT_ASSERT_EQUAL_FATAL(vlan_group_table_copy(&copy, &table), 0);
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&copy, "brgt1", 300), 0);
+  UT_ASSERT_EQUAL(vlan_group_table_remove(&copy, "brgt0"), 0);
+  UT_ASSERT_PTR_NULL(vlan_group_table_find(&table, "brgt1"));
+  UT_ASSERT_PTR_NOT_NULL(vlan_group_table_find(&table, "brgt0"));
+  UT_ASSERT_PTR_NULL(vlan_group_table_find(&copy, "brgt0"));
+  vlan_group_table_deinit(&copy);
+
+  UT_ASSERT_EQUAL(vlan_group_table_remove(&table, "brgt0"), 0);
+  UT_ASSERT_EQUAL(vlan_group_table_remove(&table, "brgt0"), -1);
+  UT_ASSERT_PTR_NULL(vlan_group_table_find(&table, "brgt0"));
+  UT_ASSERT_EQUAL(table.count, 0);
+  UT_ASSERT_EQUAL(table.tombstones, 1);
+
+  vlan_group_table_deinit(&table);
+  UT_ASSERT_PTR_NULL(vlan_group_table_find(&table, "brgt0"));
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify deleted slots keep later entries reachable, are reused and swept without growing.
+ *
+ * **Test Group ID:** Skeleton: 17 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_group_table_tombstones(void)
+{
+  vlan_group_table_t table = {0};
+  char names[3][IFNAMSIZ];
+  char name[IFNAMSIZ];
+  vlan_group_entry_t *first;
+  int i;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  colliding_names(names, 3, VLAN_GROUP_TABLE_MIN_CAPACITY);
+  UT_ASSERT_EQUAL_FATAL(vlan_group_table_init(&table, 0), 0);
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&table, names[0], 1), 0);
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&table, names[1], 2), 0);
+  first = vlan_group_table_find(&table, names[0]);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(first);
+
+  /* The second name probed past the first, removing the first must not hide it */
+  UT_ASSERT_EQUAL(vlan_group_table_remove(&table, names[0]), 0);
+  UT_ASSERT_EQUAL(table.tombstones, 1);
+  UT_ASSERT_PTR_NOT_NULL(vlan_group_table_find(&table, names[1]));
+
+  /* The next insert on the same probe path takes the deleted slot */
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&table, names[2], 3), 0);
+  UT_ASSERT_TRUE(vlan_group_table_find(&table, names[2]) == first);
+  UT_ASSERT_EQUAL(table.tombstones, 0);
+  UT_ASSERT_EQUAL(table.count, 2);
+
+  /* Add/remove churn with few live entries sweeps tombstones rather than growing */
+  for (i = 0; i < 200; i++)
+  {
+    snprintf(name, sizeof(name), "gtt%d", i);
+    UT_ASSERT_EQUAL(vlan_group_table_insert(&table, name, (uint16_t)i), 0);
+    UT_ASSERT_EQUAL(vlan_group_table_remove(&table, name), 0);
+  }
+  UT_ASSERT_EQUAL(table.capacity, VLAN_GROUP_TABLE_MIN_CAPACITY);
+  UT_ASSERT_EQUAL(table.count, 2);
+  UT_ASSERT_TRUE(table.count + table.tombstones <= (table.capacity / 4) * 3);
+  UT_ASSERT_PTR_NOT_NULL(vlan_group_table_find(&table, names[1]));
+  UT_ASSERT_PTR_NOT_NULL(vlan_group_table_find(&table, names[2]));
+
+  vlan_group_table_deinit(&table);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify every entry survives the resizes as the table grows.
+ *
+ * **Test Group ID:** Skeleton: 17 @n
+ * **Test Case ID:** 003 @n
+ */
+void test_vlan_hal_group_table_growth(void)
+{
+  vlan_group_table_t table = {0};
+  vlan_group_entry_t *entry;
+  char name[IFNAMSIZ];
+  uint32_t cursor = 0;
+  uint32_t capacity;
+  int resizes = 0;
+  int missing = 0;
+  int seen = 0;
+  int i;
+
+  gTestID = 3;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(vlan_group_table_init(&table, 0), 0);
+  capacity = table.capacity;
+  for (i = 0; i < 1000; i++)
+  {
+    snprintf(name, sizeof(name), "gtg%d", i);
+    UT_ASSERT_EQUAL(vlan_group_table_insert(&table, name, (uint16_t)(i % 4094 + 1)), 0);
+    if (table.capacity != capacity)
+    {
+      resizes++;
+      capacity = table.capacity;
+    }
+  }
+  UT_ASSERT_TRUE(resizes >= 6);
+  UT_ASSERT_EQUAL(table.count, 1000);
+  UT_ASSERT_EQUAL(table.capacity & (table.capacity - 1), 0);
+  UT_ASSERT_TRUE(table.count + table.tombstones <= (table.capacity / 4) * 3);
+
+  for (i = 0; i < 1000; i++)
+  {
+    snprintf(name, sizeof(name), "gtg%d", i);
+    entry = vlan_group_table_find(&table, name);
+    if ((entry == NULL) || (entry->vlanID != (uint16_t)(i % 4094 + 1)))
+    {
+      missing++;
+    }
+  }
+  UT_ASSERT_EQUAL(missing, 0);
+  while (vlan_group_table_next(&table, &cursor) != NULL)
+  {
+    seen++;
+  }
+  UT_ASSERT_EQUAL(seen, 1000);
+
+  /* A table sized up front does not resize */
+  vlan_group_table_deinit(&table);
+  UT_ASSERT_EQUAL_FATAL(vlan_group_table_init(&table, 1000), 0);
+  capacity = table.capacity;
+  for (i = 0; i < 1000; i++)
+  {
+    snprintf(name, sizeof(name), "gtg%d", i);
+    UT_ASSERT_EQUAL(vlan_group_table_insert(&table, name, 1), 0);
+  }
+  UT_ASSERT_EQUAL(table.capacity, capacity);
+  vlan_group_table_deinit(&table);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify names whose probes start at the same slot are kept apart.
+ *
+ * **Test Group ID:** Skeleton: 17 @n
+ * **Test Case ID:** 004 @n
+ */
+void test_vlan_hal_group_table_collisions(void)
+{
+  vlan_group_table_t table = {0};
+  vlan_group_entry_t *entry;
+  char names[6][IFNAMSIZ];
+  int i;
+
+  gTestID = 4;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  colliding_names(names, 6, VLAN_GROUP_TABLE_MIN_CAPACITY);
+  UT_ASSERT_EQUAL_FATAL(vlan_group_table_init(&table, 0), 0);
+  for (i = 0; i < 6; i++)
+  {
+    UT_ASSERT_EQUAL(vlan_group_table_insert(&table, names[i], (uint16_t)(10 + i)), 0);
+  }
+  UT_ASSERT_EQUAL(table.capacity, VLAN_GROUP_TABLE_MIN_CAPACITY);
+  UT_ASSERT_EQUAL(table.count, 6);
+  for (i = 0; i < 6; i++)
+  {
+    entry = vlan_group_table_find(&table, names[i]);
+    UT_ASSERT_PTR_NOT_NULL(entry);
+    if (entry != NULL)
+    {
+      UT_ASSERT_STRING_EQUAL(vlan_name_str(entry->name), names[i]);
+      UT_ASSERT_EQUAL(entry->vlanID, 10 + i);
+    }
+  }
+
+  /* Removing from the middle of the run leaves the rest reachable */
+  UT_ASSERT_EQUAL(vlan_group_table_remove(&table, names[2]), 0);
+  UT_ASSERT_PTR_NULL(vlan_group_table_find(&table, names[2]));
+  for (i = 0; i < 6; i++)
+  {
+    if (i != 2)
+    {
+      UT_ASSERT_PTR_NOT_NULL(vlan_group_table_find(&table, names[i]));
+    }
+  }
+  /* Updating one of them leaves the others alone */
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&table, names[5], 99), 0);
+  UT_ASSERT_EQUAL(table.count, 5);
+  UT_ASSERT_EQUAL(vlan_group_table_find(&table, names[4])->vlanID, 14);
+  UT_ASSERT_EQUAL(vlan_group_table_find(&table, names[5])->vlanID, 99);
+
+  vlan_group_table_deinit(&table);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton group table tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_group_table_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_group_table]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_group_table_basic", test_vlan_hal_group_table_basic, "group_table");
+  vlan_hal_test_add(pSuite, "vlan_hal_group_table_tombstones", test_vlan_hal_group_table_tombstones, "group_table");
+  vlan_hal_test_add(pSuite, "vlan_hal_group_table_growth", test_vlan_hal_group_table_growth, "group_table");
+  vlan_hal_test_add(pSuite, "vlan_hal_group_table_collisions", test_vlan_hal_group_table_collisions, "group_table");
+
+  return 0;
+}
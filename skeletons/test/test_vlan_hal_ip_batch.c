@@ -0,0 +1,441 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_ip_batch.c
+ * @page vlan_hal_ip_batch Skeleton ip batching tests
+ *
+ * ## Module's Role
+ * Verifies that queued iproute2 commands are coalesced into one
+ * "ip -batch -" process, flushed by thresholds, by their deadline and on
+ * commit, and that failures are reported and undone in the registry. A
+ * stub ip placed first on PATH records each batch, so no root access or
+ * iproute2 is needed.
+ *
+ * **Pre-Conditions:**  A writable temporary directory and a POSIX shell@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "vlan_hal_backend.h"
+#include "vlan_hal_ip_batch.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 12;
+static int gTestID = 1;
+
+/*
+ * Appends "ip <args>" and the batch read from stdin. Fails as a whole when
+ * asked to, or reports the lines listed in VLAN_HAL_TEST_IP_FAIL_LINES the
+ * way "ip -batch" does.
+ */
+static const char gStubIp[] =
+  "#!/bin/sh\n"
+  "echo \"ip $*\" >> \"$VLAN_HAL_TEST_IP_LOG\"\n"
+  "n=0\n"
+  "status=0\n"
+  "while IFS= read -r line; do\n"
+  "  n=$((n + 1))\n"
+  "  echo \"$line\" >> \"$VLAN_HAL_TEST_IP_LOG\"\n"
+  "  for fail in $VLAN_HAL_TEST_IP_FAIL_LINES; do\n"
+  "    if [ \"$fail\" = \"$n\" ]; then echo \"Command failed -:$n\" >&2; status=1; fi\n"
+  "  done\n"
+  "done\n"
+  "[ -z \"$VLAN_HAL_TEST_IP_FAIL\" ] && exit $status\n";
+
+static char gStubDir[64];
+static char gLogPath[96];
+static char *gSavedPath = NULL;
+
+static int stub_ip_install(void)
+{
+  char path[96];
+  char *searchPath;
+  const char *oldPath = getenv("PATH");
+  FILE *fp;
+
+  strcpy(gStubDir, "/tmp/vlan_hal_ip_XXXXXX");
+  if (mkdtemp(gStubDir) == NULL)
+  {
+    return -1;
+  }
+  snprintf(path, sizeof(path), "%s/ip", gStubDir);
+  fp = fopen(path, "w");
+  if (fp == NULL)
+  {
+    return -1;
+  }
+  fputs(gStubIp, fp);
+  fclose(fp);
+  chmod(path, 0755);
+
+  snprintf(gLogPath, sizeof(gLogPath), "%s/log", gStubDir);
+  setenv("VLAN_HAL_TEST_IP_LOG", gLogPath, 1);
+  gSavedPath = strdup((oldPath != NULL) ? oldPath : "/usr/bin:/bin");
+  searchPath = malloc(strlen(gStubDir) + strlen(gSavedPath) + 2);
+  if ((gSavedPath == NULL) || (searchPath == NULL))
+  {
+    free(searchPath);
+    return -1;
+  }
+  sprintf(searchPath, "%s:%s", gStubDir, gSavedPath);
+  setenv("PATH", searchPath, 1);
+  free(searchPath);
+  return 0;
+}
+
+static void stub_ip_remove(void)
+{
+  char path[96];
+
+  if (gSavedPath != NULL)
+  {
+    setenv("PATH", gSavedPath, 1);
+    free(gSavedPath);
+    gSavedPath = NULL;
+  }
+  unsetenv("VLAN_HAL_TEST_IP_LOG");
+  unsetenv("VLAN_HAL_TEST_IP_FAIL");
+  unsetenv("VLAN_HAL_TEST_IP_FAIL_LINES");
+  snprintf(path, sizeof(path), "%s/ip", gStubDir);
+  unlink(path);
+  unlink(gLogPath);
+  rmdir(gStubDir);
+}
+
+/* Everything the stub recorded since the last call, "" if nothing ran */
+static const char *stub_ip_log(void)
+{
+  static char log[2048];
+  size_t got = 0;
+  FILE *fp = fopen(gLogPath, "r");
+
+  if (fp != NULL)
+  {
+    got = fread(log, 1, sizeof(log) - 1, fp);
+    fclose(fp);
+    unlink(gLogPath);
+  }
+  log[got] = '\0';
+  return log;
+}
+
+/**
+ * @brief Verify commands are held until the size threshold and report when the time threshold is due.
+ *
+ * **Test Group ID:** Skeleton: 12 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_ip_batch_thresholds(void)
+{
+  vlan_ip_batch_owner_t owner = { 1, 0, "brb0", "" };
+  vlan_ip_batch_t batch;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(stub_ip_install(), 0);
+
+  vlan_ip_batch_init(&batch, 3, 60000);
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owner, "link add name %s type bridge", "brb0"), 0);
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owner, "link set %s up", "brb0"), 0);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "");
+  UT_ASSERT_TRUE(vlan_ip_batch_pending(&batch, "brb0"));
+  UT_ASSERT_FALSE(vlan_ip_batch_pending(&batch, "brb"));
+  UT_ASSERT_FALSE(vlan_ip_batch_pending(&batch, "brb00"));
+  UT_ASSERT_FALSE(vlan_ip_batch_pending(&batch, "brb1"));
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owner, "link del %s", "brb0"), 0);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(),
+                         "ip -force -batch -\n"
+                         "link add name brb0 type bridge\n"
+                         "link set brb0 up\n"
+                         "link del brb0\n");
+  UT_ASSERT_FALSE(vlan_ip_batch_pending(&batch, "brb0"));
+  /* Nothing pending, no process */
+  UT_ASSERT_EQUAL(vlan_ip_batch_flush(&batch), 0);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "");
+  vlan_ip_batch_deinit(&batch);
+
+  vlan_ip_batch_init(&batch, 100, 1);
+  UT_ASSERT_EQUAL(vlan_ip_batch_deadline_ns(&batch), 0);
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owner, "link set %s up", "brb1"), 0);
+  UT_ASSERT_EQUAL(vlan_ip_batch_deadline_ns(&batch), batch.firstNs + 1000000u);
+  /* Flushing on time is up to the owner of the batch, queueing past the deadline does not */
+  usleep(5000);
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owner, "link set %s down", "brb1"), 0);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "");
+  UT_ASSERT_EQUAL(vlan_ip_batch_flush(&batch), 0);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "ip -force -batch -\nlink set brb1 up\nlink set brb1 down\n");
+  UT_ASSERT_EQUAL(vlan_ip_batch_deadline_ns(&batch), 0);
+  vlan_ip_batch_deinit(&batch);
+
+  stub_ip_remove();
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify a failing batch is reported by the flush, including one flushed automatically, and blamed on the right owners.
+ *
+ * **Test Group ID:** Skeleton: 12 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_ip_batch_failure(void)
+{
+  vlan_ip_batch_owner_t owners[3] = { { 1, 0, "brb2", "" }, { 1, 0, "brb3", "" }, { 2, 7, "brb3", "ipb0" } };
+  vlan_ip_batch_owner_t *failed;
+  vlan_ip_batch_t batch;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(stub_ip_install(), 0);
+  setenv("VLAN_HAL_TEST_IP_FAIL", "1", 1);
+
+  vlan_ip_batch_init(&batch, 2, 60000);
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owners[0], "link del %s", "brb2"), 0);
+  UT_ASSERT_EQUAL(vlan_ip_batch_flush(&batch), -EIO);
+  /* ip named no line, so every command failed */
+  UT_ASSERT_EQUAL(vlan_ip_batch_take_failed(&batch, &failed), 1);
+  UT_ASSERT_STRING_EQUAL(failed[0].brName, "brb2");
+  free(failed);
+
+  /* The automatic flush fails, the error waits for the next explicit one */
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owners[0], "link del %s", "brb2"), 0);
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owners[1], "link del %s", "brb3"), 0);
+  unsetenv("VLAN_HAL_TEST_IP_FAIL");
+  UT_ASSERT_EQUAL(vlan_ip_batch_flush(&batch), -EIO);
+  UT_ASSERT_EQUAL(vlan_ip_batch_flush(&batch), 0);
+  /* A claimed owner is left to its caller */
+  UT_ASSERT_TRUE(vlan_ip_batch_claim_failed(&batch, &owners[0]));
+  UT_ASSERT_FALSE(vlan_ip_batch_claim_failed(&batch, &owners[0]));
+  UT_ASSERT_EQUAL(vlan_ip_batch_take_failed(&batch, &failed), 1);
+  UT_ASSERT_STRING_EQUAL(failed[0].brName, "brb3");
+  free(failed);
+  UT_ASSERT_EQUAL(vlan_ip_batch_take_failed(&batch, &failed), 0);
+  vlan_ip_batch_deinit(&batch);
+  stub_ip_log();
+
+  /* Only the owners of the lines ip names failed, each once */
+  setenv("VLAN_HAL_TEST_IP_FAIL_LINES", "2 3", 1);
+  vlan_ip_batch_init(&batch, 100, 60000);
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owners[1], "link add name %s type bridge", "brb3"), 0);
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owners[2], "link add link %s name %s type vlan id %u", "ipb0", "ipb0.7", 7), 0);
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owners[2], "link set %s master %s up", "ipb0.7", "brb3"), 0);
+  UT_ASSERT_EQUAL(vlan_ip_batch_queue(&batch, &owners[0], "link del %s", "brb2"), 0);
+  UT_ASSERT_EQUAL(vlan_ip_batch_flush(&batch), -EIO);
+  UT_ASSERT_EQUAL(vlan_ip_batch_take_failed(&batch, &failed), 1);
+  UT_ASSERT_EQUAL(failed[0].op, 2);
+  UT_ASSERT_STRING_EQUAL(failed[0].ifName, "ipb0");
+  free(failed);
+  vlan_ip_batch_deinit(&batch);
+
+  stub_ip_remove();
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify bringing a group up through the ip backend costs a single ip process on commit.
+ *
+ * **Test Group ID:** Skeleton: 12 @n
+ * **Test Case ID:** 003 @n
+ */
+void test_vlan_hal_ip_batch_backend(void)
+{
+  vlan_hal_interface_t interfaces[2] = { { "ipb1", "3601", 0 }, { "ipb2", "3601", 0 } };
+  char vlanID[8];
+
+  gTestID = 3;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(stub_ip_install(), 0);
+  vlan_hal_backend_set(&vlan_hal_backend_ip);
+  UT_ASSERT_EQUAL(vlan_hal_backend_ip_configure(0, 60000), 0);
+
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brbatch0", "3601"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brbatch0", "ipb0", "3601"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addInterfaces("brbatch0", interfaces, 2), RETURN_OK);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "");
+  /* A query about links with nothing pending does not flush */
+  UT_ASSERT_EQUAL(_is_this_group_available_in_linux_bridge("brbatch9"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("ipb9", "brbatch9", "3601"), RETURN_ERR);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "");
+
+  UT_ASSERT_EQUAL(vlan_hal_commit(), RETURN_OK);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(),
+                         "ip -force -batch -\n"
+                         "link add name brbatch0 type bridge\n"
+                         "link set brbatch0 up\n"
+                         "link add link ipb0 name ipb0.3601 type vlan id 3601\n"
+                         "link set ipb0.3601 master brbatch0 up\n"
+                         "link add link ipb1 name ipb1.3601 type vlan id 3601\n"
+                         "link set ipb1.3601 master brbatch0 up\n"
+                         "link add link ipb2 name ipb2.3601 type vlan id 3601\n"
+                         "link set ipb2.3601 master brbatch0 up\n");
+
+  /* One about a link with pending commands does, whatever the answer */
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brbatch1", "3602"), RETURN_OK);
+  _is_this_group_available_in_linux_bridge("brbatch1");
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "ip -force -batch -\nlink add name brbatch1 type bridge\nlink set brbatch1 up\n");
+
+  /* Removing a bridge is applied at once */
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brbatch1"), RETURN_OK);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "ip -force -batch -\nlink del brbatch1\n");
+  /* and when that fails the group stays, with nothing left for the commit to report */
+  setenv("VLAN_HAL_TEST_IP_FAIL", "1", 1);
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brbatch0"), RETURN_ERR);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "ip -force -batch -\nlink del brbatch0\n");
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brbatch0", vlanID), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_commit(), RETURN_OK);
+  unsetenv("VLAN_HAL_TEST_IP_FAIL");
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brbatch0"), RETURN_OK);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "ip -force -batch -\nlink del brbatch0\n");
+
+  UT_ASSERT_EQUAL(vlan_hal_backend_ip_configure(0, 0), 0);
+  vlan_hal_backend_set(&vlan_hal_backend_none);
+  UT_ASSERT_EQUAL(vlan_hal_commit(), RETURN_OK);
+  stub_ip_remove();
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify the ip backend flushes by its deadline with no further call, and undoes a change that failed there.
+ *
+ * **Test Group ID:** Skeleton: 12 @n
+ * **Test Case ID:** 004 @n
+ */
+void test_vlan_hal_ip_batch_deadline(void)
+{
+  char vlanID[8];
+  int waited;
+
+  gTestID = 4;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(stub_ip_install(), 0);
+  vlan_hal_backend_set(&vlan_hal_backend_ip);
+  UT_ASSERT_EQUAL(vlan_hal_backend_ip_configure(0, 20), 0);
+
+  setenv("VLAN_HAL_TEST_IP_FAIL_LINES", "1", 1);
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brbatch2", "3603"), RETURN_OK);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brbatch2", vlanID), RETURN_OK);
+  for (waited = 0; (waited < 5000) && (get_vlanId_for_GroupName("brbatch2", vlanID) == RETURN_OK); waited += 10)
+  {
+    usleep(10000);
+  }
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brbatch2", vlanID), RETURN_ERR);
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "ip -force -batch -\nlink add name brbatch2 type bridge\nlink set brbatch2 up\n");
+  /* The failure is still reported, once */
+  UT_ASSERT_EQUAL(vlan_hal_commit(), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_commit(), RETURN_OK);
+
+  UT_ASSERT_EQUAL(vlan_hal_backend_ip_configure(0, 0), 0);
+  vlan_hal_backend_set(&vlan_hal_backend_none);
+  stub_ip_remove();
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify a commit that fails undoes exactly the changes whose commands failed.
+ *
+ * **Test Group ID:** Skeleton: 12 @n
+ * **Test Case ID:** 005 @n
+ */
+void test_vlan_hal_ip_batch_rollback(void)
+{
+  char vlanID[8];
+
+  gTestID = 5;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(stub_ip_install(), 0);
+  vlan_hal_backend_set(&vlan_hal_backend_ip);
+  UT_ASSERT_EQUAL(vlan_hal_backend_ip_configure(0, 60000), 0);
+
+  /* Lines 1-4 bring up brbatch3 and ipb3.3604, 5-8 brbatch4 and ipb4.3605 */
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brbatch3", "3604"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brbatch3", "ipb3", "3604"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brbatch4", "3605"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brbatch4", "ipb4", "3605"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brbatch4", "ipb5", "3605"), RETURN_OK);
+  setenv("VLAN_HAL_TEST_IP_FAIL_LINES", "1 8", 1);
+  UT_ASSERT_EQUAL(vlan_hal_commit(), RETURN_ERR);
+  unsetenv("VLAN_HAL_TEST_IP_FAIL_LINES");
+  stub_ip_log();
+
+  vlan_hal_backend_set(&vlan_hal_backend_none);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brbatch3", vlanID), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("ipb3", "3604"), RETURN_ERR);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brbatch4", vlanID), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("ipb4", "3605"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("ipb5", "brbatch4", "3605"), RETURN_OK);
+
+  /* A port removal that fails puts the port back */
+  vlan_hal_backend_set(&vlan_hal_backend_ip);
+  UT_ASSERT_EQUAL(vlan_hal_delInterface("brbatch4", "ipb5", "3605"), RETURN_OK);
+  setenv("VLAN_HAL_TEST_IP_FAIL_LINES", "1", 1);
+  UT_ASSERT_EQUAL(vlan_hal_commit(), RETURN_ERR);
+  unsetenv("VLAN_HAL_TEST_IP_FAIL_LINES");
+  UT_ASSERT_STRING_EQUAL(stub_ip_log(), "ip -force -batch -\nlink del ipb5.3605\n");
+  vlan_hal_backend_set(&vlan_hal_backend_none);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("ipb5", "brbatch4", "3605"), RETURN_OK);
+
+  vlan_hal_backend_set(&vlan_hal_backend_ip);
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brbatch4"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_backend_ip_configure(0, 0), 0);
+  vlan_hal_backend_set(&vlan_hal_backend_none);
+  UT_ASSERT_EQUAL(vlan_hal_commit(), RETURN_OK);
+  stub_ip_remove();
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton ip batching tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_ip_batch_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_ip_batch]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_ip_batch_thresholds", test_vlan_hal_ip_batch_thresholds, "ip_batch");
+  vlan_hal_test_add(pSuite, "vlan_hal_ip_batch_failure", test_vlan_hal_ip_batch_failure, "ip_batch");
+  vlan_hal_test_add(pSuite, "vlan_hal_ip_batch_backend", test_vlan_hal_ip_batch_backend, "ip_batch");
+  vlan_hal_test_add(pSuite, "vlan_hal_ip_batch_deadline", test_vlan_hal_ip_batch_deadline, "ip_batch");
+  vlan_hal_test_add(pSuite, "vlan_hal_ip_batch_rollback", test_vlan_hal_ip_batch_rollback, "ip_batch");
+
+  return 0;
+}
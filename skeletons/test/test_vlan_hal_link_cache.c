@@ -0,0 +1,247 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_link_cache.c
+ * @page vlan_hal_link_cache Skeleton link notification cache tests
+ *
+ * ## Module's Role
+ * Verifies that cached existence answers survive unrelated link
+ * notifications and are dropped by ones naming their bridge or port. The
+ * notification stream is simulated over a socketpair and the system is a
+ * fake sysfs tree, so the tests run without root.
+ *
+ * **Pre-Conditions:**  A writable temporary directory@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include "vlan_hal.h"
+#include "vlan_hal_backend.h"
+#include "vlan_hal_link_cache.h"
+#include "vlan_hal_sysfs.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 14;
+static int gTestID = 1;
+
+typedef struct
+{
+  struct nlmsghdr hdr;
+  struct ifinfomsg ifi;
+  char attrs[64];
+} link_event_t;
+
+/* Build an RTM_NEWLINK/RTM_DELLINK as the kernel sends it, @name NULL omits IFLA_IFNAME */
+static size_t link_event_build(link_event_t *event, uint16_t type, const char *name)
+{
+  struct rtattr *attr;
+
+  memset(event, 0, sizeof(*event));
+  event->hdr.nlmsg_type = type;
+  event->hdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+  event->ifi.ifi_family = AF_UNSPEC;
+  if (name != NULL)
+  {
+    attr = (struct rtattr *)((char *)event + NLMSG_ALIGN(event->hdr.nlmsg_len));
+    attr->rta_type = IFLA_IFNAME;
+    attr->rta_len = RTA_LENGTH(strlen(name) + 1);
+    memcpy(RTA_DATA(attr), name, strlen(name) + 1);
+    event->hdr.nlmsg_len = NLMSG_ALIGN(event->hdr.nlmsg_len) + RTA_ALIGN(attr->rta_len);
+  }
+  return event->hdr.nlmsg_len;
+}
+
+static void link_event_send(int fd, uint16_t type, const char *name)
+{
+  link_event_t event;
+  size_t length = link_event_build(&event, type, name);
+
+  UT_ASSERT_EQUAL(send(fd, &event, length, 0), (ssize_t)length);
+}
+
+/**
+ * @brief Verify invalidation by name, batched notifications and unattributable or lost notifications.
+ *
+ * **Test Group ID:** Skeleton: 14 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_link_cache_events(void)
+{
+  vlan_link_cache_t cache;
+  link_event_t events[2];
+  char datagram[2 * sizeof(link_event_t)];
+  size_t length;
+  uint32_t generation;
+  int fds[2];
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds), 0);
+  vlan_link_cache_attach(&cache, fds[0]);
+
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc0", NULL), -1);
+  vlan_link_cache_put(&cache, "brlc0", NULL, 1);
+  vlan_link_cache_put(&cache, "brlc0", "lc0.5", 1);
+  vlan_link_cache_put(&cache, "brlc0", "lc1.5", 0);
+  UT_ASSERT_EQUAL(vlan_link_cache_sync(&cache), 0);
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc0", NULL), 1);
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc0", "lc1.5"), 0);
+
+  /* Only a readable socket needs draining, each drained datagram moves the generation */
+  UT_ASSERT_EQUAL(vlan_link_cache_pending(&cache), 0);
+  generation = vlan_link_cache_generation(&cache);
+  link_event_send(fds[1], RTM_NEWLINK, "eth9");
+  UT_ASSERT_EQUAL(vlan_link_cache_pending(&cache), 1);
+  UT_ASSERT_EQUAL(vlan_link_cache_sync(&cache), 0);
+  UT_ASSERT_EQUAL(vlan_link_cache_pending(&cache), 0);
+  UT_ASSERT_TRUE(vlan_link_cache_generation(&cache) != generation);
+
+  /* Unrelated links leave the answers alone */
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc0", "lc0.5"), 1);
+
+  link_event_send(fds[1], RTM_DELLINK, "lc0.5");
+  UT_ASSERT_EQUAL(vlan_link_cache_sync(&cache), 0);
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc0", "lc0.5"), -1);
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc0", NULL), 1);
+
+  /* Two notifications in one datagram, a change to the bridge drops its port answers too */
+  vlan_link_cache_put(&cache, "brlc1", NULL, 0);
+  length = link_event_build(&events[0], RTM_NEWLINK, "brlc0");
+  memcpy(datagram, &events[0], length);
+  length += link_event_build(&events[1], RTM_NEWLINK, "brlc1");
+  memcpy(datagram + events[0].hdr.nlmsg_len, &events[1], events[1].hdr.nlmsg_len);
+  UT_ASSERT_EQUAL(send(fds[1], datagram, length, 0), (ssize_t)length);
+  UT_ASSERT_EQUAL(vlan_link_cache_sync(&cache), 0);
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc0", NULL), -1);
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc0", "lc1.5"), -1);
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc1", NULL), -1);
+  UT_ASSERT_EQUAL(cache.invalidations, 4);
+
+  /* A link notification without a name could be about anything */
+  vlan_link_cache_put(&cache, "brlc0", NULL, 1);
+  link_event_send(fds[1], RTM_NEWLINK, NULL);
+  UT_ASSERT_EQUAL(vlan_link_cache_sync(&cache), 0);
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc0", NULL), -1);
+
+  /* Without a notification source nothing is cached */
+  vlan_link_cache_put(&cache, "brlc0", NULL, 1);
+  close(fds[1]);
+  UT_ASSERT_EQUAL(vlan_link_cache_pending(&cache), 1);
+  UT_ASSERT_TRUE(vlan_link_cache_sync(&cache) < 0);
+  UT_ASSERT_EQUAL(cache.fd, -1);
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc0", NULL), -1);
+  vlan_link_cache_put(&cache, "brlc0", NULL, 1);
+  UT_ASSERT_EQUAL(vlan_link_cache_get(&cache, "brlc0", NULL), -1);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify the HAL existence queries are served from the cache until a notification arrives.
+ *
+ * **Test Group ID:** Skeleton: 14 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_link_cache_queries(void)
+{
+  static const char *tree[] = { "class", "class/net", "class/net/brlc2", "class/net/brlc2/bridge",
+                                "class/net/brlc2/brif", "class/net/brlc2/brif/lc2.7" };
+  const int treeSize = (int)(sizeof(tree) / sizeof(tree[0]));
+  char root[64];
+  char path[128];
+  int fds[2];
+  int i;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  strcpy(root, "/tmp/vlan_hal_link_cache_XXXXXX");
+  UT_ASSERT_PTR_NOT_NULL_FATAL(mkdtemp(root));
+  for (i = 0; i < treeSize; i++)
+  {
+    snprintf(path, sizeof(path), "%s/%s", root, tree[i]);
+    UT_ASSERT_EQUAL(mkdir(path, 0755), 0);
+  }
+  vlan_sysfs_set_root(root);
+  UT_ASSERT_EQUAL_FATAL(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds), 0);
+  vlan_hal_backend_link_cache_attach(fds[0]);
+  vlan_hal_backend_set(&vlan_hal_backend_netlink);
+
+  UT_ASSERT_EQUAL(_is_this_group_available_in_linux_bridge("brlc2"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("lc2", "brlc2", "7"), RETURN_OK);
+
+  /* The tree changes behind the cache's back: answers are still the cached ones */
+  for (i = treeSize - 1; i >= 2; i--)
+  {
+    snprintf(path, sizeof(path), "%s/%s", root, tree[i]);
+    rmdir(path);
+  }
+  UT_ASSERT_EQUAL(_is_this_group_available_in_linux_bridge("brlc2"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("lc2", "brlc2", "7"), RETURN_OK);
+
+  /* The kernel reports the port first, then the bridge */
+  link_event_send(fds[1], RTM_DELLINK, "lc2.7");
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("lc2", "brlc2", "7"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_group_available_in_linux_bridge("brlc2"), RETURN_OK);
+  link_event_send(fds[1], RTM_DELLINK, "brlc2");
+  UT_ASSERT_EQUAL(_is_this_group_available_in_linux_bridge("brlc2"), RETURN_ERR);
+
+  vlan_hal_backend_set(NULL);
+  vlan_hal_backend_link_cache_attach(-1);
+  close(fds[1]);
+  vlan_sysfs_set_root(NULL);
+  for (i = 1; i >= 0; i--)
+  {
+    snprintf(path, sizeof(path), "%s/%s", root, tree[i]);
+    rmdir(path);
+  }
+  rmdir(root);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton link notification cache tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_link_cache_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_link_cache]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_link_cache_events", test_vlan_hal_link_cache_events, "link_cache");
+  vlan_hal_test_add(pSuite, "vlan_hal_link_cache_queries", test_vlan_hal_link_cache_queries, "link_cache");
+
+  return 0;
+}
@@ -0,0 +1,256 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_name_pool.c
+ * @page vlan_hal_name_pool Skeleton name pool tests
+ *
+ * ## Module's Role
+ * Verifies that names are interned once, that handles stay valid while the
+ * arena grows, and that the group table and port index hand out the same
+ * handle for the same bridge name.
+ *
+ * **Pre-Conditions:**  None@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "vlan_hal_name_pool.h"
+#include "vlan_hal_group_table.h"
+#include "vlan_hal_port_index.h"
+#include "test_parallel.h"
+
+#define NAME_POOL_TEST_NAMES 20000
+
+static int gTestGroup = 16;
+static int gTestID = 1;
+
+/**
+ * @brief Verify interning, lookup and resolution of names.
+ *
+ * **Test Group ID:** Skeleton: 16 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_name_pool_intern(void)
+{
+  vlan_name_t first;
+  vlan_name_t second;
+  uint32_t count;
+  uint32_t countAfter;
+  size_t bytes;
+  size_t bytesAfter;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  first = vlan_name_intern("brnpool0");
+  UT_ASSERT_TRUE(first != VLAN_NAME_NONE);
+  UT_ASSERT_STRING_EQUAL(vlan_name_str(first), "brnpool0");
+  UT_ASSERT_EQUAL(vlan_name_find("brnpool0"), first);
+
+  /* A second intern is a lookup, the arena does not grow */
+  vlan_name_pool_stats(&count, &bytes);
+  second = vlan_name_intern("brnpool0");
+  vlan_name_pool_stats(&countAfter, &bytesAfter);
+  UT_ASSERT_EQUAL(second, first);
+  UT_ASSERT_EQUAL(countAfter, count);
+  UT_ASSERT_EQUAL(bytesAfter, bytes);
+
+  second = vlan_name_intern("brnpool1");
+  UT_ASSERT_TRUE((second != VLAN_NAME_NONE) && (second != first));
+  UT_ASSERT_STRING_EQUAL(vlan_name_str(first), "brnpool0");
+
+  UT_ASSERT_EQUAL(vlan_name_find("brnpool-never"), VLAN_NAME_NONE);
+  UT_ASSERT_EQUAL(vlan_name_intern(NULL), VLAN_NAME_NONE);
+  UT_ASSERT_EQUAL(vlan_name_intern(""), VLAN_NAME_NONE);
+  UT_ASSERT_EQUAL(vlan_name_intern("bridge-name-too-long"), VLAN_NAME_NONE);
+  UT_ASSERT_STRING_EQUAL(vlan_name_str(VLAN_NAME_NONE), "");
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify handles keep resolving while the arena spans several chunks.
+ *
+ * **Test Group ID:** Skeleton: 16 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_name_pool_growth(void)
+{
+  static vlan_name_t handles[NAME_POOL_TEST_NAMES];
+  char name[32];
+  int mismatches = 0;
+  int i;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  /* Roughly 200 KiB of names, past the first few arena chunks */
+  for (i = 0; i < NAME_POOL_TEST_NAMES; i++)
+  {
+    snprintf(name, sizeof(name), "npgrow%05d", i);
+    handles[i] = vlan_name_intern(name);
+    UT_ASSERT_FATAL(handles[i] != VLAN_NAME_NONE);
+  }
+  UT_ASSERT_TRUE((handles[NAME_POOL_TEST_NAMES - 1] >> 16) > (handles[0] >> 16));
+  for (i = 0; i < NAME_POOL_TEST_NAMES; i++)
+  {
+    snprintf(name, sizeof(name), "npgrow%05d", i);
+    if ((strcmp(vlan_name_str(handles[i]), name) != 0) || (vlan_name_find(name) != handles[i]))
+    {
+      mismatches++;
+    }
+  }
+  UT_ASSERT_EQUAL(mismatches, 0);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+typedef struct
+{
+  const vlan_name_t *handles;
+  int count;
+  int mismatches;
+} name_pool_reader_t;
+
+/* Resolves already published handles without any lock, as HAL readers do */
+static void *name_pool_reader(void *arg)
+{
+  name_pool_reader_t *reader = arg;
+  char name[32];
+  int round;
+  int i;
+
+  for (round = 0; round < 20; round++)
+  {
+    for (i = 0; i < reader->count; i++)
+    {
+      snprintf(name, sizeof(name), "npread%04d", i);
+      if (strcmp(vlan_name_str(reader->handles[i]), name) != 0)
+      {
+        reader->mismatches++;
+      }
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Verify resolution needs no lock while another thread interns new names.
+ *
+ * **Test Group ID:** Skeleton: 16 @n
+ * **Test Case ID:** 003 @n
+ */
+void test_vlan_hal_name_pool_concurrent(void)
+{
+  static vlan_name_t handles[1000];
+  name_pool_reader_t reader = { handles, 1000, 0 };
+  char name[32];
+  pthread_t thread;
+  int i;
+
+  gTestID = 3;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  for (i = 0; i < 1000; i++)
+  {
+    snprintf(name, sizeof(name), "npread%04d", i);
+    handles[i] = vlan_name_intern(name);
+  }
+  UT_ASSERT_EQUAL_FATAL(pthread_create(&thread, NULL, name_pool_reader, &reader), 0);
+  for (i = 0; i < 10000; i++)
+  {
+    snprintf(name, sizeof(name), "npwrite%05d", i);
+    vlan_name_intern(name);
+  }
+  pthread_join(thread, NULL);
+  UT_ASSERT_EQUAL(reader.mismatches, 0);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify the group table and port index refer to one bridge by the same handle.
+ *
+ * **Test Group ID:** Skeleton: 16 @n
+ * **Test Case ID:** 004 @n
+ */
+void test_vlan_hal_name_pool_tables(void)
+{
+  vlan_group_table_t table;
+  vlan_port_index_t index = { 0 };
+  vlan_group_entry_t *group;
+  vlan_port_entry_t *first;
+  vlan_port_entry_t *second;
+
+  gTestID = 4;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(vlan_group_table_init(&table, 0), 0);
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&table, "brnptab0", 3950), 0);
+  UT_ASSERT_EQUAL(vlan_port_index_insert(&index, "np0.3950", "np0", 3950, "brnptab0"), 0);
+  UT_ASSERT_EQUAL(vlan_port_index_insert(&index, "np1.3950", "np1", 3950, "brnptab0"), 0);
+
+  group = vlan_group_table_find(&table, "brnptab0");
+  first = vlan_port_index_find(&index, "np0.3950");
+  second = vlan_port_index_find(&index, "np1.3950");
+  UT_ASSERT_PTR_NOT_NULL_FATAL(group);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(first);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(second);
+  UT_ASSERT_EQUAL(first->bridge, group->name);
+  UT_ASSERT_EQUAL(second->bridge, group->name);
+  UT_ASSERT_EQUAL(first->port, vlan_name_find("np0.3950"));
+
+  /* Removing and re-adding a group reuses the interned name */
+  UT_ASSERT_EQUAL(vlan_group_table_remove(&table, "brnptab0"), 0);
+  UT_ASSERT_EQUAL(vlan_group_table_insert(&table, "brnptab0", 3951), 0);
+  group = vlan_group_table_find(&table, "brnptab0");
+  UT_ASSERT_PTR_NOT_NULL_FATAL(group);
+  UT_ASSERT_EQUAL(first->bridge, group->name);
+
+  vlan_port_index_deinit(&index);
+  vlan_group_table_deinit(&table);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton name pool tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_name_pool_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_name_pool]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_name_pool_intern", test_vlan_hal_name_pool_intern, "name_pool");
+  vlan_hal_test_add(pSuite, "vlan_hal_name_pool_growth", test_vlan_hal_name_pool_growth, "name_pool");
+  vlan_hal_test_add(pSuite, "vlan_hal_name_pool_concurrent", test_vlan_hal_name_pool_concurrent, "name_pool");
+  vlan_hal_test_add(pSuite, "vlan_hal_name_pool_tables", test_vlan_hal_name_pool_tables, "name_pool");
+
+  return 0;
+}
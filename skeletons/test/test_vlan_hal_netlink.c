@@ -0,0 +1,559 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_netlink.c
+ * @page vlan_hal_netlink Skeleton netlink backend tests
+ *
+ * ## Module's Role
+ * Verifies the rtnetlink messages produced by the skeleton's netlink backend.
+ * The kernel is replaced by an in-process fake peer on a SOCK_SEQPACKET
+ * socketpair, so the tests run without root or a real bridge.
+ *
+ * **Pre-Conditions:**  None@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include "vlan_hal.h"
+#include "vlan_hal_netlink.h"
+#include "vlan_hal_backend.h"
+#include "vlan_hal_ext.h"
+#include "test_parallel.h"
+
+#define FAKE_PEER_MAX_MESSAGES 16
+#define FAKE_PEER_MESSAGE_SIZE 1024
+
+static int gTestGroup = 2;
+static int gTestID = 1;
+
+typedef struct
+{
+  const char *name;
+  int ifIndex;
+} fake_link_t;
+
+/* Links the fake kernel knows about, for RTM_GETLINK */
+static const fake_link_t gFakeLinks[] =
+{
+  { "brlan0", 10 },
+  { "brtest0", 11 },
+  { "wl0", 2 },
+  { "wl0.100", 20 },
+};
+
+typedef struct
+{
+  int fd;
+  int error;                    /*!< Errno (negative) to answer non-GETLINK requests with */
+  int count;                    /*!< Netlink messages received */
+  int records;                  /*!< sendmsg() calls received */
+  pthread_t thread;
+  pthread_mutex_t lock;
+  char messages[FAKE_PEER_MAX_MESSAGES][FAKE_PEER_MESSAGE_SIZE];
+} fake_peer_t;
+
+static fake_peer_t gPeer;
+
+static const struct rtattr *find_attr(const struct rtattr *rta, int len, unsigned short type)
+{
+  for (; RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
+  {
+    if (rta->rta_type == type)
+    {
+      return rta;
+    }
+  }
+  return NULL;
+}
+
+static const struct rtattr *find_link_attr(const struct nlmsghdr *msg, unsigned short type)
+{
+  return find_attr(IFLA_RTA(NLMSG_DATA(msg)), (int)IFLA_PAYLOAD(msg), type);
+}
+
+static const struct rtattr *find_nested_attr(const struct rtattr *nest, unsigned short type)
+{
+  if (nest == NULL)
+  {
+    return NULL;
+  }
+  return find_attr((const struct rtattr *)RTA_DATA(nest), (int)RTA_PAYLOAD(nest), type);
+}
+
+static int fake_lookup(const char *name)
+{
+  size_t i;
+
+  for (i = 0; i < sizeof(gFakeLinks) / sizeof(gFakeLinks[0]); i++)
+  {
+    if (strcmp(gFakeLinks[i].name, name) == 0)
+    {
+      return gFakeLinks[i].ifIndex;
+    }
+  }
+  return 0;
+}
+
+static void fake_send_error(int fd, const struct nlmsghdr *req, int error)
+{
+  struct
+  {
+    struct nlmsghdr hdr;
+    struct nlmsgerr err;
+  } reply;
+
+  memset(&reply, 0, sizeof(reply));
+  reply.hdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct nlmsgerr));
+  reply.hdr.nlmsg_type = NLMSG_ERROR;
+  reply.hdr.nlmsg_seq = req->nlmsg_seq;
+  reply.err.error = error;
+  reply.err.msg = *req;
+  send(fd, &reply, reply.hdr.nlmsg_len, 0);
+}
+
+static void fake_send_link(int fd, const struct nlmsghdr *req, int ifIndex)
+{
+  struct
+  {
+    struct nlmsghdr hdr;
+    struct ifinfomsg ifi;
+  } reply;
+
+  memset(&reply, 0, sizeof(reply));
+  reply.hdr.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+  reply.hdr.nlmsg_type = RTM_NEWLINK;
+  reply.hdr.nlmsg_seq = req->nlmsg_seq;
+  reply.ifi.ifi_index = ifIndex;
+  send(fd, &reply, reply.hdr.nlmsg_len, 0);
+}
+
+static void fake_peer_answer(fake_peer_t *peer, const struct nlmsghdr *req)
+{
+  const struct rtattr *ifname;
+  int ifIndex;
+
+  pthread_mutex_lock(&peer->lock);
+  if (peer->count < FAKE_PEER_MAX_MESSAGES)
+  {
+    memcpy(peer->messages[peer->count++], req, req->nlmsg_len);
+  }
+  pthread_mutex_unlock(&peer->lock);
+
+  if (req->nlmsg_type == RTM_GETLINK)
+  {
+    ifname = find_link_attr(req, IFLA_IFNAME);
+    ifIndex = (ifname != NULL) ? fake_lookup((const char *)RTA_DATA(ifname)) : 0;
+    if (ifIndex > 0)
+    {
+      fake_send_link(peer->fd, req, ifIndex);
+    }
+    else
+    {
+      fake_send_error(peer->fd, req, -ENODEV);
+    }
+  }
+  else
+  {
+    fake_send_error(peer->fd, req, peer->error);
+  }
+}
+
+static void *fake_peer_main(void *arg)
+{
+  fake_peer_t *peer = (fake_peer_t *)arg;
+  char buffer[FAKE_PEER_MAX_MESSAGES * FAKE_PEER_MESSAGE_SIZE];
+  const struct nlmsghdr *req;
+  ssize_t received;
+  int remaining;
+
+  /* One record per sendmsg(), which may carry several netlink messages */
+  while ((received = recv(peer->fd, buffer, sizeof(buffer), 0)) > 0)
+  {
+    pthread_mutex_lock(&peer->lock);
+    peer->records++;
+    pthread_mutex_unlock(&peer->lock);
+    remaining = (int)received;
+    for (req = (const struct nlmsghdr *)buffer; NLMSG_OK(req, remaining); req = NLMSG_NEXT(req, remaining))
+    {
+      fake_peer_answer(peer, req);
+    }
+  }
+  return NULL;
+}
+
+/* Starts the fake peer and returns the client end of the socketpair */
+static int fake_peer_start(int error)
+{
+  int fds[2];
+
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) != 0)
+  {
+    return -1;
+  }
+  memset(gPeer.messages, 0, sizeof(gPeer.messages));
+  gPeer.fd = fds[1];
+  gPeer.error = error;
+  gPeer.count = 0;
+  gPeer.records = 0;
+  pthread_mutex_init(&gPeer.lock, NULL);
+  if (pthread_create(&gPeer.thread, NULL, fake_peer_main, &gPeer) != 0)
+  {
+    close(fds[0]);
+    close(fds[1]);
+    return -1;
+  }
+  return fds[0];
+}
+
+/* Closing the client end makes the peer's recv() return 0 */
+static void fake_peer_stop(void)
+{
+  pthread_join(gPeer.thread, NULL);
+  close(gPeer.fd);
+  pthread_mutex_destroy(&gPeer.lock);
+}
+
+static const struct nlmsghdr *fake_peer_message(int index)
+{
+  const struct nlmsghdr *msg = NULL;
+
+  pthread_mutex_lock(&gPeer.lock);
+  if (index < gPeer.count)
+  {
+    msg = (const struct nlmsghdr *)gPeer.messages[index];
+  }
+  pthread_mutex_unlock(&gPeer.lock);
+  return msg;
+}
+
+static int fake_peer_records(void)
+{
+  int records;
+
+  pthread_mutex_lock(&gPeer.lock);
+  records = gPeer.records;
+  pthread_mutex_unlock(&gPeer.lock);
+  return records;
+}
+
+static int message_has_ifname(const struct nlmsghdr *msg, const char *ifName)
+{
+  const struct rtattr *rta = find_link_attr(msg, IFLA_IFNAME);
+
+  return (rta != NULL) && (strcmp((const char *)RTA_DATA(rta), ifName) == 0);
+}
+
+static int message_has_kind(const struct nlmsghdr *msg, const char *kind)
+{
+  const struct rtattr *rta = find_nested_attr(find_link_attr(msg, IFLA_LINKINFO), IFLA_INFO_KIND);
+
+  return (rta != NULL) && (strcmp((const char *)RTA_DATA(rta), kind) == 0);
+}
+
+/**
+ * @brief Verify vlan_netlink_add_bridge() sends a single RTM_NEWLINK creating a "bridge" link.
+ *
+ * **Test Group ID:** Skeleton: 02 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_netlink_add_bridge(void)
+{
+  vlan_netlink_t nl;
+  const struct nlmsghdr *msg;
+  int fd;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  fd = fake_peer_start(0);
+  UT_ASSERT_FATAL(fd >= 0);
+  vlan_netlink_attach(&nl, fd);
+
+  UT_ASSERT_EQUAL(vlan_netlink_add_bridge(&nl, "brlan0"), 0);
+  vlan_netlink_close(&nl);
+  fake_peer_stop();
+
+  UT_ASSERT_EQUAL(gPeer.count, 1);
+  msg = fake_peer_message(0);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(msg);
+  UT_ASSERT_EQUAL(msg->nlmsg_type, RTM_NEWLINK);
+  UT_ASSERT_EQUAL(msg->nlmsg_flags, NLM_F_REQUEST | NLM_F_ACK | NLM_F_CREATE | NLM_F_EXCL);
+  UT_ASSERT_TRUE(message_has_ifname(msg, "brlan0"));
+  UT_ASSERT_TRUE(message_has_kind(msg, "bridge"));
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify vlan_netlink_add_vlan() resolves the parent link then creates an 802.1Q link on it.
+ *
+ * **Test Group ID:** Skeleton: 02 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_netlink_add_vlan(void)
+{
+  vlan_netlink_t nl;
+  const struct nlmsghdr *msg;
+  const struct rtattr *rta;
+  int fd;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  fd = fake_peer_start(0);
+  UT_ASSERT_FATAL(fd >= 0);
+  vlan_netlink_attach(&nl, fd);
+
+  UT_ASSERT_EQUAL(vlan_netlink_add_vlan(&nl, "wl0", 100, "wl0.100"), 0);
+  vlan_netlink_close(&nl);
+  fake_peer_stop();
+
+  UT_ASSERT_EQUAL(gPeer.count, 2);
+  msg = fake_peer_message(0);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(msg);
+  UT_ASSERT_EQUAL(msg->nlmsg_type, RTM_GETLINK);
+  UT_ASSERT_TRUE(message_has_ifname(msg, "wl0"));
+
+  msg = fake_peer_message(1);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(msg);
+  UT_ASSERT_EQUAL(msg->nlmsg_type, RTM_NEWLINK);
+  UT_ASSERT_TRUE(message_has_ifname(msg, "wl0.100"));
+  UT_ASSERT_TRUE(message_has_kind(msg, "vlan"));
+  rta = find_link_attr(msg, IFLA_LINK);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(rta);
+  UT_ASSERT_EQUAL(*(const uint32_t *)RTA_DATA(rta), 2);
+  rta = find_nested_attr(find_nested_attr(find_link_attr(msg, IFLA_LINKINFO), IFLA_INFO_DATA), IFLA_VLAN_ID);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(rta);
+  UT_ASSERT_EQUAL(*(const uint16_t *)RTA_DATA(rta), 100);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify vlan_netlink_set_master() enslaves and releases a port with RTM_SETLINK/IFLA_MASTER.
+ *
+ * **Test Group ID:** Skeleton: 02 @n
+ * **Test Case ID:** 003 @n
+ */
+void test_vlan_hal_netlink_set_master(void)
+{
+  vlan_netlink_t nl;
+  const struct nlmsghdr *msg;
+  const struct rtattr *rta;
+  int fd;
+
+  gTestID = 3;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  fd = fake_peer_start(0);
+  UT_ASSERT_FATAL(fd >= 0);
+  vlan_netlink_attach(&nl, fd);
+
+  UT_ASSERT_EQUAL(vlan_netlink_set_master(&nl, "wl0.100", "brlan0"), 0);
+  UT_ASSERT_EQUAL(vlan_netlink_set_master(&nl, "wl0.100", NULL), 0);
+  vlan_netlink_close(&nl);
+  fake_peer_stop();
+
+  UT_ASSERT_EQUAL(gPeer.count, 3);
+  msg = fake_peer_message(1);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(msg);
+  UT_ASSERT_EQUAL(msg->nlmsg_type, RTM_SETLINK);
+  UT_ASSERT_TRUE(message_has_ifname(msg, "wl0.100"));
+  rta = find_link_attr(msg, IFLA_MASTER);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(rta);
+  UT_ASSERT_EQUAL(*(const uint32_t *)RTA_DATA(rta), 10);
+
+  msg = fake_peer_message(2);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(msg);
+  rta = find_link_attr(msg, IFLA_MASTER);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(rta);
+  UT_ASSERT_EQUAL(*(const uint32_t *)RTA_DATA(rta), 0);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify errors reported by the peer are returned to the caller as negative errno values.
+ *
+ * **Test Group ID:** Skeleton: 02 @n
+ * **Test Case ID:** 004 @n
+ */
+void test_vlan_hal_netlink_errors(void)
+{
+  vlan_netlink_t nl;
+  int fd;
+
+  gTestID = 4;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  fd = fake_peer_start(-EPERM);
+  UT_ASSERT_FATAL(fd >= 0);
+  vlan_netlink_attach(&nl, fd);
+
+  UT_ASSERT_EQUAL(vlan_netlink_add_bridge(&nl, "brlan0"), -EPERM);
+  UT_ASSERT_EQUAL(vlan_netlink_add_vlan(&nl, "eth9", 10, "eth9.10"), -ENODEV);
+  UT_ASSERT_EQUAL(vlan_netlink_add_bridge(&nl, "an-interface-name-too-long"), -EINVAL);
+  vlan_netlink_close(&nl);
+  fake_peer_stop();
+
+  UT_ASSERT_EQUAL(gPeer.count, 2);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify the HAL entry points drive the netlink backend without spawning any process.
+ *
+ * **Test Group ID:** Skeleton: 02 @n
+ * **Test Case ID:** 005 @n
+ */
+void test_vlan_hal_netlink_backend(void)
+{
+  const struct nlmsghdr *msg;
+  int fd;
+
+  gTestID = 5;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  fd = fake_peer_start(0);
+  UT_ASSERT_FATAL(fd >= 0);
+  vlan_hal_backend_set(&vlan_hal_backend_netlink);
+  vlan_hal_backend_netlink_attach(fd);
+
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brtest0", "100"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brtest0", "wl0", "100"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brtest0"), RETURN_OK);
+
+  vlan_hal_backend_netlink_attach(-1);
+  vlan_hal_backend_set(NULL);
+  fake_peer_stop();
+
+  /* NEWLINK+SETLINK(up), GETLINK+NEWLINK(vlan)+SETLINK(up)+GETLINK+SETLINK(master), DELLINK */
+  UT_ASSERT_EQUAL(gPeer.count, 8);
+  msg = fake_peer_message(0);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(msg);
+  UT_ASSERT_TRUE(message_has_kind(msg, "bridge"));
+  msg = fake_peer_message(3);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(msg);
+  UT_ASSERT_TRUE(message_has_kind(msg, "vlan"));
+  msg = fake_peer_message(7);
+  UT_ASSERT_PTR_NOT_NULL_FATAL(msg);
+  UT_ASSERT_EQUAL(msg->nlmsg_type, RTM_DELLINK);
+  UT_ASSERT_TRUE(message_has_ifname(msg, "brtest0"));
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify vlan_hal_addInterfaces() applies a batch in two round trips and reports per-entry status.
+ *
+ * **Test Group ID:** Skeleton: 02 @n
+ * **Test Case ID:** 006 @n
+ */
+void test_vlan_hal_netlink_add_interfaces(void)
+{
+  vlan_hal_interface_t interfaces[] =
+  {
+    { "wl0", "100", RETURN_ERR },
+    { "eth9", "10", RETURN_ERR },
+    { "wl0", "0", RETURN_ERR },
+    { "wl0", "200", RETURN_ERR },
+  };
+  const struct nlmsghdr *msg;
+  const struct rtattr *rta;
+  int records;
+  int fd;
+  int i;
+
+  gTestID = 6;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  fd = fake_peer_start(0);
+  UT_ASSERT_FATAL(fd >= 0);
+  vlan_hal_backend_set(&vlan_hal_backend_netlink);
+  vlan_hal_backend_netlink_attach(fd);
+
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brtest0", "100"), RETURN_OK);
+  records = fake_peer_records();
+  UT_ASSERT_EQUAL(vlan_hal_addInterfaces("brtest0", interfaces, 4), RETURN_ERR);
+  records = fake_peer_records() - records;
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brtest0"), RETURN_OK);
+
+  vlan_hal_backend_netlink_attach(-1);
+  vlan_hal_backend_set(NULL);
+  fake_peer_stop();
+
+  UT_ASSERT_EQUAL(interfaces[0].status, RETURN_OK);
+  UT_ASSERT_EQUAL(interfaces[1].status, RETURN_ERR);
+  UT_ASSERT_EQUAL(interfaces[2].status, RETURN_ERR);
+  UT_ASSERT_EQUAL(interfaces[3].status, RETURN_OK);
+
+  /* One record resolving brtest0, wl0, eth9, wl0 and one creating both ports */
+  UT_ASSERT_EQUAL(records, 2);
+  UT_ASSERT_EQUAL(gPeer.count, 2 + 4 + 2 + 1);
+  for (i = 6; i < 8; i++)
+  {
+    msg = fake_peer_message(i);
+    UT_ASSERT_PTR_NOT_NULL_FATAL(msg);
+    UT_ASSERT_EQUAL(msg->nlmsg_type, RTM_NEWLINK);
+    UT_ASSERT_TRUE(message_has_kind(msg, "vlan"));
+    UT_ASSERT_EQUAL(((const struct ifinfomsg *)NLMSG_DATA(msg))->ifi_flags, IFF_UP);
+    rta = find_link_attr(msg, IFLA_MASTER);
+    UT_ASSERT_PTR_NOT_NULL_FATAL(rta);
+    UT_ASSERT_EQUAL(*(const uint32_t *)RTA_DATA(rta), 11);
+  }
+  UT_ASSERT_TRUE(message_has_ifname(fake_peer_message(6), "wl0.100"));
+  UT_ASSERT_TRUE(message_has_ifname(fake_peer_message(7), "wl0.200"));
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton netlink backend tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_netlink_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_netlink]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_netlink_add_bridge", test_vlan_hal_netlink_add_bridge, "netlink");
+  vlan_hal_test_add(pSuite, "vlan_hal_netlink_add_vlan", test_vlan_hal_netlink_add_vlan, "netlink");
+  vlan_hal_test_add(pSuite, "vlan_hal_netlink_set_master", test_vlan_hal_netlink_set_master, "netlink");
+  vlan_hal_test_add(pSuite, "vlan_hal_netlink_errors", test_vlan_hal_netlink_errors, "netlink");
+  vlan_hal_test_add(pSuite, "vlan_hal_netlink_backend", test_vlan_hal_netlink_backend, "netlink");
+  vlan_hal_test_add(pSuite, "vlan_hal_netlink_add_interfaces", test_vlan_hal_netlink_add_interfaces, "netlink");
+
+  return 0;
+}
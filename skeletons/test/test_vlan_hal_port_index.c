@@ -0,0 +1,186 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_port_index.c
+ * @page vlan_hal_port_index Skeleton port index tests
+ *
+ * ## Module's Role
+ * Verifies the port to bridge reverse index and that the skeleton keeps it
+ * in step with interface add/delete, so the _is_this_interface_available_*()
+ * queries reflect the current bridge membership.
+ *
+ * **Pre-Conditions:**  None@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <string.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "vlan_hal_port_index.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 4;
+static int gTestID = 1;
+
+/**
+ * @brief Verify insert, move, remove and growth of the index.
+ *
+ * **Test Group ID:** Skeleton: 04 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_port_index_basic(void)
+{
+  vlan_port_index_t index = {0};
+  vlan_port_entry_t *entry;
+  char port[IFNAMSIZ];
+  uint32_t cursor = 0;
+  int seen = 0;
+  int i;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_PTR_NULL(vlan_port_index_find(&index, "eth0.10"));
+  UT_ASSERT_EQUAL(vlan_port_index_insert(&index, "eth0.10", "eth0", 10, "brlan0"), 0);
+  entry = vlan_port_index_find(&index, "eth0.10");
+  UT_ASSERT_PTR_NOT_NULL(entry);
+  if (entry != NULL)
+  {
+    UT_ASSERT_STRING_EQUAL(vlan_name_str(entry->bridge), "brlan0");
+    UT_ASSERT_STRING_EQUAL(vlan_name_str(entry->ifName), "eth0");
+    UT_ASSERT_EQUAL(entry->vlanID, 10);
+  }
+
+  /* Re-adding to another bridge moves the port */
+  UT_ASSERT_EQUAL(vlan_port_index_insert(&index, "eth0.10", "eth0", 10, "brlan1"), 0);
+  UT_ASSERT_EQUAL(index.count, 1);
+  entry = vlan_port_index_find(&index, "eth0.10");
+  UT_ASSERT_PTR_NOT_NULL(entry);
+  if (entry != NULL)
+  {
+    UT_ASSERT_STRING_EQUAL(vlan_name_str(entry->bridge), "brlan1");
+  }
+  UT_ASSERT_EQUAL(vlan_port_index_insert(&index, "eth0.10", "eth0", 10, "bridge-name-too-long"), -1);
+  UT_ASSERT_EQUAL(vlan_port_index_insert(&index, "", "eth0", 10, "brlan0"), -1);
+
+  for (i = 1; i <= 200; i++)
+  {
+    snprintf(port, sizeof(port), "wl%d.%d", i, i);
+    UT_ASSERT_EQUAL(vlan_port_index_insert(&index, port, "wl", (uint16_t)i, "brlan0"), 0);
+  }
+  UT_ASSERT_EQUAL(index.count, 201);
+  while ((entry = vlan_port_index_next(&index, &cursor)) != NULL)
+  {
+    if (strcmp(vlan_name_str(entry->bridge), "brlan0") == 0)
+    {
+      seen++;
+      vlan_port_index_remove(&index, vlan_name_str(entry->port));
+    }
+  }
+  UT_ASSERT_EQUAL(seen, 200);
+  UT_ASSERT_EQUAL(index.count, 1);
+  UT_ASSERT_EQUAL(vlan_port_index_remove(&index, "wl1.1"), -1);
+  UT_ASSERT_PTR_NOT_NULL(vlan_port_index_find(&index, "eth0.10"));
+
+  vlan_port_index_deinit(&index);
+  UT_ASSERT_PTR_NULL(vlan_port_index_find(&index, "eth0.10"));
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify the availability queries follow interface add, move and delete.
+ *
+ * **Test Group ID:** Skeleton: 04 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_port_index_membership(void)
+{
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brpi0", "3001"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brpi1", "3002"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_group_available_in_linux_bridge("brpi0"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_group_available_in_linux_bridge("brpi9"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_group_available_in_linux_bridge(""), RETURN_ERR);
+
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("pi0", "3001"), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brpi0", "pi0", "3001"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("pi0", "3001"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("pi0", "3002"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("pi0", "brpi0", "3001"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("pi0", "brpi1", "3001"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("pi0", "", "3001"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("", "3001"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("pi0", ""), RETURN_ERR);
+
+  /* A port is deleted only from the bridge that holds it */
+  UT_ASSERT_EQUAL(vlan_hal_delInterface("brpi1", "pi0", "3001"), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brpi1", "pi0", "3001"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("pi0", "brpi0", "3001"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("pi0", "brpi1", "3001"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_delInterface("brpi1", "pi0", "3001"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("pi0", "3001"), RETURN_ERR);
+
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brpi0", "pi0", "3001"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brpi0", "pi1", "3001"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brpi1", "pi2", "3002"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_delete_all_Interfaces("brpi0"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("pi0", "3001"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("pi1", "3001"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("pi2", "3002"), RETURN_OK);
+
+  /* Deleting a group drops its ports too */
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brpi1"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("pi2", "3002"), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brpi0"), RETURN_OK);
+
+  /* So does dropping its config entry */
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brpi2", "3003"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brpi2", "pi3", "3003"), RETURN_OK);
+  UT_ASSERT_EQUAL(delete_VLAN_ConfigEntry("brpi2"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("pi3", "3003"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("pi3", "brpi2", "3003"), RETURN_ERR);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton port index tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_port_index_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_port_index]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_port_index_basic", test_vlan_hal_port_index_basic, "port_index");
+  vlan_hal_test_add(pSuite, "vlan_hal_port_index_membership", test_vlan_hal_port_index_membership, "port_index");
+
+  return 0;
+}
@@ -0,0 +1,250 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_reader.c
+ * @page vlan_hal_reader Skeleton command output reader tests
+ *
+ * ## Module's Role
+ * Verifies line splitting across read chunks, the growable arena, and the
+ * shell output helpers built on them.
+ *
+ * **Pre-Conditions:**  A writable temporary directory and a POSIX shell@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "vlan_hal_reader.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 10;
+static int gTestID = 1;
+
+/* Ten lines of up to 6 bytes, a 12 byte line and an unterminated last line */
+static const char gLines[] = "1\n22\n333\n4444\n55555\n666666\n7\n88\n999\n10\nabcdefghijkl\nend";
+
+typedef struct
+{
+  char joined[128];
+  int lines;
+  int stopAt;
+} reader_lines_t;
+
+static int reader_collect(void *ctx, char *line, size_t length)
+{
+  reader_lines_t *collected = ctx;
+
+  UT_ASSERT_EQUAL(strlen(line), length);
+  strcat(collected->joined, line);
+  strcat(collected->joined, "|");
+  collected->lines++;
+  return (collected->lines == collected->stopAt) ? 7 : 0;
+}
+
+static int reader_temp_file(const char *data)
+{
+  char path[] = "/tmp/vlan_hal_reader_XXXXXX";
+  int fd = mkstemp(path);
+
+  if (fd < 0)
+  {
+    return -1;
+  }
+  unlink(path);
+  if ((write(fd, data, strlen(data)) != (ssize_t)strlen(data)) || (lseek(fd, 0, SEEK_SET) != 0))
+  {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/**
+ * @brief Verify lines are split correctly whatever the buffer size, and the callback can stop the read.
+ *
+ * **Test Group ID:** Skeleton: 10 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_reader_lines(void)
+{
+  reader_lines_t collected;
+  char buffer[8];
+  int fd;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  fd = reader_temp_file(gLines);
+  UT_ASSERT_TRUE(fd >= 0);
+
+  memset(&collected, 0, sizeof(collected));
+  UT_ASSERT_EQUAL(vlan_reader_lines(fd, NULL, 0, reader_collect, &collected), 0);
+  UT_ASSERT_STRING_EQUAL(collected.joined, "1|22|333|4444|55555|666666|7|88|999|10|abcdefghijkl|end|");
+
+  /* A 12 byte line does not fit in 7 usable bytes and arrives in two pieces */
+  lseek(fd, 0, SEEK_SET);
+  memset(&collected, 0, sizeof(collected));
+  UT_ASSERT_EQUAL(vlan_reader_lines(fd, buffer, sizeof(buffer), reader_collect, &collected), 0);
+  UT_ASSERT_STRING_EQUAL(collected.joined, "1|22|333|4444|55555|666666|7|88|999|10|abcdefg|hijkl|end|");
+
+  lseek(fd, 0, SEEK_SET);
+  memset(&collected, 0, sizeof(collected));
+  collected.stopAt = 3;
+  UT_ASSERT_EQUAL(vlan_reader_lines(fd, buffer, sizeof(buffer), reader_collect, &collected), 7);
+  UT_ASSERT_STRING_EQUAL(collected.joined, "1|22|333|");
+
+  UT_ASSERT_TRUE(vlan_reader_lines(fd, buffer, 1, reader_collect, &collected) < 0);
+  UT_ASSERT_TRUE(vlan_reader_lines(-1, NULL, 0, reader_collect, &collected) < 0);
+  close(fd);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify the arena collects the whole input and keeps its allocation for reuse.
+ *
+ * **Test Group ID:** Skeleton: 10 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_reader_arena(void)
+{
+  vlan_reader_arena_t arena = VLAN_READER_ARENA_INIT;
+  char *data;
+  char *first;
+  size_t capacity;
+  int fd;
+  int i;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  /* Several times the minimum allocation, so the arena has to grow */
+  data = malloc(10000);
+  UT_ASSERT_PTR_NOT_NULL(data);
+  for (i = 0; i < 9999; i++)
+  {
+    data[i] = (i % 64 == 63) ? '\n' : (char)('a' + (i % 26));
+  }
+  data[9999] = '\0';
+  fd = reader_temp_file(data);
+  UT_ASSERT_TRUE(fd >= 0);
+
+  UT_ASSERT_EQUAL(vlan_reader_slurp(fd, &arena), 0);
+  UT_ASSERT_EQUAL(arena.length, 9999);
+  UT_ASSERT_TRUE(arena.capacity > arena.length);
+  UT_ASSERT_STRING_EQUAL(arena.data, data);
+
+  first = arena.data;
+  capacity = arena.capacity;
+  lseek(fd, 0, SEEK_SET);
+  UT_ASSERT_EQUAL(vlan_reader_slurp(fd, &arena), 0);
+  UT_ASSERT_EQUAL(arena.length, 9999);
+  UT_ASSERT_TRUE(arena.data == first);
+  UT_ASSERT_EQUAL(arena.capacity, capacity);
+
+  /* At end of input the arena is empty but still terminated */
+  UT_ASSERT_EQUAL(vlan_reader_slurp(fd, &arena), 0);
+  UT_ASSERT_EQUAL(arena.length, 0);
+  UT_ASSERT_STRING_EQUAL(arena.data, "");
+
+  vlan_reader_arena_release(&arena);
+  UT_ASSERT_PTR_NULL(arena.data);
+  close(fd);
+  free(data);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify the shell output helpers: truncation, full reads and line streaming.
+ *
+ * **Test Group ID:** Skeleton: 10 @n
+ * **Test Case ID:** 003 @n
+ */
+void test_vlan_hal_reader_shell(void)
+{
+  reader_lines_t collected;
+  char out[512];
+  size_t length = 0;
+  char *all;
+  FILE *fp;
+
+  gTestID = 3;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  _get_shell_outputbuffer("echo brlan0", out, sizeof(out));
+  UT_ASSERT_STRING_EQUAL(out, "brlan0");
+
+  /* Truncated output is still terminated, and the rest is drained so the command exits cleanly */
+  fp = popen("i=0; while [ $i -lt 2000 ]; do echo line$i; i=$((i+1)); done", "r");
+  UT_ASSERT_PTR_NOT_NULL(fp);
+  _get_shell_outputbuffer_res(fp, out, 12);
+  UT_ASSERT_STRING_EQUAL(out, "line0\nline1");
+  UT_ASSERT_EQUAL(pclose(fp), 0);
+
+  fp = popen("i=0; while [ $i -lt 2000 ]; do echo line$i; i=$((i+1)); done", "r");
+  UT_ASSERT_PTR_NOT_NULL(fp);
+  all = vlan_hal_read_all(fp, &length);
+  pclose(fp);
+  UT_ASSERT_PTR_NOT_NULL(all);
+  /* "line" and '\n' on each, plus 10 one-digit, 90 two-digit, 900 three-digit and 1000 four-digit suffixes */
+  UT_ASSERT_EQUAL(length, 2000 * 5 + 10 * 1 + 90 * 2 + 900 * 3 + 1000 * 4);
+  UT_ASSERT_STRING_EQUAL(all + length - 9, "line1999\n");
+  free(all);
+
+  fp = popen("printf 'bridge name\\tbridge id\\nbrlan0\\t8000.0\\n'", "r");
+  UT_ASSERT_PTR_NOT_NULL(fp);
+  memset(&collected, 0, sizeof(collected));
+  UT_ASSERT_EQUAL(vlan_hal_read_lines(fp, reader_collect, &collected), RETURN_OK);
+  pclose(fp);
+  UT_ASSERT_EQUAL(collected.lines, 2);
+  UT_ASSERT_STRING_EQUAL(collected.joined, "bridge name\tbridge id|brlan0\t8000.0|");
+
+  UT_ASSERT_EQUAL(vlan_hal_read_lines(NULL, reader_collect, &collected), RETURN_ERR);
+  UT_ASSERT_PTR_NULL(vlan_hal_read_all(NULL, &length));
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton command output reader tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_reader_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_reader]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_reader_lines", test_vlan_hal_reader_lines, "reader");
+  vlan_hal_test_add(pSuite, "vlan_hal_reader_arena", test_vlan_hal_reader_arena, "reader");
+  vlan_hal_test_add(pSuite, "vlan_hal_reader_shell", test_vlan_hal_reader_shell, "reader");
+
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_spawn.c
+ * @page vlan_hal_spawn Skeleton command runner tests
+ *
+ * ## Module's Role
+ * Verifies commands are run from argv without a shell, their output is
+ * captured, and exit statuses are reported as a shell would.
+ *
+ * **Pre-Conditions:**  echo, seq and sh on PATH@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <string.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "vlan_hal_spawn.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 11;
+static int gTestID = 1;
+
+typedef struct
+{
+  int lines;
+  int stopAt;
+  char last[32];
+} spawn_lines_t;
+
+static int spawn_count(void *ctx, char *line, size_t length)
+{
+  spawn_lines_t *count = ctx;
+
+  (void)length;
+  count->lines++;
+  snprintf(count->last, sizeof(count->last), "%s", line);
+  return (count->lines == count->stopAt) ? 1 : 0;
+}
+
+/**
+ * @brief Verify output capture, literal arguments and exit status reporting.
+ *
+ * **Test Group ID:** Skeleton: 11 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_spawn_output(void)
+{
+  const char *const echoArgv[] = { "echo", "a|b", "$HOME", ";", NULL };
+  const char *const falseArgv[] = { "sh", "-c", "exit 3", NULL };
+  const char *const killedArgv[] = { "sh", "-c", "kill -9 $$", NULL };
+  const char *const missingArgv[] = { "vlan_hal_no_such_command", NULL };
+  vlan_reader_arena_t arena = VLAN_READER_ARENA_INIT;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  /* No shell in between, so metacharacters reach the command untouched */
+  UT_ASSERT_EQUAL(vlan_spawn_output(echoArgv, &arena), 0);
+  UT_ASSERT_STRING_EQUAL(arena.data, "a|b $HOME ;\n");
+
+  UT_ASSERT_EQUAL(vlan_spawn_output(falseArgv, &arena), 3);
+  UT_ASSERT_EQUAL(arena.length, 0);
+  UT_ASSERT_EQUAL(vlan_spawn_output(killedArgv, &arena), 128 + 9);
+  UT_ASSERT_TRUE(vlan_spawn_output(missingArgv, &arena) < 0);
+  UT_ASSERT_TRUE(vlan_spawn_start(NULL, echoArgv) < 0);
+
+  vlan_reader_arena_release(&arena);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify vlan_hal_run() streams lines and lets the command finish when the callback stops early.
+ *
+ * **Test Group ID:** Skeleton: 11 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_spawn_run(void)
+{
+  const char *const seqArgv[] = { "seq", "1", "100000", NULL };
+  const char *const missingArgv[] = { "vlan_hal_no_such_command", NULL };
+  spawn_lines_t count;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  memset(&count, 0, sizeof(count));
+  UT_ASSERT_EQUAL(vlan_hal_run(seqArgv, spawn_count, &count), 0);
+  UT_ASSERT_EQUAL(count.lines, 100000);
+  UT_ASSERT_STRING_EQUAL(count.last, "100000");
+
+  /* The rest is drained, so seq exits normally rather than on SIGPIPE */
+  memset(&count, 0, sizeof(count));
+  count.stopAt = 3;
+  UT_ASSERT_EQUAL(vlan_hal_run(seqArgv, spawn_count, &count), 0);
+  UT_ASSERT_EQUAL(count.lines, 3);
+  UT_ASSERT_STRING_EQUAL(count.last, "3");
+
+  UT_ASSERT_EQUAL(vlan_hal_run(seqArgv, NULL, NULL), 0);
+  UT_ASSERT_EQUAL(vlan_hal_run(missingArgv, spawn_count, &count), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_run(NULL, spawn_count, &count), RETURN_ERR);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton command runner tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_spawn_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_spawn]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_spawn_output", test_vlan_hal_spawn_output, "spawn");
+  vlan_hal_test_add(pSuite, "vlan_hal_spawn_run", test_vlan_hal_spawn_run, "spawn");
+
+  return 0;
+}
@@ -0,0 +1,195 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_sysfs.c
+ * @page vlan_hal_sysfs Skeleton sysfs existence check tests
+ *
+ * ## Module's Role
+ * Verifies the bridge and bridge port existence checks against a fake sysfs
+ * tree built in a temporary directory, and that the HAL queries use them
+ * when the backend provides them.
+ *
+ * **Pre-Conditions:**  A writable temporary directory@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "vlan_hal.h"
+#include "vlan_hal_backend.h"
+#include "vlan_hal_sysfs.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 5;
+static int gTestID = 1;
+
+/* Relative to the fake root, created in order and removed in reverse */
+static const char *gFakeTree[] =
+{
+  "class",
+  "class/net",
+  "class/net/brsys0",
+  "class/net/brsys0/bridge",
+  "class/net/brsys0/brif",
+  "class/net/brsys0/brif/sys0.100",
+  "class/net/sys0",
+  "class/net/sys0.100",
+};
+
+#define FAKE_TREE_SIZE (int)(sizeof(gFakeTree) / sizeof(gFakeTree[0]))
+
+static char gFakeRoot[64];
+
+static int fake_tree_create(void)
+{
+  char path[256];
+  int i;
+
+  strcpy(gFakeRoot, "/tmp/vlan_hal_sysfs_XXXXXX");
+  if (mkdtemp(gFakeRoot) == NULL)
+  {
+    return -1;
+  }
+  for (i = 0; i < FAKE_TREE_SIZE; i++)
+  {
+    snprintf(path, sizeof(path), "%s/%s", gFakeRoot, gFakeTree[i]);
+    if (mkdir(path, 0755) != 0)
+    {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static void fake_tree_remove(void)
+{
+  char path[256];
+  int i;
+
+  for (i = FAKE_TREE_SIZE - 1; i >= 0; i--)
+  {
+    snprintf(path, sizeof(path), "%s/%s", gFakeRoot, gFakeTree[i]);
+    rmdir(path);
+  }
+  rmdir(gFakeRoot);
+}
+
+/**
+ * @brief Verify bridge and port checks, name validation and a missing root.
+ *
+ * **Test Group ID:** Skeleton: 05 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_sysfs_checks(void)
+{
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(fake_tree_create(), 0);
+  vlan_sysfs_set_root(gFakeRoot);
+
+  UT_ASSERT_EQUAL(vlan_sysfs_has_bridge("brsys0"), 1);
+  UT_ASSERT_EQUAL(vlan_sysfs_has_bridge("sys0"), 0);
+  UT_ASSERT_EQUAL(vlan_sysfs_has_bridge("brsys1"), 0);
+  UT_ASSERT_EQUAL(vlan_sysfs_has_port("brsys0", "sys0.100"), 1);
+  UT_ASSERT_EQUAL(vlan_sysfs_has_port("brsys0", "sys0"), 0);
+  UT_ASSERT_EQUAL(vlan_sysfs_has_port("sys0", "sys0.100"), 0);
+
+  /* Names that would escape class/net or are not link names */
+  UT_ASSERT_EQUAL(vlan_sysfs_has_bridge(""), 0);
+  UT_ASSERT_EQUAL(vlan_sysfs_has_bridge(NULL), 0);
+  UT_ASSERT_EQUAL(vlan_sysfs_has_bridge(".."), 0);
+  UT_ASSERT_EQUAL(vlan_sysfs_has_bridge("brsys0/brif"), 0);
+  UT_ASSERT_EQUAL(vlan_sysfs_has_port("brsys0", "../bridge"), 0);
+
+  fake_tree_remove();
+  vlan_sysfs_set_root(gFakeRoot);
+  UT_ASSERT_TRUE(vlan_sysfs_has_bridge("brsys0") < 0);
+  vlan_sysfs_set_root(NULL);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify the HAL existence queries answer from sysfs when the backend provides it.
+ *
+ * **Test Group ID:** Skeleton: 05 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_sysfs_queries(void)
+{
+  /* Memory-only operations with the sysfs queries, as the netlink backend pairs them */
+  vlan_hal_backend_t backend = vlan_hal_backend_none;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL_FATAL(fake_tree_create(), 0);
+  vlan_sysfs_set_root(gFakeRoot);
+
+  backend.has_bridge = vlan_sysfs_has_bridge;
+  backend.has_port = vlan_sysfs_has_port;
+  vlan_hal_backend_set(&backend);
+
+  /* Known to the system though never added through the HAL */
+  UT_ASSERT_EQUAL(_is_this_group_available_in_linux_bridge("brsys0"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_group_available_in_linux_bridge("brsys1"), RETURN_ERR);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("sys0", "brsys0", "100"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_given_linux_bridge("sys0", "brsys0", "200"), RETURN_ERR);
+
+  /* The reverse index names the bridge, sysfs confirms membership */
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("sys0", "100"), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brsys0", "3100"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brsys0", "sys0", "100"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brsys0", "sys0", "200"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("sys0", "100"), RETURN_OK);
+  UT_ASSERT_EQUAL(_is_this_interface_available_in_linux_bridge("sys0", "200"), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brsys0"), RETURN_OK);
+
+  vlan_hal_backend_set(NULL);
+  vlan_sysfs_set_root(NULL);
+  fake_tree_remove();
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton sysfs tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_sysfs_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_sysfs]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_sysfs_checks", test_vlan_hal_sysfs_checks, "sysfs");
+  vlan_hal_test_add(pSuite, "vlan_hal_sysfs_queries", test_vlan_hal_sysfs_queries, "sysfs");
+
+  return 0;
+}
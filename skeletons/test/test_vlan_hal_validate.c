@@ -0,0 +1,199 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_validate.c
+ * @page vlan_hal_validate Skeleton input validation tests
+ *
+ * ## Module's Role
+ * Verifies the shared VLAN ID and link name checks against the malformed
+ * inputs the L1 suite uses and, for VLAN IDs, against a straightforward
+ * reference parser over every short digit string.
+ *
+ * **Pre-Conditions:**  None@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vlan_hal.h"
+#include "vlan_hal_validate.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 15;
+static int gTestID = 1;
+
+/* The parser vlan_validate_vlan_id() replaced, one character at a time */
+static int reference_vlan_id(const char *vlanID, unsigned int *value)
+{
+  unsigned int parsed = 0;
+  const char *p = vlanID;
+
+  if ((*vlanID < '1') || (*vlanID > '9'))
+  {
+    return -1;
+  }
+  while (*p != '\0')
+  {
+    if ((*p < '0') || (*p > '9') || ((p - vlanID) >= 4))
+    {
+      return -1;
+    }
+    parsed = (parsed * 10) + (unsigned int)(*p - '0');
+    p++;
+  }
+  if ((parsed < 1) || (parsed > 4094))
+  {
+    return -1;
+  }
+  *value = parsed;
+  return 0;
+}
+
+/**
+ * @brief Verify VLAN ID parsing agrees with the reference parser on every digit string up to 5 long, and on malformed input.
+ *
+ * **Test Group ID:** Skeleton: 15 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_validate_vlan_id(void)
+{
+  static const char *invalid[] = { "", "0", "4095", "01", "+1", "-1", " 1", "1 ", "1a", "a1", "12:4", "4/94",
+                                   "99999", "40940", "1e3", "0x10" };
+  static const char *valid[] = { "1", "10", "2052", "4094" };
+  static const char *filler = "0123456789/:";
+  char vlanID[8];
+  unsigned int expected = 0;
+  unsigned int i;
+  unsigned int n;
+  uint16_t value = 0;
+  int mismatches = 0;
+  int length;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  /* Every string of 1 to 5 characters over the digits and their two neighbours in ASCII */
+  for (length = 1; length <= 5; length++)
+  {
+    unsigned int combinations = 1;
+
+    for (i = 0; i < (unsigned int)length; i++)
+    {
+      combinations *= 12;
+    }
+    for (n = 0; n < combinations; n++)
+    {
+      unsigned int rest = n;
+
+      for (i = 0; i < (unsigned int)length; i++)
+      {
+        vlanID[i] = filler[rest % 12];
+        rest /= 12;
+      }
+      vlanID[length] = '\0';
+      if (reference_vlan_id(vlanID, &expected) != 0)
+      {
+        mismatches += (vlan_validate_vlan_id(vlanID, &value) != -1);
+      }
+      else
+      {
+        mismatches += (vlan_validate_vlan_id(vlanID, &value) != 0) || (value != expected);
+      }
+    }
+  }
+  UT_ASSERT_EQUAL(mismatches, 0);
+
+  for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+  {
+    UT_ASSERT_EQUAL(vlan_validate_vlan_id(invalid[i], &value), -1);
+  }
+  for (i = 0; i < sizeof(valid) / sizeof(valid[0]); i++)
+  {
+    UT_ASSERT_EQUAL(vlan_validate_vlan_id(valid[i], &value), 0);
+    UT_ASSERT_EQUAL(value, (uint16_t)atoi(valid[i]));
+  }
+  UT_ASSERT_EQUAL(vlan_validate_vlan_id(NULL, &value), -1);
+
+  /* Out of range values as the L1 suite generates them */
+  for (i = 0; i < 1000; i++)
+  {
+    snprintf(vlanID, sizeof(vlanID), "%d", 4095 + (rand() % 1000000));
+    UT_ASSERT_EQUAL(vlan_validate_vlan_id(vlanID, &value), -1);
+  }
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify link name checks: length bounds, allowed characters and reserved names.
+ *
+ * **Test Group ID:** Skeleton: 15 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_validate_name(void)
+{
+  static const char *invalid[] = { "", ".", "..", "brlan@10", "br lan0", "br/lan0", "br:0", "brlan0\n",
+                                   "brlan0123456789x", "br\xc3\xa9lan" };
+  static const char *valid[] = { "brlan0", "brlan112", "wl0.2", "bRLaN0", "brlanXYZ", "1234", "...",
+                                 "br-lan_0", "brlan012345678x" };
+  unsigned int i;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  for (i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+  {
+    UT_ASSERT_EQUAL(vlan_validate_name(invalid[i]), -1);
+  }
+  for (i = 0; i < sizeof(valid) / sizeof(valid[0]); i++)
+  {
+    UT_ASSERT_EQUAL(vlan_validate_name(valid[i]), (int)strlen(valid[i]));
+  }
+  UT_ASSERT_EQUAL(vlan_validate_name(NULL), -1);
+
+  /* Rejected before any work, whatever the registry holds */
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brlan@10", "3900"), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brval0", "04"), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_addInterface("brval0", "wl0 2", "3900"), RETURN_ERR);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton input validation tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_validate_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_validate]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_validate_vlan_id", test_vlan_hal_validate_vlan_id, "validate");
+  vlan_hal_test_add(pSuite, "vlan_hal_validate_name", test_vlan_hal_validate_name, "validate");
+
+  return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_vlan_bitmap.c
+ * @page vlan_hal_vlan_bitmap Skeleton VLAN ID bitmap tests
+ *
+ * ## Module's Role
+ * Verifies the VLAN ID bitmap used by the skeleton to track which VLAN IDs
+ * are assigned to groups, and the dynamic VLAN allocation built on it.
+ *
+ * **Pre-Conditions:**  None@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "vlan_hal_vlan_bitmap.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 3;
+static int gTestID = 1;
+
+/**
+ * @brief Verify set, clear and test on valid and reserved VLAN IDs.
+ *
+ * **Test Group ID:** Skeleton: 03 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_vlan_bitmap_set_clear(void)
+{
+  vlan_bitmap_t bitmap;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  vlan_bitmap_reset(&bitmap);
+  UT_ASSERT_EQUAL(vlan_bitmap_set(&bitmap, 0), -1);
+  UT_ASSERT_EQUAL(vlan_bitmap_set(&bitmap, 4095), -1);
+  UT_ASSERT_EQUAL(vlan_bitmap_set(&bitmap, 1), 0);
+  UT_ASSERT_EQUAL(vlan_bitmap_set(&bitmap, 1), -1);
+  UT_ASSERT_EQUAL(vlan_bitmap_set(&bitmap, 4094), 0);
+  UT_ASSERT_TRUE(vlan_bitmap_test(&bitmap, 1));
+  UT_ASSERT_TRUE(vlan_bitmap_test(&bitmap, 4094));
+  UT_ASSERT_FALSE(vlan_bitmap_test(&bitmap, 2));
+  UT_ASSERT_FALSE(vlan_bitmap_test(&bitmap, 4095));
+  UT_ASSERT_EQUAL(vlan_bitmap_count(&bitmap), 2);
+  UT_ASSERT_EQUAL(vlan_bitmap_clear(&bitmap, 1), 0);
+  UT_ASSERT_EQUAL(vlan_bitmap_clear(&bitmap, 1), -1);
+  UT_ASSERT_EQUAL(vlan_bitmap_count(&bitmap), 1);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify the allocator returns the lowest free ID within range, across word boundaries, until exhausted.
+ *
+ * **Test Group ID:** Skeleton: 03 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_vlan_bitmap_alloc(void)
+{
+  vlan_bitmap_t bitmap;
+  unsigned int vlanID;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  vlan_bitmap_reset(&bitmap);
+  UT_ASSERT_EQUAL(vlan_bitmap_alloc(&bitmap, 0, 4095), 1);
+  UT_ASSERT_EQUAL(vlan_bitmap_alloc(&bitmap, 0, 4095), 2);
+
+  for (vlanID = 60; vlanID <= 130; vlanID++)
+  {
+    vlan_bitmap_set(&bitmap, vlanID);
+  }
+  UT_ASSERT_EQUAL(vlan_bitmap_alloc(&bitmap, 60, 200), 131);
+  UT_ASSERT_EQUAL(vlan_bitmap_find_free(&bitmap, 60, 130), -1);
+  UT_ASSERT_EQUAL(vlan_bitmap_alloc(&bitmap, 4094, 4094), 4094);
+  UT_ASSERT_EQUAL(vlan_bitmap_alloc(&bitmap, 4094, 4094), -1);
+  UT_ASSERT_EQUAL(vlan_bitmap_alloc(&bitmap, 200, 100), -1);
+
+  while (vlan_bitmap_alloc(&bitmap, 1, 4094) > 0)
+  {
+  }
+  UT_ASSERT_EQUAL(vlan_bitmap_count(&bitmap), 4094);
+  UT_ASSERT_FALSE(vlan_bitmap_test(&bitmap, 0));
+  UT_ASSERT_FALSE(vlan_bitmap_test(&bitmap, 4095));
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify dynamic groups get an unused VLAN ID and a shared VLAN ID counts once.
+ *
+ * **Test Group ID:** Skeleton: 03 @n
+ * **Test Case ID:** 003 @n
+ */
+void test_vlan_hal_vlan_bitmap_dynamic_group(void)
+{
+  char vlanID[5] = {"\0"};
+  char lookup[5] = {"\0"};
+  unsigned int inUse = 0;
+  unsigned int available = 0;
+  unsigned int before = 0;
+
+  gTestID = 3;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  UT_ASSERT_EQUAL(vlan_hal_getVlanUsage(&before, NULL), RETURN_OK);
+
+  UT_ASSERT_EQUAL(vlan_hal_addDynamicGroup("brdyn0", vlanID), RETURN_OK);
+  UT_ASSERT_EQUAL(get_vlanId_for_GroupName("brdyn0", lookup), RETURN_OK);
+  UT_ASSERT_STRING_EQUAL(vlanID, lookup);
+  UT_ASSERT_EQUAL(vlan_hal_addDynamicGroup("brdyn0", vlanID), RETURN_ERR);
+
+  /* Groups may share a VLAN, a dynamic group never does */
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brdyn1", lookup), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addGroup("brdyn0", lookup), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_addDynamicGroup("brdyn2", vlanID), RETURN_OK);
+  UT_ASSERT_TRUE(strcmp(vlanID, lookup) != 0);
+
+  UT_ASSERT_EQUAL(vlan_hal_getVlanUsage(&inUse, &available), RETURN_OK);
+  UT_ASSERT_EQUAL(inUse, before + 2);
+  UT_ASSERT_EQUAL(inUse + available, 4094);
+
+  /* The VLAN stays in use until its last group goes */
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brdyn0"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brdyn2"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_getVlanUsage(&inUse, NULL), RETURN_OK);
+  UT_ASSERT_EQUAL(inUse, before + 1);
+  UT_ASSERT_EQUAL(vlan_hal_delGroup("brdyn1"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_getVlanUsage(&inUse, NULL), RETURN_OK);
+  UT_ASSERT_EQUAL(inUse, before);
+  UT_ASSERT_EQUAL(vlan_hal_getVlanUsage(NULL, NULL), RETURN_ERR);
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton VLAN ID bitmap tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_vlan_bitmap_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_vlan_bitmap]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_vlan_bitmap_set_clear", test_vlan_hal_vlan_bitmap_set_clear, "vlan_bitmap");
+  vlan_hal_test_add(pSuite, "vlan_hal_vlan_bitmap_alloc", test_vlan_hal_vlan_bitmap_alloc, "vlan_bitmap");
+  vlan_hal_test_add(pSuite, "vlan_hal_vlan_bitmap_dynamic_group", test_vlan_hal_vlan_bitmap_dynamic_group, "vlan_bitmap");
+
+  return 0;
+}
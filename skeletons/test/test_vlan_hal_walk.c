@@ -0,0 +1,283 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_vlan_hal_walk.c
+ * @page vlan_hal_walk Skeleton record stream tests
+ *
+ * ## Module's Role
+ * Verifies vlan_hal_walkGroups() and vlan_hal_readGroups(): complete and
+ * chunked walks, pausing from the callback, change detection across
+ * resumed calls and callbacks that change the registry.
+ *
+ * **Pre-Conditions:**  None@n
+ * **Dependencies:** None@n
+ */
+#include <ut.h>
+#include <ut_log.h>
+#include <stdio.h>
+#include <string.h>
+#include "vlan_hal.h"
+#include "vlan_hal_ext.h"
+#include "test_parallel.h"
+
+static int gTestGroup = 9;
+static int gTestID = 1;
+
+#define WALK_GROUPS 3
+#define WALK_MEMBERS 2
+
+typedef struct
+{
+  int groups;
+  int members;
+  int foreign;                  /* Records for groups this test did not create */
+  int stopAfter;                /* Pause the walk after this many records, 0 never */
+  int seen;
+} walk_count_t;
+
+static int is_walk_group(const char *name)
+{
+  return strncmp(name, "brwalk", 6) == 0;
+}
+
+static int walk_count(void *ctx, const vlan_hal_record_t *record)
+{
+  walk_count_t *count = ctx;
+
+  if (!is_walk_group(record->groupName))
+  {
+    count->foreign++;
+  }
+  else if (record->type == VLAN_HAL_RECORD_GROUP)
+  {
+    count->groups++;
+  }
+  else
+  {
+    count->members++;
+  }
+  count->seen++;
+  return (count->stopAfter != 0) && (count->seen == count->stopAfter);
+}
+
+static void walk_setup(void)
+{
+  char groupName[IFNAMSIZ];
+  char ifName[IFNAMSIZ];
+  char vlanID[5];
+  int i;
+  int j;
+
+  for (i = 0; i < WALK_GROUPS; i++)
+  {
+    snprintf(groupName, sizeof(groupName), "brwalk%d", i);
+    snprintf(vlanID, sizeof(vlanID), "%d", 3500 + i);
+    UT_ASSERT_EQUAL(vlan_hal_addGroup(groupName, vlanID), RETURN_OK);
+    for (j = 0; j < WALK_MEMBERS; j++)
+    {
+      snprintf(ifName, sizeof(ifName), "wk%d", j);
+      UT_ASSERT_EQUAL(vlan_hal_addInterface(groupName, ifName, vlanID), RETURN_OK);
+    }
+  }
+}
+
+static void walk_teardown(void)
+{
+  char groupName[IFNAMSIZ];
+  int i;
+
+  for (i = 0; i < WALK_GROUPS; i++)
+  {
+    snprintf(groupName, sizeof(groupName), "brwalk%d", i);
+    UT_ASSERT_EQUAL(vlan_hal_delGroup(groupName), RETURN_OK);
+  }
+}
+
+/**
+ * @brief Verify a walk reports every group before any member, in one call or in chunks.
+ *
+ * **Test Group ID:** Skeleton: 09 @n
+ * **Test Case ID:** 001 @n
+ */
+void test_vlan_hal_walk_chunks(void)
+{
+  vlan_hal_cursor_t cursor = VLAN_HAL_CURSOR_INIT;
+  vlan_hal_record_t records[2];
+  walk_count_t count;
+  unsigned int got;
+  int calls = 0;
+  int sawMember = 0;
+  int ordered = 1;
+  int ret;
+  unsigned int i;
+
+  gTestID = 1;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  walk_setup();
+
+  memset(&count, 0, sizeof(count));
+  UT_ASSERT_EQUAL(vlan_hal_walkGroups(&cursor, 0, walk_count, &count), RETURN_OK);
+  UT_ASSERT_EQUAL(count.groups, WALK_GROUPS);
+  UT_ASSERT_EQUAL(count.members, WALK_GROUPS * WALK_MEMBERS);
+  UT_ASSERT_EQUAL(cursor.changed, 0);
+  /* A finished cursor stays finished */
+  UT_ASSERT_EQUAL(vlan_hal_walkGroups(&cursor, 0, walk_count, &count), RETURN_OK);
+  UT_ASSERT_EQUAL(count.groups, WALK_GROUPS);
+
+  memset(&count, 0, sizeof(count));
+  memset(&cursor, 0, sizeof(cursor));
+  do
+  {
+    ret = vlan_hal_readGroups(&cursor, records, 2, &got);
+    UT_ASSERT_TRUE(got <= 2);
+    for (i = 0; i < got; i++)
+    {
+      if (records[i].type == VLAN_HAL_RECORD_MEMBER)
+      {
+        sawMember = 1;
+        if (is_walk_group(records[i].groupName))
+        {
+          UT_ASSERT_EQUAL(records[i].vlanID, 3500 + (unsigned int)(records[i].groupName[6] - '0'));
+          UT_ASSERT_EQUAL(strncmp(records[i].portName, records[i].ifName, strlen(records[i].ifName)), 0);
+        }
+      }
+      else if (sawMember)
+      {
+        ordered = 0;
+      }
+      walk_count(&count, &records[i]);
+    }
+    calls++;
+  } while ((ret == VLAN_HAL_WALK_MORE) && (calls < 1000));
+  UT_ASSERT_EQUAL(ret, RETURN_OK);
+  UT_ASSERT_TRUE(ordered);
+  UT_ASSERT_EQUAL(count.groups, WALK_GROUPS);
+  UT_ASSERT_EQUAL(count.members, WALK_GROUPS * WALK_MEMBERS);
+  UT_ASSERT_TRUE(calls >= (count.groups + count.members + count.foreign) / 2);
+
+  UT_ASSERT_EQUAL(vlan_hal_readGroups(&cursor, NULL, 2, &got), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_walkGroups(NULL, 0, walk_count, &count), RETURN_ERR);
+  UT_ASSERT_EQUAL(vlan_hal_walkGroups(&cursor, 0, NULL, NULL), RETURN_ERR);
+
+  walk_teardown();
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+/**
+ * @brief Verify the callback can pause a walk and a resumed walk flags registry changes.
+ *
+ * **Test Group ID:** Skeleton: 09 @n
+ * **Test Case ID:** 002 @n
+ */
+void test_vlan_hal_walk_resume(void)
+{
+  vlan_hal_cursor_t cursor = VLAN_HAL_CURSOR_INIT;
+  walk_count_t count;
+
+  gTestID = 2;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  walk_setup();
+
+  memset(&count, 0, sizeof(count));
+  count.stopAfter = 1;
+  UT_ASSERT_EQUAL(vlan_hal_walkGroups(&cursor, 0, walk_count, &count), VLAN_HAL_WALK_MORE);
+  UT_ASSERT_EQUAL(count.seen, 1);
+  UT_ASSERT_EQUAL(cursor.changed, 0);
+
+  /* Unchanged registry: resuming is seamless */
+  count.stopAfter = 0;
+  UT_ASSERT_EQUAL(vlan_hal_walkGroups(&cursor, 1, walk_count, &count), VLAN_HAL_WALK_MORE);
+  UT_ASSERT_EQUAL(count.seen, 2);
+  UT_ASSERT_EQUAL(cursor.changed, 0);
+
+  UT_ASSERT_EQUAL(vlan_hal_delInterface("brwalk0", "wk0", "3500"), RETURN_OK);
+  UT_ASSERT_EQUAL(vlan_hal_walkGroups(&cursor, 0, walk_count, &count), RETURN_OK);
+  UT_ASSERT_EQUAL(cursor.changed, 1);
+
+  walk_teardown();
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static int walk_delete(void *ctx, const vlan_hal_record_t *record)
+{
+  int *deleted = ctx;
+
+  if ((record->type == VLAN_HAL_RECORD_GROUP) && is_walk_group(record->groupName) &&
+      (vlan_hal_delGroup(record->groupName) == RETURN_OK))
+  {
+    (*deleted)++;
+  }
+  return 0;
+}
+
+/**
+ * @brief Verify the callback may change the registry it is walking.
+ *
+ * **Test Group ID:** Skeleton: 09 @n
+ * **Test Case ID:** 003 @n
+ */
+void test_vlan_hal_walk_mutate(void)
+{
+  vlan_hal_cursor_t cursor = VLAN_HAL_CURSOR_INIT;
+  char groupName[IFNAMSIZ];
+  int deleted = 0;
+  int i;
+
+  gTestID = 3;
+  UT_LOG_INFO("In %s [%02d%03d]\n", __FUNCTION__, gTestGroup, gTestID);
+
+  walk_setup();
+
+  /* Deleting waits for readers to leave, the walk must not be one of them */
+  UT_ASSERT_EQUAL(vlan_hal_walkGroups(&cursor, 0, walk_delete, &deleted), RETURN_OK);
+  UT_ASSERT_EQUAL(deleted, WALK_GROUPS);
+  for (i = 0; i < WALK_GROUPS; i++)
+  {
+    snprintf(groupName, sizeof(groupName), "brwalk%d", i);
+    UT_ASSERT_EQUAL(_is_this_group_available_in_linux_bridge(groupName), RETURN_ERR);
+  }
+
+  UT_LOG_INFO("Out %s\n", __FUNCTION__);
+}
+
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/**
+ * @brief Register the skeleton record stream tests
+ *
+ * @return int - 0 on success, otherwise failure
+ */
+int test_vlan_hal_walk_register(void)
+{
+  pSuite = vlan_hal_test_add_suite("[skeleton vlan_hal_walk]", NULL, NULL);
+  if (pSuite == NULL)
+  {
+    return -1;
+  }
+
+  vlan_hal_test_add(pSuite, "vlan_hal_walk_chunks", test_vlan_hal_walk_chunks, "walk");
+  vlan_hal_test_add(pSuite, "vlan_hal_walk_resume", test_vlan_hal_walk_resume, "walk");
+  vlan_hal_test_add(pSuite, "vlan_hal_walk_mutate", test_vlan_hal_walk_mutate, "walk");
+
+  return 0;
+}
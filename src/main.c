@@ -20,12 +20,22 @@
 #include <ut_log.h>
 #include <stdlib.h>
 #include "cJSON.h"
+#include "test_parallel.h"
+#include "test_resources.h"
 
 extern int register_hal_l1_tests(void);
 
 int main(int argc, char **argv)
 {
     int registerReturn = 0;
+    int jobs = vlan_hal_test_jobs();
+
+    if (jobs > 1)
+    {
+        /* Each worker calls UT_init() and registers its share of the tests */
+        return vlan_hal_test_run_parallel(jobs, argc, argv, register_hal_l1_tests);
+    }
+    vlan_hal_test_resources_record(vlan_hal_test_resources_open());
     /* Register tests as required, then call the UT-main to support switches and triggering */
     UT_init(argc, argv);
     /* Check if tests are registered successfully */
@@ -0,0 +1,146 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "vlan_profile_snapshot.h"
+
+/* Checks the header, the list table and every offset once, so lookups need no bounds checks */
+static int vlan_profile_snapshot_validate(const uint8_t *base, size_t size)
+{
+    const vlan_profile_snapshot_header_t *header = (const vlan_profile_snapshot_header_t *)base;
+    const vlan_profile_snapshot_list_t *lists;
+    const uint32_t *entries;
+    size_t table;
+    uint32_t l;
+    uint32_t i;
+
+    if ((size < sizeof(*header)) || (memcmp(header->magic, VLAN_PROFILE_SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) ||
+        (header->version != VLAN_PROFILE_SNAPSHOT_VERSION) || (header->size != size) || (base[size - 1] != '\0'))
+    {
+        return -1;
+    }
+    table = sizeof(*header) + ((size_t)header->listCount * sizeof(*lists));
+    if (table > size)
+    {
+        return -1;
+    }
+    lists = (const vlan_profile_snapshot_list_t *)(base + sizeof(*header));
+    for (l = 0; l < header->listCount; l++)
+    {
+        if ((lists[l].key >= size) || ((lists[l].entries % sizeof(uint32_t)) != 0) || (lists[l].entries < table) ||
+            (((size - lists[l].entries) / sizeof(uint32_t)) < lists[l].count))
+        {
+            return -1;
+        }
+        entries = (const uint32_t *)(base + lists[l].entries);
+        for (i = 0; i < lists[l].count; i++)
+        {
+            if (entries[i] >= size)
+            {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+int vlan_profile_snapshot_open(vlan_profile_snapshot_t *snapshot, const char *path)
+{
+    struct stat st;
+    void *base;
+    int fd;
+
+    if ((snapshot == NULL) || (path == NULL))
+    {
+        return -EINVAL;
+    }
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return -errno;
+    }
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return -errno;
+    }
+    if ((st.st_size < (off_t)sizeof(vlan_profile_snapshot_header_t)) || (st.st_size > (off_t)UINT32_MAX))
+    {
+        close(fd);
+        return -EINVAL;
+    }
+    base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        return -errno;
+    }
+    if (vlan_profile_snapshot_validate(base, (size_t)st.st_size) != 0)
+    {
+        munmap(base, (size_t)st.st_size);
+        return -EINVAL;
+    }
+    snapshot->base = base;
+    snapshot->size = (size_t)st.st_size;
+    return 0;
+}
+
+void vlan_profile_snapshot_close(vlan_profile_snapshot_t *snapshot)
+{
+    if ((snapshot == NULL) || (snapshot->base == NULL))
+    {
+        return;
+    }
+    munmap((void *)snapshot->base, snapshot->size);
+    snapshot->base = NULL;
+    snapshot->size = 0;
+}
+
+int vlan_profile_snapshot_list(const vlan_profile_snapshot_t *snapshot, const char *key, const char **values, int max)
+{
+    const vlan_profile_snapshot_header_t *header;
+    const vlan_profile_snapshot_list_t *lists;
+    const uint32_t *entries;
+    uint32_t l;
+    int i;
+
+    if ((snapshot == NULL) || (snapshot->base == NULL) || (key == NULL))
+    {
+        return -1;
+    }
+    header = (const vlan_profile_snapshot_header_t *)snapshot->base;
+    lists = (const vlan_profile_snapshot_list_t *)(snapshot->base + sizeof(*header));
+    for (l = 0; l < header->listCount; l++)
+    {
+        if (strcmp((const char *)snapshot->base + lists[l].key, key) != 0)
+        {
+            continue;
+        }
+        entries = (const uint32_t *)(snapshot->base + lists[l].entries);
+        for (i = 0; (values != NULL) && (i < max) && ((uint32_t)i < lists[l].count); i++)
+        {
+            values[i] = (const char *)snapshot->base + entries[i];
+        }
+        return (int)lists[l].count;
+    }
+    return -1;
+}
@@ -0,0 +1,92 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_profile_snapshot.h
+ *
+ * Binary snapshot of a test profile. tools/vlan_profile_compile turns the
+ * string lists of a profile YAML into one file that the suite maps read-only
+ * and indexes in place, so startup does no YAML parsing and no per-key
+ * lookups, however many entries the profile has.
+ *
+ * Layout, in host byte order (a foreign or corrupt file fails the checks in
+ * vlan_profile_snapshot_open()):
+ *  - vlan_profile_snapshot_header_t
+ *  - listCount vlan_profile_snapshot_list_t, one per list in the YAML
+ *  - for each list, count uint32_t offsets of its strings
+ *  - the keys and strings, NUL-terminated and packed end to end
+ *
+ * All offsets are from the start of the file and the file ends in a NUL.
+ */
+#ifndef __VLAN_PROFILE_SNAPSHOT_H__
+#define __VLAN_PROFILE_SNAPSHOT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define VLAN_PROFILE_SNAPSHOT_MAGIC "VLANPRF1"
+#define VLAN_PROFILE_SNAPSHOT_VERSION 1
+
+/** Environment variable naming the snapshot fetch_vlan_data() should load */
+#define VLAN_PROFILE_SNAPSHOT_ENV "VLAN_PROFILE_SNAPSHOT"
+
+typedef struct
+{
+    char magic[8];              /*!< VLAN_PROFILE_SNAPSHOT_MAGIC, not NUL-terminated */
+    uint32_t version;           /*!< VLAN_PROFILE_SNAPSHOT_VERSION */
+    uint32_t size;              /*!< Size of the whole file */
+    uint32_t listCount;
+    uint32_t reserved;
+} vlan_profile_snapshot_header_t;
+
+typedef struct
+{
+    uint32_t key;               /*!< Offset of the list's path, e.g. "vlan/config/br_Name" */
+    uint32_t count;             /*!< Number of strings in the list */
+    uint32_t entries;           /*!< Offset of count uint32_t string offsets */
+} vlan_profile_snapshot_list_t;
+
+typedef struct
+{
+    const uint8_t *base;
+    size_t size;
+} vlan_profile_snapshot_t;
+
+/**
+ * @brief Map and validate the snapshot at @p path.
+ *
+ * @return 0 on success, -EINVAL if the file is not a valid snapshot, otherwise a negative errno.
+ */
+int vlan_profile_snapshot_open(vlan_profile_snapshot_t *snapshot, const char *path);
+
+/**
+ * @brief Unmap a snapshot. Strings returned from it are invalid afterwards.
+ */
+void vlan_profile_snapshot_close(vlan_profile_snapshot_t *snapshot);
+
+/**
+ * @brief Look up the list at @p key.
+ *
+ * Stores up to @p max string pointers into @p values, which may be NULL to
+ * only count. The strings point into the mapping.
+ *
+ * @return Number of strings in the list, or -1 if there is no such list.
+ */
+int vlan_profile_snapshot_list(const vlan_profile_snapshot_t *snapshot, const char *key, const char **values, int max);
+
+#endif /* __VLAN_PROFILE_SNAPSHOT_H__ */
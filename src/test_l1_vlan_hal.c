@@ -33,9 +33,12 @@
 #include <ut_log.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <ctype.h>
 #include "cJSON.h"
 #include "vlan_hal.h"
+#include "vlan_profile_snapshot.h"
+#include "test_parallel.h"
 #include <ut_kvp_profile.h>
 #include <time.h>
 
@@ -59,88 +62,185 @@ char **invalid_brName;
 int num_vlanid;
 char **valid_vlanid;
 
-int fetch_vlan_data()
+/* The profile lists above all live in this one block, see fetch_vlan_data() */
+static char *gVlanData;
+
+/* When loaded from a snapshot the block only holds pointers into this mapping */
+static vlan_profile_snapshot_t gVlanSnapshot;
+
+typedef struct
 {
-    char br_Namex[MAX_SIZE];
-    char if_Namex[MAX_SIZE];
-    char vlanid[MAX_SIZE];
-    char invalid_brNamex[MAX_SIZE];
-    int i;
+    const char *key;
+    int *count;
+    char ***list;
+} vlan_data_list_t;
 
-    // Fetch bridge names
-    num_brName = UT_KVP_PROFILE_GET_LIST_COUNT("vlan/config/br_Name");
-    br_Name = (char **)malloc(num_brName * sizeof(char *));
-    for (i = 0; i < num_brName; i++)
+static vlan_data_list_t gVlanDataLists[] =
+{
+    { "vlan/config/br_Name", &num_brName, &br_Name },
+    { "vlan/config/if_Name", &num_ifName, &if_Name },
+    { "vlan/config/vlanID", &num_vlanid, &valid_vlanid },
+    { "vlan/config/invalid_brName", &num_invalid_brName, &invalid_brName },
+};
+
+#define VLAN_DATA_LISTS (sizeof(gVlanDataLists) / sizeof(gVlanDataLists[0]))
+
+/* Reads entry @index of profile list @key into @value, returning its length */
+static size_t fetch_vlan_entry(const char *key, int index, char *value)
+{
+    char entryKey[MAX_SIZE];
+
+    snprintf(entryKey, sizeof(entryKey), "%s/%d", key, index);
+    value[0] = '\0';
+    UT_KVP_PROFILE_GET_STRING(entryKey, value);
+    value[MAX_SIZE - 1] = '\0';
+    return strlen(value);
+}
+
+/*
+ * Takes the profile lists from the snapshot at @path, see
+ * vlan_profile_snapshot.h. The strings stay in the read-only mapping, only
+ * the pointer arrays are allocated, in one block.
+ */
+static int fetch_vlan_snapshot(const char *path)
+{
+    size_t pointers = 0;
+    char **slot;
+    size_t l;
+    int ret;
+
+    ret = vlan_profile_snapshot_open(&gVlanSnapshot, path);
+    if (ret != 0)
     {
-        br_Name[i] = (char *)malloc(MAX_SIZE * sizeof(char));
-        sprintf(br_Namex, "vlan/config/br_Name/%d", i);
-        UT_KVP_PROFILE_GET_STRING(br_Namex, br_Name[i]);
+        UT_LOG_ERROR("Cannot load profile snapshot %s: %s\n", path, strerror(-ret));
+        return -1;
     }
-
-    // Fetch interface names
-    num_ifName = UT_KVP_PROFILE_GET_LIST_COUNT("vlan/config/if_Name");
-    if_Name = (char **)malloc(num_ifName * sizeof(char *));
-    for (i = 0; i < num_ifName; i++)
+    for (l = 0; l < VLAN_DATA_LISTS; l++)
     {
-        if_Name[i] = (char *)malloc(MAX_SIZE * sizeof(char));
-        sprintf(if_Namex, "vlan/config/if_Name/%d", i);
-        UT_KVP_PROFILE_GET_STRING(if_Namex, if_Name[i]);
+        *gVlanDataLists[l].count = vlan_profile_snapshot_list(&gVlanSnapshot, gVlanDataLists[l].key, NULL, 0);
+        if (*gVlanDataLists[l].count < 0)
+        {
+            *gVlanDataLists[l].count = 0;
+        }
+        pointers += *gVlanDataLists[l].count;
     }
-
-    // Fetch valid VLAN IDs
-    num_vlanid = UT_KVP_PROFILE_GET_LIST_COUNT("vlan/config/vlanID");
-    valid_vlanid = (char **)malloc(num_vlanid * sizeof(char *));
-    for (i = 0; i < num_vlanid; i++)
+    gVlanData = malloc(pointers * sizeof(char *));
+    if ((gVlanData == NULL) && (pointers != 0))
     {
-        valid_vlanid[i] = (char *)malloc(MAX_SIZE * sizeof(char));
-        sprintf(vlanid, "vlan/config/vlanID/%d", i);
-        UT_KVP_PROFILE_GET_STRING(vlanid, valid_vlanid[i]);
+        vlan_profile_snapshot_close(&gVlanSnapshot);
+        return -1;
     }
-
-    // Fetch invalid bridge names
-    num_invalid_brName = UT_KVP_PROFILE_GET_LIST_COUNT("vlan/config/invalid_brName");
-    invalid_brName = (char **)malloc(num_invalid_brName * sizeof(char *));
-    for (i = 0; i < num_invalid_brName; i++)
+    slot = (char **)gVlanData;
+    for (l = 0; l < VLAN_DATA_LISTS; l++)
     {
-        invalid_brName[i] = (char *)malloc(MAX_SIZE * sizeof(char));
-        sprintf(invalid_brNamex, "vlan/config/invalid_brName/%d", i);
-        UT_KVP_PROFILE_GET_STRING(invalid_brNamex, invalid_brName[i]);
+        /* The tests only read the lists, the mapping being read-only enforces it */
+        *gVlanDataLists[l].list = slot;
+        vlan_profile_snapshot_list(&gVlanSnapshot, gVlanDataLists[l].key, (const char **)slot, *gVlanDataLists[l].count);
+        slot += *gVlanDataLists[l].count;
     }
+    UT_LOG_INFO("Profile lists loaded from snapshot %s\n", path);
     return 0;
 }
 
-int cleanup_vlan_data()
+/*
+ * Loads the profile lists into a single allocation: every list's pointer
+ * array first, then the strings packed end to end. Each entry is fetched
+ * once, straight into the block, which grows when the strings outrun it,
+ * so setup and teardown usually cost one malloc() and one free() however
+ * many entries the profile has.
+ *
+ * When VLAN_PROFILE_SNAPSHOT names a snapshot compiled by
+ * tools/vlan_profile_compile the lists come from it instead, with no YAML
+ * lookups at all. An unusable snapshot falls back to the YAML profile.
+ */
+int fetch_vlan_data()
 {
+    const char *snapshot = getenv(VLAN_PROFILE_SNAPSHOT_ENV);
+    char value[MAX_SIZE];
+    size_t pointers = 0;
+    size_t total;
+    size_t used;
+    size_t length;
+    size_t p;
+    char **slot;
+    char *block;
+    size_t l;
     int i;
 
-    // Free bridge name memory
-    for (i = 0; i < num_brName; i++)
+    if ((snapshot != NULL) && (snapshot[0] != '\0') && (fetch_vlan_snapshot(snapshot) == 0))
     {
-        free(br_Name[i]);
+        return 0;
     }
-    free(br_Name);
-
-    // Free interface name memory
-    for (i = 0; i < num_ifName; i++)
+    for (l = 0; l < VLAN_DATA_LISTS; l++)
     {
-        free(if_Name[i]);
+        *gVlanDataLists[l].count = UT_KVP_PROFILE_GET_LIST_COUNT(gVlanDataLists[l].key);
+        if (*gVlanDataLists[l].count < 0)
+        {
+            *gVlanDataLists[l].count = 0;
+        }
+        pointers += *gVlanDataLists[l].count;
     }
-    free(if_Name);
 
-    // Free valid VLAN ID memory
-    for (i = 0; i < num_vlanid; i++)
+    /* Profile names are short, a guess of 32 bytes an entry rarely needs to grow */
+    used = pointers * sizeof(char *);
+    total = used + (pointers * 32);
+    gVlanData = malloc(total);
+    if ((gVlanData == NULL) && (total != 0))
     {
-        free(valid_vlanid[i]);
+        UT_LOG_ERROR("Failed to allocate %zu bytes for the profile lists\n", total);
+        return -1;
+    }
+    /* Until the block stops moving each pointer slot holds its string's offset */
+    p = 0;
+    for (l = 0; l < VLAN_DATA_LISTS; l++)
+    {
+        for (i = 0; i < *gVlanDataLists[l].count; i++, p++)
+        {
+            length = fetch_vlan_entry(gVlanDataLists[l].key, i, value);
+            if (length + 1 > total - used)
+            {
+                total = (total * 2 > used + length + 1) ? total * 2 : used + length + 1;
+                block = realloc(gVlanData, total);
+                if (block == NULL)
+                {
+                    UT_LOG_ERROR("Failed to grow the profile lists to %zu bytes\n", total);
+                    free(gVlanData);
+                    gVlanData = NULL;
+                    return -1;
+                }
+                gVlanData = block;
+            }
+            memcpy(gVlanData + used, value, length + 1);
+            ((char **)gVlanData)[p] = (char *)(uintptr_t)used;
+            used += length + 1;
+        }
     }
-    free(valid_vlanid);
 
-    // Free invalid bridge name memory
-    for (i = 0; i < num_invalid_brName; i++)
+    slot = (char **)gVlanData;
+    for (p = 0; p < pointers; p++)
     {
-        free(invalid_brName[i]);
+        slot[p] = gVlanData + (uintptr_t)slot[p];
     }
-    free(invalid_brName);
+    for (l = 0; l < VLAN_DATA_LISTS; l++)
+    {
+        *gVlanDataLists[l].list = slot;
+        slot += *gVlanDataLists[l].count;
+    }
+    return 0;
+}
+
+int cleanup_vlan_data()
+{
+    size_t l;
 
+    free(gVlanData);
+    gVlanData = NULL;
+    vlan_profile_snapshot_close(&gVlanSnapshot);
+    for (l = 0; l < VLAN_DATA_LISTS; l++)
+    {
+        *gVlanDataLists[l].list = NULL;
+        *gVlanDataLists[l].count = 0;
+    }
     return 0;
 }
 
@@ -3141,97 +3241,107 @@ void test_l1_vlan_hal_negative2_get_shell_outputbuffer_res(void)
     UT_LOG_INFO("Out %s\n", __FUNCTION__);
 }
 
-static UT_test_suite_t *pSuite = NULL;
+static vlan_hal_test_suite_t *pSuite = NULL;
+
+/*
+ * Tests that use the profile's bridge or interface names see the groups,
+ * interfaces and VLAN IDs earlier tests left behind, including groups made
+ * under names the profile lists as invalid. These run in order in one worker.
+ */
+#define VLAN_HAL_L1_STATE "L1 HAL state"
 
 /**
  * @brief Register the main tests for this module
  *
+ * Tests passed a NULL chain use only NULL or empty arguments, or no HAL
+ * state, and may run in any worker of a parallel run, see test_parallel.h.
+ *
  * @return int - 0 on success, otherwise failure
  */
 int test_vlan_hal_l1_register(void)
 {
     // Create the test suite
-    pSuite = UT_add_suite("[L1 vlan_hal]", fetch_vlan_data, cleanup_vlan_data);
+    pSuite = vlan_hal_test_add_suite("[L1 vlan_hal]", fetch_vlan_data, cleanup_vlan_data);
     if (pSuite == NULL)
     {
         return -1;
     }
 
     // Add tests to the suite
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_addGroup", test_l1_vlan_hal_positive1_addGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_addGroup", test_l1_vlan_hal_negative1_addGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_addGroup", test_l1_vlan_hal_negative2_addGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative3_addGroup", test_l1_vlan_hal_negative3_addGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative4_addGroup", test_l1_vlan_hal_negative4_addGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative5_addGroup", test_l1_vlan_hal_negative5_addGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative6_addGroup", test_l1_vlan_hal_negative6_addGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_delGroup", test_l1_vlan_hal_negative1_delGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_delGroup", test_l1_vlan_hal_negative2_delGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_addInterface", test_l1_vlan_hal_positive1_addInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_addInterface", test_l1_vlan_hal_negative1_addInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_addInterface", test_l1_vlan_hal_negative2_addInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative3_addInterface", test_l1_vlan_hal_negative3_addInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative4_addInterface", test_l1_vlan_hal_negative4_addInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative5_addInterface", test_l1_vlan_hal_negative5_addInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative6_addInterface", test_l1_vlan_hal_negative6_addInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative7_addInterface", test_l1_vlan_hal_negative7_addInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative8_addInterface", test_l1_vlan_hal_negative8_addInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_delInterface", test_l1_vlan_hal_negative1_delInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_delInterface", test_l1_vlan_hal_negative2_delInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative3_delInterface", test_l1_vlan_hal_negative3_delInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative4_delInterface", test_l1_vlan_hal_negative4_delInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative5_delInterface", test_l1_vlan_hal_negative5_delInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative6_delInterface", test_l1_vlan_hal_negative6_delInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_negative7_delInterface", test_l1_vlan_hal_negative7_delInterface);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_printGroup", test_l1_vlan_hal_positive1_printGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_printGroup", test_l1_vlan_hal_negative1_printGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_printGroup", test_l1_vlan_hal_negative2_printGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative3_printGroup", test_l1_vlan_hal_negative3_printGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_printAllGroup", test_l1_vlan_hal_positive1_printAllGroup);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_delete_all_Interfaces", test_l1_vlan_hal_negative1_delete_all_Interfaces);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_delete_all_Interfaces", test_l1_vlan_hal_negative2_delete_all_Interfaces);
-    UT_add_test(pSuite, "l1_vlan_hal_negative3_delete_all_Interfaces", test_l1_vlan_hal_negative3_delete_all_Interfaces);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_is_this_group_available_in_linux_bridge", test_l1_vlan_hal_positive1_is_this_group_available_in_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_is_this_group_available_in_linux_bridge", test_l1_vlan_hal_negative1_is_this_group_available_in_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_is_this_group_available_in_linux_bridge", test_l1_vlan_hal_negative2_is_this_group_available_in_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative3_is_this_group_available_in_linux_bridge", test_l1_vlan_hal_negative3_is_this_group_available_in_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_is_this_interface_available_in_linux_bridge", test_l1_vlan_hal_positive1_is_this_interface_available_in_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_is_this_interface_available_in_linux_bridge", test_l1_vlan_hal_negative1_is_this_interface_available_in_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_is_this_interface_available_in_linux_bridge", test_l1_vlan_hal_negative2_is_this_interface_available_in_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative3_is_this_interface_available_in_linux_bridge", test_l1_vlan_hal_negative3_is_this_interface_available_in_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative4_is_this_interface_available_in_linux_bridge", test_l1_vlan_hal_negative4_is_this_interface_available_in_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_positive1_is_this_interface_available_in_given_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative1_is_this_interface_available_in_given_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative2_is_this_interface_available_in_given_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative3_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative3_is_this_interface_available_in_given_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative4_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative4_is_this_interface_available_in_given_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative5_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative5_is_this_interface_available_in_given_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative6_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative6_is_this_interface_available_in_given_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative7_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative7_is_this_interface_available_in_given_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_negative8_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative8_is_this_interface_available_in_given_linux_bridge);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_insert_VLAN_ConfigEntry", test_l1_vlan_hal_positive1_insert_VLAN_ConfigEntry);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative1_insert_VLAN_ConfigEntry);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative2_insert_VLAN_ConfigEntry);
-    UT_add_test(pSuite, "l1_vlan_hal_negative3_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative3_insert_VLAN_ConfigEntry);
-    UT_add_test(pSuite, "l1_vlan_hal_negative4_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative4_insert_VLAN_ConfigEntry);
-    UT_add_test(pSuite, "l1_vlan_hal_negative5_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative5_insert_VLAN_ConfigEntry);
-    UT_add_test(pSuite, "l1_vlan_hal_negative6_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative6_insert_VLAN_ConfigEntry);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_delete_VLAN_ConfigEntry", test_l1_vlan_hal_positive1_delete_VLAN_ConfigEntry);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_delete_VLAN_ConfigEntry", test_l1_vlan_hal_negative1_delete_VLAN_ConfigEntry);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_delete_VLAN_ConfigEntry", test_l1_vlan_hal_negative2_delete_VLAN_ConfigEntry);
-    UT_add_test(pSuite, "l1_vlan_hal_negative3_delete_VLAN_ConfigEntry", test_l1_vlan_hal_negative3_delete_VLAN_ConfigEntry);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_get_vlanId_for_GroupName", test_l1_vlan_hal_positive1_get_vlanId_for_GroupName);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_get_vlanId_for_GroupName", test_l1_vlan_hal_negative1_get_vlanId_for_GroupName);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_get_vlanId_for_GroupName", test_l1_vlan_hal_negative2_get_vlanId_for_GroupName);
-    UT_add_test(pSuite, "l1_vlan_hal_negative3_get_vlanId_for_GroupName", test_l1_vlan_hal_negative3_get_vlanId_for_GroupName);
-    UT_add_test(pSuite, "l1_vlan_hal_negative4_get_vlanId_for_GroupName", test_l1_vlan_hal_negative4_get_vlanId_for_GroupName);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_print_all_vlanId_Configuration", test_l1_vlan_hal_positive1_print_all_vlanId_Configuration);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_get_shell_outputbuffer", test_l1_vlan_hal_positive1_get_shell_outputbuffer);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_get_shell_outputbuffer", test_l1_vlan_hal_negative1_get_shell_outputbuffer);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_get_shell_outputbuffer", test_l1_vlan_hal_negative2_get_shell_outputbuffer);
-    UT_add_test(pSuite, "l1_vlan_hal_positive1_get_shell_outputbuffer_res", test_l1_vlan_hal_positive1_get_shell_outputbuffer_res);
-    UT_add_test(pSuite, "l1_vlan_hal_negative1_get_shell_outputbuffer_res", test_l1_vlan_hal_negative1_get_shell_outputbuffer_res);
-    UT_add_test(pSuite, "l1_vlan_hal_negative2_get_shell_outputbuffer_res", test_l1_vlan_hal_negative2_get_shell_outputbuffer_res);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_addGroup", test_l1_vlan_hal_positive1_addGroup, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_addGroup", test_l1_vlan_hal_negative1_addGroup, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_addGroup", test_l1_vlan_hal_negative2_addGroup, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative3_addGroup", test_l1_vlan_hal_negative3_addGroup, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative4_addGroup", test_l1_vlan_hal_negative4_addGroup, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative5_addGroup", test_l1_vlan_hal_negative5_addGroup, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative6_addGroup", test_l1_vlan_hal_negative6_addGroup, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_delGroup", test_l1_vlan_hal_negative1_delGroup, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_delGroup", test_l1_vlan_hal_negative2_delGroup, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_addInterface", test_l1_vlan_hal_positive1_addInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_addInterface", test_l1_vlan_hal_negative1_addInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_addInterface", test_l1_vlan_hal_negative2_addInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative3_addInterface", test_l1_vlan_hal_negative3_addInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative4_addInterface", test_l1_vlan_hal_negative4_addInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative5_addInterface", test_l1_vlan_hal_negative5_addInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative6_addInterface", test_l1_vlan_hal_negative6_addInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative7_addInterface", test_l1_vlan_hal_negative7_addInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative8_addInterface", test_l1_vlan_hal_negative8_addInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_delInterface", test_l1_vlan_hal_negative1_delInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_delInterface", test_l1_vlan_hal_negative2_delInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative3_delInterface", test_l1_vlan_hal_negative3_delInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative4_delInterface", test_l1_vlan_hal_negative4_delInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative5_delInterface", test_l1_vlan_hal_negative5_delInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative6_delInterface", test_l1_vlan_hal_negative6_delInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative7_delInterface", test_l1_vlan_hal_negative7_delInterface, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_printGroup", test_l1_vlan_hal_positive1_printGroup, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_printGroup", test_l1_vlan_hal_negative1_printGroup, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_printGroup", test_l1_vlan_hal_negative2_printGroup, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative3_printGroup", test_l1_vlan_hal_negative3_printGroup, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_printAllGroup", test_l1_vlan_hal_positive1_printAllGroup, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_delete_all_Interfaces", test_l1_vlan_hal_negative1_delete_all_Interfaces, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_delete_all_Interfaces", test_l1_vlan_hal_negative2_delete_all_Interfaces, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative3_delete_all_Interfaces", test_l1_vlan_hal_negative3_delete_all_Interfaces, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_is_this_group_available_in_linux_bridge", test_l1_vlan_hal_positive1_is_this_group_available_in_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_is_this_group_available_in_linux_bridge", test_l1_vlan_hal_negative1_is_this_group_available_in_linux_bridge, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_is_this_group_available_in_linux_bridge", test_l1_vlan_hal_negative2_is_this_group_available_in_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative3_is_this_group_available_in_linux_bridge", test_l1_vlan_hal_negative3_is_this_group_available_in_linux_bridge, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_is_this_interface_available_in_linux_bridge", test_l1_vlan_hal_positive1_is_this_interface_available_in_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_is_this_interface_available_in_linux_bridge", test_l1_vlan_hal_negative1_is_this_interface_available_in_linux_bridge, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_is_this_interface_available_in_linux_bridge", test_l1_vlan_hal_negative2_is_this_interface_available_in_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative3_is_this_interface_available_in_linux_bridge", test_l1_vlan_hal_negative3_is_this_interface_available_in_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative4_is_this_interface_available_in_linux_bridge", test_l1_vlan_hal_negative4_is_this_interface_available_in_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_positive1_is_this_interface_available_in_given_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative1_is_this_interface_available_in_given_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative2_is_this_interface_available_in_given_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative3_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative3_is_this_interface_available_in_given_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative4_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative4_is_this_interface_available_in_given_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative5_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative5_is_this_interface_available_in_given_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative6_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative6_is_this_interface_available_in_given_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative7_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative7_is_this_interface_available_in_given_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative8_is_this_interface_available_in_given_linux_bridge", test_l1_vlan_hal_negative8_is_this_interface_available_in_given_linux_bridge, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_insert_VLAN_ConfigEntry", test_l1_vlan_hal_positive1_insert_VLAN_ConfigEntry, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative1_insert_VLAN_ConfigEntry, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative2_insert_VLAN_ConfigEntry, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative3_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative3_insert_VLAN_ConfigEntry, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative4_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative4_insert_VLAN_ConfigEntry, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative5_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative5_insert_VLAN_ConfigEntry, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative6_insert_VLAN_ConfigEntry", test_l1_vlan_hal_negative6_insert_VLAN_ConfigEntry, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_delete_VLAN_ConfigEntry", test_l1_vlan_hal_positive1_delete_VLAN_ConfigEntry, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_delete_VLAN_ConfigEntry", test_l1_vlan_hal_negative1_delete_VLAN_ConfigEntry, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_delete_VLAN_ConfigEntry", test_l1_vlan_hal_negative2_delete_VLAN_ConfigEntry, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative3_delete_VLAN_ConfigEntry", test_l1_vlan_hal_negative3_delete_VLAN_ConfigEntry, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_get_vlanId_for_GroupName", test_l1_vlan_hal_positive1_get_vlanId_for_GroupName, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_get_vlanId_for_GroupName", test_l1_vlan_hal_negative1_get_vlanId_for_GroupName, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_get_vlanId_for_GroupName", test_l1_vlan_hal_negative2_get_vlanId_for_GroupName, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative3_get_vlanId_for_GroupName", test_l1_vlan_hal_negative3_get_vlanId_for_GroupName, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative4_get_vlanId_for_GroupName", test_l1_vlan_hal_negative4_get_vlanId_for_GroupName, VLAN_HAL_L1_STATE);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_print_all_vlanId_Configuration", test_l1_vlan_hal_positive1_print_all_vlanId_Configuration, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_get_shell_outputbuffer", test_l1_vlan_hal_positive1_get_shell_outputbuffer, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_get_shell_outputbuffer", test_l1_vlan_hal_negative1_get_shell_outputbuffer, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_get_shell_outputbuffer", test_l1_vlan_hal_negative2_get_shell_outputbuffer, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_positive1_get_shell_outputbuffer_res", test_l1_vlan_hal_positive1_get_shell_outputbuffer_res, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative1_get_shell_outputbuffer_res", test_l1_vlan_hal_negative1_get_shell_outputbuffer_res, NULL);
+    vlan_hal_test_add(pSuite, "l1_vlan_hal_negative2_get_shell_outputbuffer_res", test_l1_vlan_hal_negative2_get_shell_outputbuffer_res, NULL);
 
     return 0;
 }
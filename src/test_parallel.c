@@ -0,0 +1,642 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "test_parallel.h"
+#include "test_resources.h"
+#include "vlan_profile_snapshot.h"
+#ifdef VLAN_HAL_SKELETON
+#include "vlan_hal_sysfs.h"
+#endif
+
+/* Environment variables naming paths, made absolute before a worker changes directory */
+static const char *const gPathEnv[] =
+{
+    VLAN_PROFILE_SNAPSHOT_ENV,
+#ifdef VLAN_HAL_SKELETON
+    VLAN_HAL_SYSFS_ROOT_ENV,
+#endif
+};
+
+typedef enum
+{
+    VLAN_HAL_TEST_SERIAL = 0,   /*!< Pass everything to ut-core */
+    VLAN_HAL_TEST_PLAN,         /*!< Record the units only */
+    VLAN_HAL_TEST_WORKER        /*!< Pass on the units assigned to gWorker */
+} vlan_hal_test_mode_t;
+
+struct vlan_hal_test_suite
+{
+    const char *title;
+    UT_InitialiseFunction_t init;
+    UT_CleanupFunction_t cleanup;
+    UT_test_suite_t *suite;     /*!< Created on first use in a worker */
+    vlan_hal_test_suite_t *next;
+};
+
+typedef struct
+{
+    const char *name;           /*!< Chain or test name */
+    const char *chain;          /*!< NULL unless the unit is a chain */
+    unsigned int tests;
+    int worker;
+} vlan_hal_test_unit_t;
+
+static vlan_hal_test_mode_t gMode = VLAN_HAL_TEST_SERIAL;
+static int gWorker;
+static vlan_hal_test_unit_t *gUnits;
+static unsigned int gUnitCount;
+static unsigned int gUnitCapacity;
+static unsigned int gUnitsSeen;  /*!< Units reached by the current registration pass */
+static vlan_hal_test_suite_t *gSuites;
+
+int vlan_hal_test_jobs(void)
+{
+    const char *value = getenv(VLAN_HAL_TEST_JOBS_ENV);
+    char *end;
+    long jobs;
+
+    if ((value == NULL) || (*value == '\0'))
+    {
+        return 1;
+    }
+    jobs = strtol(value, &end, 10);
+    if ((*end != '\0') || (jobs < 1))
+    {
+        return 1;
+    }
+    return (jobs > VLAN_HAL_TEST_JOBS_MAX) ? VLAN_HAL_TEST_JOBS_MAX : (int)jobs;
+}
+
+/*
+ * Units are identified by the order registration reaches them, which is the
+ * same in the planning pass and in every worker.
+ */
+static vlan_hal_test_unit_t *vlan_hal_test_unit(const char *name, const char *chain)
+{
+    vlan_hal_test_unit_t *unit;
+    unsigned int i;
+
+    if (chain != NULL)
+    {
+        for (i = 0; i < gUnitsSeen; i++)
+        {
+            if ((gUnits[i].chain != NULL) && (strcmp(gUnits[i].chain, chain) == 0))
+            {
+                return &gUnits[i];
+            }
+        }
+    }
+
+    if (gMode == VLAN_HAL_TEST_PLAN)
+    {
+        if (gUnitCount == gUnitCapacity)
+        {
+            unsigned int capacity = (gUnitCapacity != 0) ? gUnitCapacity * 2 : 64;
+            vlan_hal_test_unit_t *units = realloc(gUnits, capacity * sizeof(*units));
+
+            if (units == NULL)
+            {
+                return NULL;
+            }
+            gUnits = units;
+            gUnitCapacity = capacity;
+        }
+        unit = &gUnits[gUnitCount++];
+        unit->name = (chain != NULL) ? chain : name;
+        unit->chain = chain;
+        unit->tests = 0;
+        unit->worker = 0;
+    }
+    else if (gUnitsSeen >= gUnitCount)
+    {
+        /* Registration no longer matches the plan */
+        return NULL;
+    }
+    return &gUnits[gUnitsSeen++];
+}
+
+vlan_hal_test_suite_t *vlan_hal_test_add_suite(const char *title, UT_InitialiseFunction_t init, UT_CleanupFunction_t cleanup)
+{
+    vlan_hal_test_suite_t *suite;
+
+    /* A worker registers again, reuse what the planning pass created */
+    for (suite = gSuites; suite != NULL; suite = suite->next)
+    {
+        if ((suite->title == title) && (suite->init == init) && (suite->cleanup == cleanup))
+        {
+            return suite;
+        }
+    }
+
+    suite = calloc(1, sizeof(*suite));
+    if (suite == NULL)
+    {
+        return NULL;
+    }
+    suite->title = title;
+    suite->init = init;
+    suite->cleanup = cleanup;
+    if (gMode == VLAN_HAL_TEST_SERIAL)
+    {
+        suite->suite = UT_add_suite(title, init, cleanup);
+        if (suite->suite == NULL)
+        {
+            free(suite);
+            return NULL;
+        }
+    }
+    suite->next = gSuites;
+    gSuites = suite;
+    return suite;
+}
+
+int vlan_hal_test_add(vlan_hal_test_suite_t *suite, const char *name, UT_TestFunction_t function, const char *chain)
+{
+    vlan_hal_test_unit_t *unit;
+
+    if ((suite == NULL) || (name == NULL) || (function == NULL))
+    {
+        return -1;
+    }
+    if (gMode != VLAN_HAL_TEST_SERIAL)
+    {
+        unit = vlan_hal_test_unit(name, chain);
+        if (unit == NULL)
+        {
+            return -1;
+        }
+        if (gMode == VLAN_HAL_TEST_PLAN)
+        {
+            unit->tests++;
+            return 0;
+        }
+        if (unit->worker != gWorker)
+        {
+            return 0;
+        }
+        if (suite->suite == NULL)
+        {
+            suite->suite = UT_add_suite(suite->title, suite->init, suite->cleanup);
+            if (suite->suite == NULL)
+            {
+                return -1;
+            }
+        }
+    }
+    function = vlan_hal_test_resources_wrap(suite->title, name, function);
+    return (UT_add_test(suite->suite, name, function) != NULL) ? 0 : -1;
+}
+
+static int vlan_hal_test_compare_units(const void *a, const void *b)
+{
+    const vlan_hal_test_unit_t *unitA = *(vlan_hal_test_unit_t *const *)a;
+    const vlan_hal_test_unit_t *unitB = *(vlan_hal_test_unit_t *const *)b;
+
+    if (unitA->tests != unitB->tests)
+    {
+        return (unitA->tests > unitB->tests) ? -1 : 1;
+    }
+    /* Keep registration order between equal units */
+    return (unitA < unitB) ? -1 : (unitA > unitB);
+}
+
+/* Largest unit first, each onto the worker with the fewest tests so far */
+static int vlan_hal_test_assign(int jobs, unsigned int *load)
+{
+    vlan_hal_test_unit_t **order = malloc(gUnitCount * sizeof(*order));
+    unsigned int i;
+    int worker;
+    int w;
+
+    if (order == NULL)
+    {
+        return -1;
+    }
+    for (i = 0; i < gUnitCount; i++)
+    {
+        order[i] = &gUnits[i];
+    }
+    qsort(order, gUnitCount, sizeof(*order), vlan_hal_test_compare_units);
+    memset(load, 0, jobs * sizeof(*load));
+    for (i = 0; i < gUnitCount; i++)
+    {
+        worker = 0;
+        for (w = 1; w < jobs; w++)
+        {
+            if (load[w] < load[worker])
+            {
+                worker = w;
+            }
+        }
+        order[i]->worker = worker;
+        load[worker] += order[i]->tests;
+    }
+    free(order);
+    return 0;
+}
+
+/*
+ * Makes the relative paths a worker is given absolute, so they still name
+ * the same files once it has moved into its own directory. Only arguments
+ * naming an existing file are touched, ut-core's options are left alone.
+ */
+static void vlan_hal_test_absolute_paths(int argc, char **argv)
+{
+    char path[PATH_MAX];
+    const char *value;
+    size_t e;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if ((argv[i][0] != '/') && (access(argv[i], F_OK) == 0) && (realpath(argv[i], path) != NULL))
+        {
+            argv[i] = strdup(path);
+        }
+    }
+    for (e = 0; e < sizeof(gPathEnv) / sizeof(gPathEnv[0]); e++)
+    {
+        value = getenv(gPathEnv[e]);
+        if ((value != NULL) && (value[0] != '\0') && (value[0] != '/') && (realpath(value, path) != NULL))
+        {
+            setenv(gPathEnv[e], path, 1);
+        }
+    }
+}
+
+static void vlan_hal_test_worker(int worker, FILE *output, FILE *resources, int argc, char **argv, int (*registerTests)(void))
+{
+    char directory[sizeof(VLAN_HAL_TEST_WORKER_DIR) + 16];
+
+    if ((dup2(fileno(output), STDOUT_FILENO) < 0) || (dup2(fileno(output), STDERR_FILENO) < 0))
+    {
+        _exit(1);
+    }
+    /* ut-core writes its results under fixed names, each worker keeps its own */
+    snprintf(directory, sizeof(directory), VLAN_HAL_TEST_WORKER_DIR "%d", worker);
+    vlan_hal_test_absolute_paths(argc, argv);
+    if (chdir(directory) != 0)
+    {
+        printf("worker %d: cannot enter %s: %s\n", worker, directory, strerror(errno));
+        exit(1);
+    }
+    gMode = VLAN_HAL_TEST_WORKER;
+    gWorker = worker;
+    gUnitsSeen = 0;
+    vlan_hal_test_resources_record(resources);
+
+    UT_init(argc, argv);
+    if (registerTests() != 0)
+    {
+        printf("worker %d: test registration failed\n", worker);
+        exit(1);
+    }
+    UT_run_tests();
+    exit(0);
+}
+
+/* Copy the whole of @from to @to and close @from */
+static void vlan_hal_test_append(FILE *to, FILE *from)
+{
+    char buffer[4096];
+    size_t length;
+
+    if (from == NULL)
+    {
+        return;
+    }
+    rewind(from);
+    while ((length = fread(buffer, 1, sizeof(buffer), from)) > 0)
+    {
+        if (to != NULL)
+        {
+            fwrite(buffer, 1, length, to);
+        }
+    }
+    fclose(from);
+}
+
+/* One row of the CUnit run summary ut-core prints, -1 where it shows n/a */
+typedef struct
+{
+    const char *type;
+    long count[5];              /*!< Total, Ran, Passed, Failed, Inactive */
+} vlan_hal_test_total_t;
+
+enum
+{
+    VLAN_HAL_TEST_SUITES = 0,
+    VLAN_HAL_TEST_TESTS,
+    VLAN_HAL_TEST_ASSERTS,
+    VLAN_HAL_TEST_TOTALS
+};
+
+#define VLAN_HAL_TEST_FAILED 3
+
+/* Parse one row after its type, "n/a" gives -1. Returns 0 if all five columns are there */
+static int vlan_hal_test_parse_row(char *save, long *count)
+{
+    char *token;
+    char *end;
+    int c;
+
+    for (c = 0; c < 5; c++)
+    {
+        token = strtok_r(NULL, " \t\n", &save);
+        if (token == NULL)
+        {
+            return -1;
+        }
+        if (strcmp(token, "n/a") == 0)
+        {
+            count[c] = -1;
+            continue;
+        }
+        count[c] = strtol(token, &end, 10);
+        if ((*end != '\0') || (count[c] < 0))
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Add the rows of the run summary in the output of one worker to @totals.
+ * Returns 1 if the worker printed a complete summary.
+ */
+static int vlan_hal_test_add_totals(FILE *from, vlan_hal_test_total_t *totals)
+{
+    vlan_hal_test_total_t found[VLAN_HAL_TEST_TOTALS];
+    char line[256];
+    char *token;
+    char *save;
+    int row = -1;
+    int c;
+
+    if (from == NULL)
+    {
+        return 0;
+    }
+    rewind(from);
+    /* Only the rows right after a "Run Summary:" header count, the last summary wins */
+    while (fgets(line, sizeof(line), from) != NULL)
+    {
+        if (strncmp(line, "Run Summary:", 12) == 0)
+        {
+            row = 0;
+            continue;
+        }
+        if ((row < 0) || (row == VLAN_HAL_TEST_TOTALS))
+        {
+            continue;
+        }
+        token = strtok_r(line, " \t\n", &save);
+        if ((token == NULL) || (strcmp(token, totals[row].type) != 0) ||
+            (vlan_hal_test_parse_row(save, found[row].count) != 0))
+        {
+            row = -1;
+            continue;
+        }
+        row++;
+    }
+    if (row != VLAN_HAL_TEST_TOTALS)
+    {
+        return 0;
+    }
+    for (row = 0; row < VLAN_HAL_TEST_TOTALS; row++)
+    {
+        for (c = 0; c < 5; c++)
+        {
+            totals[row].count[c] = ((found[row].count[c] < 0) || (totals[row].count[c] < 0))
+                                   ? -1 : totals[row].count[c] + found[row].count[c];
+        }
+    }
+    return 1;
+}
+
+static void vlan_hal_test_print_totals(const vlan_hal_test_total_t *totals)
+{
+    int row;
+    int c;
+
+    printf("Run Summary:    Type  Total    Ran Passed Failed Inactive\n");
+    for (row = 0; row < VLAN_HAL_TEST_TOTALS; row++)
+    {
+        printf("%20s", totals[row].type);
+        for (c = 0; c < 5; c++)
+        {
+            if (totals[row].count[c] < 0)
+            {
+                printf(" %*s", (c == 4) ? 8 : 6, "n/a");
+            }
+            else
+            {
+                printf(" %*ld", (c == 4) ? 8 : 6, totals[row].count[c]);
+            }
+        }
+        printf("\n");
+    }
+}
+
+static long vlan_hal_test_elapsed_ms(const struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000 + (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+int vlan_hal_test_run_parallel(int jobs, int argc, char **argv, int (*registerTests)(void))
+{
+    FILE *output[VLAN_HAL_TEST_JOBS_MAX] = { NULL };
+    FILE *resources[VLAN_HAL_TEST_JOBS_MAX] = { NULL };
+    FILE *report;
+    char directory[VLAN_HAL_TEST_JOBS_MAX][sizeof(VLAN_HAL_TEST_WORKER_DIR) + 16];
+    pid_t pid[VLAN_HAL_TEST_JOBS_MAX];
+    int status[VLAN_HAL_TEST_JOBS_MAX];
+    long elapsed[VLAN_HAL_TEST_JOBS_MAX];
+    unsigned int load[VLAN_HAL_TEST_JOBS_MAX];
+    int summary[VLAN_HAL_TEST_JOBS_MAX];
+    vlan_hal_test_total_t totals[VLAN_HAL_TEST_TOTALS] =
+    {
+        { "suites", { 0, 0, -1, 0, 0 } },
+        { "tests", { 0, 0, 0, 0, 0 } },
+        { "asserts", { 0, 0, 0, 0, -1 } }
+    };
+    int summaries = 0;
+    struct timespec start;
+    int running = 0;
+    int failed = 0;
+    int w;
+
+    gMode = VLAN_HAL_TEST_PLAN;
+    gUnitsSeen = 0;
+    if (registerTests() != 0)
+    {
+        printf("test registration failed\n");
+        return 1;
+    }
+    if (jobs > VLAN_HAL_TEST_JOBS_MAX)
+    {
+        jobs = VLAN_HAL_TEST_JOBS_MAX;
+    }
+    if ((unsigned int)jobs > gUnitCount)
+    {
+        jobs = (int)gUnitCount;
+    }
+    if ((jobs < 1) || (vlan_hal_test_assign(jobs, load) != 0))
+    {
+        printf("no tests to run\n");
+        return 1;
+    }
+
+    /* Workers record into their own file, appended to the report in worker order */
+    report = vlan_hal_test_resources_open();
+
+    /* Nothing buffered may be inherited, or every worker would print it again */
+    fflush(stdout);
+    fflush(stderr);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (w = 0; w < jobs; w++)
+    {
+        pid[w] = -1;
+        elapsed[w] = -1;
+        snprintf(directory[w], sizeof(directory[w]), VLAN_HAL_TEST_WORKER_DIR "%d", w);
+        if ((mkdir(directory[w], 0777) != 0) && (errno != EEXIST))
+        {
+            status[w] = errno;
+            continue;
+        }
+        output[w] = tmpfile();
+        if (report != NULL)
+        {
+            resources[w] = tmpfile();
+        }
+        if ((output[w] != NULL) && ((report == NULL) || (resources[w] != NULL)))
+        {
+            pid[w] = fork();
+        }
+        if (pid[w] == 0)
+        {
+            vlan_hal_test_worker(w, output[w], resources[w], argc, argv, registerTests);
+        }
+        if (pid[w] < 0)
+        {
+            status[w] = errno;
+            continue;
+        }
+        running++;
+    }
+
+    while (running > 0)
+    {
+        int workerStatus;
+        pid_t done = waitpid(-1, &workerStatus, 0);
+
+        if (done < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        for (w = 0; w < jobs; w++)
+        {
+            if (pid[w] == done)
+            {
+                status[w] = workerStatus;
+                elapsed[w] = vlan_hal_test_elapsed_ms(&start);
+                running--;
+            }
+        }
+    }
+
+    /* Worker output in worker order, each as ut-core printed it */
+    for (w = 0; w < jobs; w++)
+    {
+        summary[w] = vlan_hal_test_add_totals(output[w], totals);
+        summaries += summary[w];
+        vlan_hal_test_append(stdout, output[w]);
+        vlan_hal_test_append(report, resources[w]);
+    }
+    if (report != NULL)
+    {
+        fclose(report);
+    }
+    /* Only directories a worker left results in are kept */
+    for (w = 0; w < jobs; w++)
+    {
+        rmdir(directory[w]);
+    }
+
+    printf("\nparallel run: %u units on %d workers in %ld ms\n", gUnitCount, jobs, vlan_hal_test_elapsed_ms(&start));
+    for (w = 0; w < jobs; w++)
+    {
+        printf("  worker %d: %u tests, ", w, load[w]);
+        if (pid[w] < 0)
+        {
+            printf("not started: %s\n", strerror(status[w]));
+            failed = 1;
+        }
+        else if (elapsed[w] < 0)
+        {
+            printf("no exit status\n");
+            failed = 1;
+        }
+        else if (WIFSIGNALED(status[w]))
+        {
+            printf("killed by signal %d after %ld ms\n", WTERMSIG(status[w]), elapsed[w]);
+            failed = 1;
+        }
+        else
+        {
+            printf("exit status %d after %ld ms", WEXITSTATUS(status[w]), elapsed[w]);
+            failed |= (WEXITSTATUS(status[w]) != 0);
+            if (!summary[w])
+            {
+                printf(", no run summary");
+            }
+            if (access(directory[w], F_OK) == 0)
+            {
+                printf(", results in %s/", directory[w]);
+            }
+            printf("\n");
+        }
+    }
+    if (summaries > 0)
+    {
+        /* The summaries of all workers added up, a failed test or assert anywhere fails the run */
+        printf("\ncombined, %d of %d workers:\n", summaries, jobs);
+        vlan_hal_test_print_totals(totals);
+        failed |= (totals[VLAN_HAL_TEST_TESTS].count[VLAN_HAL_TEST_FAILED] != 0) ||
+                  (totals[VLAN_HAL_TEST_ASSERTS].count[VLAN_HAL_TEST_FAILED] != 0);
+    }
+    fflush(stdout);
+    return failed;
+}
@@ -0,0 +1,91 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_parallel.h
+ *
+ * Runs the registered tests across forked worker processes.
+ *
+ * Tests are registered through this module instead of straight into ut-core.
+ * Registration produces scheduling units:
+ *  - a test added with no chain is a unit on its own
+ *  - tests added with the same chain form one unit and keep their order, for
+ *    tests that rely on HAL state left behind by earlier ones. Each skeleton
+ *    module uses its name as the chain of all its tests.
+ *
+ * With VLAN_HAL_TEST_JOBS unset or 1 everything is passed to ut-core as it is
+ * registered and the suite runs serially as before. Otherwise the runner
+ * registers once to plan the units and spreads them over the workers. Each
+ * worker registers again in a fork, keeps only the units assigned to it and
+ * runs them with UT_run_tests(), so every worker gets the normal command line
+ * options and output. The output of each worker is printed in worker order
+ * once all of them have finished, followed by the CUnit run summaries the
+ * workers printed, added up into one.
+ *
+ * Each worker runs in its own directory, VLAN_HAL_TEST_WORKER_DIR followed by
+ * the worker number, so the results files ut-core writes under fixed names
+ * in automated mode are kept apart rather than overwritten. They are not
+ * merged, each one covers the tests of its worker only. Directories a worker
+ * left empty are removed.
+ */
+#ifndef __TEST_PARALLEL_H__
+#define __TEST_PARALLEL_H__
+
+#include <ut.h>
+
+/** Environment variable holding the number of workers */
+#define VLAN_HAL_TEST_JOBS_ENV "VLAN_HAL_TEST_JOBS"
+#define VLAN_HAL_TEST_JOBS_MAX 64
+/** Prefix of the directory each worker runs in */
+#define VLAN_HAL_TEST_WORKER_DIR "vlan_hal_test_worker"
+
+typedef struct vlan_hal_test_suite vlan_hal_test_suite_t;
+
+/**
+ * @brief Number of workers requested in VLAN_HAL_TEST_JOBS, 1 when unset or invalid.
+ */
+int vlan_hal_test_jobs(void);
+
+/**
+ * @brief Create a suite, see UT_add_suite().
+ *
+ * In a worker the ut-core suite is only created once one of its tests is
+ * assigned to that worker, so @p init and @p cleanup never run for nothing.
+ *
+ * @return The suite, or NULL on failure.
+ */
+vlan_hal_test_suite_t *vlan_hal_test_add_suite(const char *title, UT_InitialiseFunction_t init, UT_CleanupFunction_t cleanup);
+
+/**
+ * @brief Add a test to @p suite, see UT_add_test().
+ *
+ * @p chain names the unit the test belongs to, NULL makes it independent.
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int vlan_hal_test_add(vlan_hal_test_suite_t *suite, const char *name, UT_TestFunction_t function, const char *chain);
+
+/**
+ * @brief Plan the units of @p registerTests and run them on @p jobs workers.
+ *
+ * @return 0 if every worker exited normally with status 0 and the combined
+ *         run summary shows no failed test or assert, otherwise 1.
+ */
+int vlan_hal_test_run_parallel(int jobs, int argc, char **argv, int (*registerTests)(void));
+
+#endif /* __TEST_PARALLEL_H__ */
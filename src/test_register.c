@@ -18,12 +18,49 @@
  
 /* L1 Testing Functions */
 extern int test_vlan_hal_l1_register(void);
+#ifdef VLAN_HAL_SKELETON
+/* Skeleton implementation tests, only built when linking skeletons/src */
+extern int test_vlan_hal_netlink_register(void);
+extern int test_vlan_hal_vlan_bitmap_register(void);
+extern int test_vlan_hal_port_index_register(void);
+extern int test_vlan_hal_sysfs_register(void);
+extern int test_vlan_hal_config_store_register(void);
+extern int test_vlan_hal_config_map_register(void);
+extern int test_vlan_hal_concurrency_register(void);
+extern int test_vlan_hal_walk_register(void);
+extern int test_vlan_hal_reader_register(void);
+extern int test_vlan_hal_spawn_register(void);
+extern int test_vlan_hal_ip_batch_register(void);
+extern int test_vlan_hal_async_register(void);
+extern int test_vlan_hal_link_cache_register(void);
+extern int test_vlan_hal_validate_register(void);
+extern int test_vlan_hal_name_pool_register(void);
+extern int test_vlan_hal_group_table_register(void);
+#endif
  
 int register_hal_l1_tests( void )
 {
     int registerFailed=0;
 
     registerFailed |= test_vlan_hal_l1_register();
+#ifdef VLAN_HAL_SKELETON
+    registerFailed |= test_vlan_hal_netlink_register();
+    registerFailed |= test_vlan_hal_vlan_bitmap_register();
+    registerFailed |= test_vlan_hal_port_index_register();
+    registerFailed |= test_vlan_hal_sysfs_register();
+    registerFailed |= test_vlan_hal_config_store_register();
+    registerFailed |= test_vlan_hal_config_map_register();
+    registerFailed |= test_vlan_hal_concurrency_register();
+    registerFailed |= test_vlan_hal_walk_register();
+    registerFailed |= test_vlan_hal_reader_register();
+    registerFailed |= test_vlan_hal_spawn_register();
+    registerFailed |= test_vlan_hal_ip_batch_register();
+    registerFailed |= test_vlan_hal_async_register();
+    registerFailed |= test_vlan_hal_link_cache_register();
+    registerFailed |= test_vlan_hal_validate_register();
+    registerFailed |= test_vlan_hal_name_pool_register();
+    registerFailed |= test_vlan_hal_group_table_register();
+#endif
  
     return registerFailed;
 }
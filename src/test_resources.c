@@ -0,0 +1,248 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <dlfcn.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <ut_log.h>
+#include "test_resources.h"
+#include "vlan_hal_exec_audit.h"
+
+typedef struct
+{
+    const char *suite;
+    const char *name;
+    UT_TestFunction_t function;
+} vlan_hal_test_wrapped_t;
+
+typedef struct
+{
+    struct timespec wall;
+    struct rusage self;
+    struct rusage children;
+    int fds;
+} vlan_hal_test_usage_t;
+
+static vlan_hal_test_wrapped_t gWrapped[VLAN_HAL_TEST_RESOURCES_MAX];
+static unsigned int gWrappedCount;
+static FILE *gReport;
+static int gExitHandler;
+static int gRunning = -1;       /*!< Wrapped test being measured, -1 if none */
+static vlan_hal_test_usage_t gStart;
+static int gAuditLookedUp;
+static vlan_hal_exec_audit_begin_t gAuditBegin;   /*!< NULL unless the exec audit shim is preloaded */
+static vlan_hal_exec_audit_end_t gAuditEnd;
+static char gAudit[4096];
+
+FILE *vlan_hal_test_resources_open(void)
+{
+    const char *path = getenv(VLAN_HAL_TEST_RESOURCES_ENV);
+    FILE *report;
+
+    if (path == NULL)
+    {
+        path = VLAN_HAL_TEST_RESOURCES_DEFAULT;
+    }
+    if (*path == '\0')
+    {
+        return NULL;
+    }
+    report = fopen(path, "w");
+    if (report == NULL)
+    {
+        perror(path);
+    }
+    return report;
+}
+
+/* Open descriptors, not counting the one reading the directory */
+static int vlan_hal_test_count_fds(void)
+{
+    DIR *dir = opendir("/proc/self/fd");
+    struct dirent *entry;
+    int count = -1;
+
+    if (dir == NULL)
+    {
+        return -1;
+    }
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] != '.')
+        {
+            count++;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+static void vlan_hal_test_usage(vlan_hal_test_usage_t *usage)
+{
+    usage->fds = vlan_hal_test_count_fds();
+    getrusage(RUSAGE_SELF, &usage->self);
+    getrusage(RUSAGE_CHILDREN, &usage->children);
+    clock_gettime(CLOCK_MONOTONIC, &usage->wall);
+}
+
+static long long vlan_hal_test_us(const struct timeval *end, const struct timeval *start)
+{
+    return ((long long)(end->tv_sec - start->tv_sec) * 1000000) + (end->tv_usec - start->tv_usec);
+}
+
+static void vlan_hal_test_finish(int aborted)
+{
+    vlan_hal_test_usage_t end;
+    const vlan_hal_test_wrapped_t *test;
+
+    if ((gRunning < 0) || (gReport == NULL))
+    {
+        gRunning = -1;
+        return;
+    }
+    vlan_hal_test_usage(&end);
+    test = &gWrapped[gRunning];
+    gRunning = -1;
+    if (aborted && (gAuditEnd != NULL))
+    {
+        gAuditEnd(gAudit, sizeof(gAudit));
+    }
+
+    fprintf(gReport, "{\"suite\": \"%s\", \"test\": \"%s\", \"wall_us\": %lld, \"user_us\": %lld, \"sys_us\": %lld, "
+            "\"child_user_us\": %lld, \"child_sys_us\": %lld, \"maxrss_delta_kb\": %ld, \"fd_delta\": ",
+            test->suite, test->name,
+            ((long long)(end.wall.tv_sec - gStart.wall.tv_sec) * 1000000) + ((end.wall.tv_nsec - gStart.wall.tv_nsec) / 1000),
+            vlan_hal_test_us(&end.self.ru_utime, &gStart.self.ru_utime),
+            vlan_hal_test_us(&end.self.ru_stime, &gStart.self.ru_stime),
+            vlan_hal_test_us(&end.children.ru_utime, &gStart.children.ru_utime),
+            vlan_hal_test_us(&end.children.ru_stime, &gStart.children.ru_stime),
+            end.self.ru_maxrss - gStart.self.ru_maxrss);
+    if ((end.fds < 0) || (gStart.fds < 0))
+    {
+        fprintf(gReport, "null");
+    }
+    else
+    {
+        fprintf(gReport, "%d", end.fds - gStart.fds);
+    }
+    fprintf(gReport, ", \"aborted\": %s", aborted ? "true" : "false");
+    if (gAuditEnd != NULL)
+    {
+        fprintf(gReport, ", \"exec\": {%s}", gAudit);
+    }
+    fprintf(gReport, "}\n");
+    fflush(gReport);
+}
+
+static void vlan_hal_test_exit(void)
+{
+    /* The last test hit a fatal assert, or called exit() */
+    vlan_hal_test_finish(1);
+}
+
+void vlan_hal_test_resources_record(FILE *report)
+{
+    gReport = report;
+    if ((report != NULL) && !gExitHandler)
+    {
+        atexit(vlan_hal_test_exit);
+        gExitHandler = 1;
+    }
+}
+
+static void vlan_hal_test_measure(unsigned int id)
+{
+    unsigned int denied = 0;
+
+    if (gReport != NULL)
+    {
+        /* A fatal assert leaves a test by longjmp, so it is only seen ending here */
+        vlan_hal_test_finish(1);
+
+        gRunning = (int)id;
+        vlan_hal_test_usage(&gStart);
+    }
+    if (gAuditBegin != NULL)
+    {
+        gAuditBegin();
+    }
+    gWrapped[id].function();
+    if (gAuditEnd != NULL)
+    {
+        denied = gAuditEnd(gAudit, sizeof(gAudit));
+    }
+    vlan_hal_test_finish(0);
+
+    if (denied > 0)
+    {
+        UT_LOG_ERROR("%s started %u processes in APIs listed in %s: {%s}",
+                     gWrapped[id].name, denied, VLAN_HAL_EXEC_AUDIT_DENY_ENV, gAudit);
+        UT_FAIL("HAL API started a process it must not start");
+    }
+}
+
+/*
+ * ut-core calls tests without an argument, so each wrapped test gets its own
+ * trampoline that passes its index to vlan_hal_test_measure().
+ */
+#define VLAN_HAL_TEST_EACH_16(M, prefix) \
+    M(prefix##0) M(prefix##1) M(prefix##2) M(prefix##3) M(prefix##4) M(prefix##5) M(prefix##6) M(prefix##7) \
+    M(prefix##8) M(prefix##9) M(prefix##a) M(prefix##b) M(prefix##c) M(prefix##d) M(prefix##e) M(prefix##f)
+#define VLAN_HAL_TEST_EACH_256(M, prefix) \
+    VLAN_HAL_TEST_EACH_16(M, prefix##0) VLAN_HAL_TEST_EACH_16(M, prefix##1) VLAN_HAL_TEST_EACH_16(M, prefix##2) \
+    VLAN_HAL_TEST_EACH_16(M, prefix##3) VLAN_HAL_TEST_EACH_16(M, prefix##4) VLAN_HAL_TEST_EACH_16(M, prefix##5) \
+    VLAN_HAL_TEST_EACH_16(M, prefix##6) VLAN_HAL_TEST_EACH_16(M, prefix##7) VLAN_HAL_TEST_EACH_16(M, prefix##8) \
+    VLAN_HAL_TEST_EACH_16(M, prefix##9) VLAN_HAL_TEST_EACH_16(M, prefix##a) VLAN_HAL_TEST_EACH_16(M, prefix##b) \
+    VLAN_HAL_TEST_EACH_16(M, prefix##c) VLAN_HAL_TEST_EACH_16(M, prefix##d) VLAN_HAL_TEST_EACH_16(M, prefix##e) \
+    VLAN_HAL_TEST_EACH_16(M, prefix##f)
+#define VLAN_HAL_TEST_EACH(M) VLAN_HAL_TEST_EACH_256(M, 0x0) VLAN_HAL_TEST_EACH_256(M, 0x1)
+
+#define VLAN_HAL_TEST_TRAMPOLINE(id) static void vlan_hal_test_trampoline_##id(void) { vlan_hal_test_measure(id); }
+#define VLAN_HAL_TEST_TRAMPOLINE_ENTRY(id) vlan_hal_test_trampoline_##id,
+
+VLAN_HAL_TEST_EACH(VLAN_HAL_TEST_TRAMPOLINE)
+
+static const UT_TestFunction_t gTrampolines[VLAN_HAL_TEST_RESOURCES_MAX] =
+{
+    VLAN_HAL_TEST_EACH(VLAN_HAL_TEST_TRAMPOLINE_ENTRY)
+};
+
+UT_TestFunction_t vlan_hal_test_resources_wrap(const char *suite, const char *name, UT_TestFunction_t function)
+{
+    vlan_hal_test_wrapped_t *test;
+
+    if ((function == NULL) || (gWrappedCount >= VLAN_HAL_TEST_RESOURCES_MAX))
+    {
+        return function;
+    }
+    if (!gAuditLookedUp)
+    {
+        gAuditBegin = (vlan_hal_exec_audit_begin_t)dlsym(RTLD_DEFAULT, VLAN_HAL_EXEC_AUDIT_BEGIN);
+        gAuditEnd = (vlan_hal_exec_audit_end_t)dlsym(RTLD_DEFAULT, VLAN_HAL_EXEC_AUDIT_END);
+        gAuditLookedUp = 1;
+    }
+    test = &gWrapped[gWrappedCount];
+    test->suite = (suite != NULL) ? suite : "";
+    test->name = (name != NULL) ? name : "";
+    test->function = function;
+    return gTrampolines[gWrappedCount++];
+}
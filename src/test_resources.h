@@ -0,0 +1,80 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file test_resources.h
+ *
+ * Per-test resource accounting. Every test registered through test_parallel.h
+ * runs inside a wrapper that measures it and appends one JSON object per line
+ * to the report:
+ *  - wall_us: wall-clock time
+ *  - user_us, sys_us: CPU time of the test process, all threads
+ *  - child_user_us, child_sys_us: CPU time of the children reaped during the
+ *    test, which is where the cost of shelling out shows up
+ *  - maxrss_delta_kb: growth of the peak resident set size
+ *  - fd_delta: change in the number of open file descriptors, null if
+ *    /proc/self/fd cannot be read
+ *  - aborted: the test ended in a fatal assert, so its figures run up to the
+ *    start of the next test or process exit
+ *  - exec: only with the shim of vlan_hal_exec_audit.h preloaded, the
+ *    processes started during the test by HAL API
+ *
+ * The report is VLAN_HAL_TEST_RESOURCES_DEFAULT in the current directory,
+ * next to the ut-core results. VLAN_HAL_TEST_RESOURCES names another file,
+ * or disables the report when set to an empty string.
+ *
+ * With the shim preloaded the wrapper also fails a test that started a
+ * process inside an API listed in VLAN_HAL_EXEC_AUDIT_DENY, whether or not
+ * the report is enabled.
+ */
+#ifndef __TEST_RESOURCES_H__
+#define __TEST_RESOURCES_H__
+
+#include <stdio.h>
+#include <ut.h>
+
+#define VLAN_HAL_TEST_RESOURCES_ENV "VLAN_HAL_TEST_RESOURCES"
+#define VLAN_HAL_TEST_RESOURCES_DEFAULT "vlan_hal_test_resources.jsonl"
+
+/** Tests a process can wrap, any beyond run unmeasured */
+#define VLAN_HAL_TEST_RESOURCES_MAX 512
+
+/**
+ * @brief Open the report for writing.
+ *
+ * @return The report, or NULL if it is disabled or cannot be created (reported on stderr).
+ */
+FILE *vlan_hal_test_resources_open(void);
+
+/**
+ * @brief Append a line to @p report for each wrapped test that runs from now on.
+ *
+ * Each line is flushed as it is written, so a crash loses only the test
+ * that crashed. NULL stops recording.
+ */
+void vlan_hal_test_resources_record(FILE *report);
+
+/**
+ * @brief Return a function that runs @p function and measures it for the report.
+ *
+ * @return The wrapper, or @p function itself once VLAN_HAL_TEST_RESOURCES_MAX
+ *         tests have been wrapped.
+ */
+UT_TestFunction_t vlan_hal_test_resources_wrap(const char *suite, const char *name, UT_TestFunction_t function);
+
+#endif /* __TEST_RESOURCES_H__ */
@@ -0,0 +1,320 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_profile_compile.c
+ *
+ * Compiles the string lists of a test profile YAML into the binary snapshot
+ * described in src/profile/vlan_profile_snapshot.h:
+ *
+ *     vlan_profile_compile profiles/include/vlan_profile.yaml bin/vlan_profile.bin
+ *
+ * Understands the subset of YAML the profiles use: nested block mappings and
+ * block sequences of scalars, plain or quoted, with # comments. Each sequence
+ * is stored under its slash-separated path, e.g. "vlan/config/br_Name".
+ * Scalar mapping values are not lists and are skipped.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "vlan_profile_snapshot.h"
+
+#define COMPILE_MAX_DEPTH 16
+#define COMPILE_MAX_LINE 1024
+
+typedef struct
+{
+    char *key;
+    char **values;
+    uint32_t count;
+    uint32_t capacity;
+} compile_list_t;
+
+typedef struct
+{
+    int indent;
+    char name[COMPILE_MAX_LINE];
+} compile_level_t;
+
+static compile_list_t *gLists;
+static uint32_t gListCount;
+
+static void *compile_alloc(void *ptr, size_t size)
+{
+    ptr = realloc(ptr, size);
+    if (ptr == NULL)
+    {
+        fprintf(stderr, "vlan_profile_compile: out of memory\n");
+        exit(1);
+    }
+    return ptr;
+}
+
+static char *compile_strdup(const char *text)
+{
+    size_t length = strlen(text) + 1;
+
+    return memcpy(compile_alloc(NULL, length), text, length);
+}
+
+static compile_list_t *compile_list(const char *key)
+{
+    uint32_t l;
+
+    for (l = 0; l < gListCount; l++)
+    {
+        if (strcmp(gLists[l].key, key) == 0)
+        {
+            return &gLists[l];
+        }
+    }
+    gLists = compile_alloc(gLists, (gListCount + 1) * sizeof(*gLists));
+    memset(&gLists[gListCount], 0, sizeof(*gLists));
+    gLists[gListCount].key = compile_strdup(key);
+    return &gLists[gListCount++];
+}
+
+/* Strips a trailing comment and whitespace, and surrounding quotes from a scalar */
+static char *compile_scalar(char *text)
+{
+    char quote = 0;
+    char *end;
+    char *p;
+
+    while ((*text == ' ') || (*text == '\t'))
+    {
+        text++;
+    }
+    for (p = text; *p != '\0'; p++)
+    {
+        if ((quote == 0) && ((*p == '"') || (*p == '\'')))
+        {
+            quote = *p;
+        }
+        else if (*p == quote)
+        {
+            quote = 0;
+        }
+        else if ((quote == 0) && (*p == '#') && ((p == text) || (p[-1] == ' ') || (p[-1] == '\t')))
+        {
+            *p = '\0';
+            break;
+        }
+    }
+    end = text + strlen(text);
+    while ((end > text) && ((end[-1] == ' ') || (end[-1] == '\t') || (end[-1] == '\r') || (end[-1] == '\n')))
+    {
+        *--end = '\0';
+    }
+    if (((end - text) >= 2) && ((*text == '"') || (*text == '\'')) && (end[-1] == *text))
+    {
+        end[-1] = '\0';
+        text++;
+    }
+    return text;
+}
+
+static int compile_yaml(FILE *in, const char *path)
+{
+    compile_level_t levels[COMPILE_MAX_DEPTH];
+    char line[COMPILE_MAX_LINE];
+    char key[COMPILE_MAX_LINE * 2];
+    compile_list_t *list;
+    char *text;
+    char *colon;
+    size_t length;
+    int depth = 0;
+    int indent;
+    int lineNo = 0;
+    int d;
+
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        lineNo++;
+        for (indent = 0; line[indent] == ' '; indent++)
+        {
+        }
+        text = compile_scalar(&line[indent]);
+        if ((*text == '\0') || (strcmp(text, "---") == 0))
+        {
+            continue;
+        }
+        if ((text[0] == '-') && ((text[1] == ' ') || (text[1] == '\0')))
+        {
+            /* A sequence item belongs to the innermost key less indented than the dash */
+            while ((depth > 0) && (levels[depth - 1].indent > indent))
+            {
+                depth--;
+            }
+            if (depth == 0)
+            {
+                fprintf(stderr, "%s:%d: sequence item outside a mapping\n", path, lineNo);
+                return -1;
+            }
+            length = 0;
+            for (d = 0; (d < depth) && (length < sizeof(key)); d++)
+            {
+                length += (size_t)snprintf(&key[length], sizeof(key) - length, "%s%s", (d == 0) ? "" : "/", levels[d].name);
+            }
+            if (length >= sizeof(key))
+            {
+                fprintf(stderr, "%s:%d: key path too long\n", path, lineNo);
+                return -1;
+            }
+            list = compile_list(key);
+            if (list->count == list->capacity)
+            {
+                list->capacity = (list->capacity == 0) ? 16 : list->capacity * 2;
+                list->values = compile_alloc(list->values, list->capacity * sizeof(char *));
+            }
+            list->values[list->count++] = compile_strdup(compile_scalar(&text[1]));
+            continue;
+        }
+        colon = strchr(text, ':');
+        if (colon == NULL)
+        {
+            fprintf(stderr, "%s:%d: expected \"key:\" or \"- value\"\n", path, lineNo);
+            return -1;
+        }
+        *colon = '\0';
+        while ((depth > 0) && (levels[depth - 1].indent >= indent))
+        {
+            depth--;
+        }
+        if (*compile_scalar(colon + 1) != '\0')
+        {
+            /* key: value, not a list */
+            continue;
+        }
+        if (depth == COMPILE_MAX_DEPTH)
+        {
+            fprintf(stderr, "%s:%d: nested deeper than %d levels\n", path, lineNo, COMPILE_MAX_DEPTH);
+            return -1;
+        }
+        levels[depth].indent = indent;
+        snprintf(levels[depth].name, sizeof(levels[depth].name), "%s", compile_scalar(text));
+        depth++;
+    }
+    return 0;
+}
+
+static int compile_write(const char *path)
+{
+    vlan_profile_snapshot_header_t header;
+    vlan_profile_snapshot_list_t *table;
+    uint32_t *entries;
+    size_t entryCount = 0;
+    size_t strings = 0;
+    size_t size;
+    size_t entryOffset;
+    size_t stringOffset;
+    size_t length;
+    uint8_t *image;
+    uint32_t l;
+    uint32_t i;
+    FILE *out;
+
+    for (l = 0; l < gListCount; l++)
+    {
+        strings += strlen(gLists[l].key) + 1;
+        entryCount += gLists[l].count;
+        for (i = 0; i < gLists[l].count; i++)
+        {
+            strings += strlen(gLists[l].values[i]) + 1;
+        }
+    }
+    entryOffset = sizeof(header) + (gListCount * sizeof(*table));
+    stringOffset = entryOffset + (entryCount * sizeof(uint32_t));
+    /* A trailing NUL even with no strings, the loader relies on it */
+    size = stringOffset + strings + 1;
+    if (size > UINT32_MAX)
+    {
+        fprintf(stderr, "vlan_profile_compile: profile too large\n");
+        return -1;
+    }
+
+    image = compile_alloc(NULL, size);
+    memset(image, 0, size);
+    memcpy(header.magic, VLAN_PROFILE_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = VLAN_PROFILE_SNAPSHOT_VERSION;
+    header.size = (uint32_t)size;
+    header.listCount = gListCount;
+    header.reserved = 0;
+    memcpy(image, &header, sizeof(header));
+
+    table = (vlan_profile_snapshot_list_t *)(image + sizeof(header));
+    for (l = 0; l < gListCount; l++)
+    {
+        length = strlen(gLists[l].key) + 1;
+        table[l].key = (uint32_t)stringOffset;
+        table[l].count = gLists[l].count;
+        table[l].entries = (uint32_t)entryOffset;
+        memcpy(image + stringOffset, gLists[l].key, length);
+        stringOffset += length;
+        entries = (uint32_t *)(image + entryOffset);
+        for (i = 0; i < gLists[l].count; i++)
+        {
+            length = strlen(gLists[l].values[i]) + 1;
+            entries[i] = (uint32_t)stringOffset;
+            memcpy(image + stringOffset, gLists[l].values[i], length);
+            stringOffset += length;
+        }
+        entryOffset += gLists[l].count * sizeof(uint32_t);
+    }
+
+    out = fopen(path, "wb");
+    if ((out == NULL) || (fwrite(image, 1, size, out) != size) || (fclose(out) != 0))
+    {
+        perror(path);
+        free(image);
+        return -1;
+    }
+    free(image);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    FILE *in;
+    int ret;
+    uint32_t l;
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <profile.yaml> <snapshot.bin>\n", argv[0]);
+        return 2;
+    }
+    in = fopen(argv[1], "r");
+    if (in == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    ret = compile_yaml(in, argv[1]);
+    fclose(in);
+    if ((ret != 0) || (compile_write(argv[2]) != 0))
+    {
+        return 1;
+    }
+    for (l = 0; l < gListCount; l++)
+    {
+        printf("%-40s %u\n", gLists[l].key, gLists[l].count);
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:*
+ * Copyright 2023 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file vlan_profile_generate.c
+ *
+ * Writes a scale profile in the layout of profiles/include/vlan_profile.yaml
+ * to stdout:
+ *
+ *     vlan_profile_generate [-b bridges] [-r radios] [-s ssids] [-v vlans]
+ *
+ * - bridges: brlan0 .. brlan<N-1>, at most 4094 (each takes its own VLAN)
+ * - interfaces: wl<R>.<K> for every radio R and SSID K, radio-major
+ * - VLAN IDs: spread evenly over 1..4094, first and last always included
+ *
+ * invalid_brName keeps the malformed names of the reference profile. Feed
+ * the result to vlan_profile_compile for the suite or the benchmarks.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define GENERATE_MAX_VLAN 4094u
+
+static const char *gInvalidNames[] = { "brlanXYZ", "brlan@10", "1234", "bRLaN0" };
+
+static int parse_count(const char *text, unsigned int max, unsigned int *value)
+{
+    char *end;
+    unsigned long parsed = strtoul(text, &end, 10);
+
+    if ((*text == '\0') || (*end != '\0') || (parsed == 0) || (parsed > max))
+    {
+        return -1;
+    }
+    *value = (unsigned int)parsed;
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int bridges = 64;
+    unsigned int radios = 3;
+    unsigned int ssids = 8;
+    unsigned int vlans = 0;
+    unsigned int i;
+    unsigned int k;
+    int option;
+    int bad = 0;
+
+    while ((option = getopt(argc, argv, "b:r:s:v:")) != -1)
+    {
+        switch (option)
+        {
+        case 'b':
+            bad |= parse_count(optarg, GENERATE_MAX_VLAN, &bridges);
+            break;
+        case 'r':
+            bad |= parse_count(optarg, 100, &radios);
+            break;
+        case 's':
+            bad |= parse_count(optarg, 1000, &ssids);
+            break;
+        case 'v':
+            bad |= parse_count(optarg, GENERATE_MAX_VLAN, &vlans);
+            break;
+        default:
+            bad = 1;
+            break;
+        }
+    }
+    if (vlans == 0)
+    {
+        vlans = bridges;
+    }
+    if (bad || (optind != argc) || (vlans < bridges))
+    {
+        fprintf(stderr, "Usage: %s [-b bridges] [-r radios] [-s ssids] [-v vlans]\n", argv[0]);
+        fprintf(stderr, "  1 <= bridges <= vlans <= %u, 1 <= radios <= 100, 1 <= ssids <= 1000\n", GENERATE_MAX_VLAN);
+        return 2;
+    }
+
+    printf("# Scale profile: %u bridges, %u radios x %u SSIDs, %u VLAN IDs\n", bridges, radios, ssids, vlans);
+    printf("# Generated by tools/vlan_profile_generate, do not edit.\n\n");
+    printf("vlan:\n  config:\n");
+    printf("    if_Name:\n");
+    for (i = 0; i < radios; i++)
+    {
+        for (k = 1; k <= ssids; k++)
+        {
+            printf("      - \"wl%u.%u\"\n", i, k);
+        }
+    }
+    printf("    br_Name:\n");
+    for (i = 0; i < bridges; i++)
+    {
+        printf("      - \"brlan%u\"\n", i);
+    }
+    printf("    invalid_brName:\n");
+    for (i = 0; i < sizeof(gInvalidNames) / sizeof(gInvalidNames[0]); i++)
+    {
+        printf("      - \"%s\"\n", gInvalidNames[i]);
+    }
+    /* Strictly increasing since the step is at least 1 for vlans <= 4094 */
+    printf("    vlanID:\n");
+    for (i = 0; i < vlans; i++)
+    {
+        printf("      - \"%u\"\n", (vlans == 1) ? 1u : 1u + (unsigned int)(((unsigned long)i * (GENERATE_MAX_VLAN - 1)) / (vlans - 1)));
+    }
+    return (fflush(stdout) == 0) ? 0 : 1;
+}